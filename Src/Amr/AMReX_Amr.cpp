@@ -102,6 +102,7 @@ namespace
     int  checkpoint_nfiles;
     int  regrid_on_restart;
     int  use_efficient_regrid;
+    int  async_regrid;
     int  plotfile_on_restart;
     int  insitu_on_restart;
     int  checkpoint_on_restart;
@@ -137,6 +138,7 @@ Amr::Initialize ()
     checkpoint_nfiles        = 64;
     regrid_on_restart        = 0;
     use_efficient_regrid     = 0;
+    async_regrid             = 0;
     plotfile_on_restart      = 0;
     insitu_on_restart        = 0;
     checkpoint_on_restart    = 0;
@@ -276,6 +278,23 @@ Amr::InitAmr ()
     //
     pp.query("regrid_on_restart",regrid_on_restart);
     pp.query("use_efficient_regrid",use_efficient_regrid);
+    pp.query("async_regrid",async_regrid);
+#ifdef BL_PROFILING
+    if (async_regrid) {
+        amrex::Print() << "Amr: amr.async_regrid is not supported with PROFILE = TRUE\n";
+        async_regrid = 0;
+    }
+#endif
+#ifdef BL_MEM_PROFILING
+    //
+    // The BoxArrays built by the helper thread would update the unguarded
+    // memory counters of BARef at the same time as the time steps.
+    //
+    if (async_regrid) {
+        amrex::Print() << "Amr: amr.async_regrid is not supported with MEM_PROFILE = TRUE\n";
+        async_regrid = 0;
+    }
+#endif
     pp.query("plotfile_on_restart",plotfile_on_restart);
     pp.query("insitu_on_restart",insitu_on_restart);
     pp.query("checkpoint_on_restart",checkpoint_on_restart);
@@ -1899,7 +1918,7 @@ Amr::RegridOnly (Real time)
     int lev_top = std::min(finest_level, max_level-1);
 
     for (int i = 0; i <= lev_top; i++)
-       regrid(i,time);
+       regrid(i,time,false,false);
 
     if (plotfile_on_restart)
 	writePlotFile();
@@ -2060,7 +2079,7 @@ Amr::timeStep (int  level,
 
 	int old_finest = finest_level;
 
-	regrid(level, time);
+	regrid(level, time, false, false);
 
 	if (old_finest < finest_level)
 	{
@@ -2552,6 +2571,15 @@ void
 Amr::regrid (int  lbase,
              Real time,
              bool initial)
+{
+    regrid(lbase, time, initial, true);
+}
+
+void
+Amr::regrid (int  lbase,
+             Real time,
+             bool initial,
+             bool allow_async)
 {
     BL_PROFILE("Amr::regrid()");
 
@@ -2567,13 +2595,52 @@ Amr::regrid (int  lbase,
     Vector<BoxArray> new_grid_places(max_level+1);
     Vector<DistributionMapping> new_dmap(max_level+1);
 
-    grid_places(lbase,time,new_finest, new_grid_places);
+    //
+    // With async_regrid, the grids made from the tags of the last regrid
+    // at lbase are installed now, and the tags of this step are clustered
+    // while the next steps run.
+    //
+    const bool async = async_regrid && allow_async && !initial
+        && regrid_grids_file.empty() && initial_grids_file.empty();
+
+    if (async)
+    {
+        const Real strttime = amrex::second();
+        const bool ready = FinishNewGrids(lbase, new_finest, new_grid_places);
+        if (verbose > 0) {
+            Real stoptime = amrex::second() - strttime;
+            ParallelDescriptor::ReduceRealMax(stoptime,ParallelDescriptor::IOProcessorNumber());
+            amrex::Print() << "Waited " << stoptime << " for the grids, new finest: "
+                           << (ready ? new_finest : finest_level) << '\n';
+        }
+        if (!ready)
+        {
+            //
+            // Nothing to install yet, e.g., at the first regrid.
+            //
+            StartNewGrids(lbase, time);
+            return;
+        }
+        if (lbase == 0) {
+            new_grid_places[0] = MakeBaseGrids();
+        }
+    }
+    else
+    {
+        grid_places(lbase,time,new_finest, new_grid_places);
+    }
 
     bool regrid_level_zero = (!initial) && (lbase == 0)
         && ( loadbalance_with_workestimates || (new_grid_places[0] != amr_level[0]->boxArray()));
 
     const int start = regrid_level_zero ? 0 : lbase+1;
 
+    //
+    // The cells that FillPatch filled from the old levels, and of those,
+    // the cells moved and copied from them, for amr.incremental_regrid.
+    //
+    Vector<long> reused(3*(max_level+1), 0);
+
     bool grids_unchanged = finest_level == new_finest;
     for (int lev = start, End = std::min(finest_level,new_finest); lev <= End; lev++) {
 	if (new_grid_places[lev] == amr_level[lev]->boxArray()) {
@@ -2593,6 +2660,7 @@ Amr::regrid (int  lbase,
 	    amrex::Print() << "Regridding at level lbase = " << lbase 
 			   << " but grids unchanged\n";
 	}
+        if (async) StartNewGrids(lbase, time);
 	return;
     }
 
@@ -2631,9 +2699,23 @@ Amr::regrid (int  lbase,
             new_dmap[lev] = makeLoadBalanceDistributionMap(lev, time, new_grid_places[lev]);
         }
         else if (new_dmap[lev].empty()) {
-	    new_dmap[lev].define(new_grid_places[lev]);
+            if (incremental_regrid && !initial && amr_level[lev]) {
+                //
+                // The boxes that stay keep their owners, and so their data.
+                //
+                new_dmap[lev] = DistributionMapping::makeIncremental(new_grid_places[lev],
+                                                                     amr_level[lev]->boxArray(),
+                                                                     amr_level[lev]->DistributionMap());
+            } else {
+                new_dmap[lev].define(new_grid_places[lev]);
+            }
 	}
 
+        if (incremental_regrid && !initial && amr_level[lev])
+        {
+            amr_level[lev]->m_regrid_donor = true;
+        }
+
         AmrLevel* a = (*levelbld)(*this,lev,Geom(lev),new_grid_places[lev],
 				  new_dmap[lev],cumtime);
 
@@ -2657,6 +2739,9 @@ Amr::regrid (int  lbase,
             //       which therefore needs remain in the hierarchy during the call.
             //
             a->init(*amr_level[lev]);
+            reused[3*lev  ] = amr_level[lev]->m_cells_filled;
+            reused[3*lev+1] = amr_level[lev]->m_cells_moved;
+            reused[3*lev+2] = amr_level[lev]->m_cells_copied;
             amr_level[lev].reset(a);
 	    this->SetBoxArray(lev, amr_level[lev]->boxArray());
 	    this->SetDistributionMap(lev, amr_level[lev]->DistributionMap());
@@ -2680,6 +2765,8 @@ Amr::regrid (int  lbase,
       amr_level[lev]->post_regrid(lbase,new_finest);
     }
 
+    if (async) StartNewGrids(lbase, time);
+
     //
     // Report creation of new grids.
     //
@@ -2704,6 +2791,12 @@ Amr::regrid (int  lbase,
         printGridInfo(gridlog,start,finest_level);
     }
 
+    if (verbose > 0 && incremental_regrid && !initial)
+    {
+        ParallelDescriptor::ReduceLongSum(reused.data(), reused.size(),
+                                          ParallelDescriptor::IOProcessorNumber());
+    }
+
     if (verbose > 0 && ParallelDescriptor::IOProcessor())
     {
         if (lbase == 0) {
@@ -2724,6 +2817,19 @@ Amr::regrid (int  lbase,
         {
             printGridSummary(amrex::OutStream(),start,finest_level);
         }
+
+        if (incremental_regrid && !initial)
+        {
+            for (int lev = start; lev <= finest_level; ++lev) {
+                const long nfilled = reused[3*lev];
+                if (nfilled == 0) continue;
+                amrex::Print() << "  Level " << lev << ": of " << nfilled
+                               << " cells filled from the old level, "
+                               << std::fixed << std::setprecision(1)
+                               << 100.0*reused[3*lev+1]/nfilled << "% were moved and "
+                               << 100.0*reused[3*lev+2]/nfilled << "% copied\n";
+            }
+        }
     }
 }
 
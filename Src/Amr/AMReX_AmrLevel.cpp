@@ -4,6 +4,7 @@
 #include <unistd.h>
 #include <memory>
 #include <limits>
+#include <algorithm>
 
 #include <AMReX_AmrLevel.H>
 #include <AMReX_Derive.H>
@@ -80,6 +81,8 @@ AmrLevel::AmrLevel ()
    parent = 0;
    level = -1;
    levelDirectoryCreated = false;
+   m_regrid_donor = false;
+   m_cells_filled = m_cells_moved = m_cells_copied = 0;
 }
 
 AmrLevel::AmrLevel (Amr&            papa,
@@ -97,6 +100,8 @@ AmrLevel::AmrLevel (Amr&            papa,
     level  = lev;
     parent = &papa;
     levelDirectoryCreated = false;
+    m_regrid_donor = false;
+    m_cells_filled = m_cells_moved = m_cells_copied = 0;
 
     fine_ratio = IntVect::TheUnitVector(); fine_ratio.scale(-1);
     crse_ratio = IntVect::TheUnitVector(); crse_ratio.scale(-1);
@@ -2090,11 +2095,127 @@ AmrLevel::FillPatch(AmrLevel& amrlevel,
 {
     BL_ASSERT(dcomp+ncomp-1 <= leveldata.nComp());
     BL_ASSERT(boxGrow <= leveldata.nGrow());
+
+    if (amrlevel.m_regrid_donor)
+    {
+        if (std::find(amrlevel.m_donated.begin(), amrlevel.m_donated.end(), index)
+            != amrlevel.m_donated.end())
+        {
+            amrex::Abort("AmrLevel::FillPatch: the data of this state were moved to the new level");
+        }
+        for (MFIter mfi(leveldata); mfi.isValid(); ++mfi) {
+            amrlevel.m_cells_filled += mfi.validbox().numPts();
+        }
+        if (FillPatchIncremental(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp, dcomp)) {
+            return;
+        }
+    }
+
     FillPatchIterator fpi(amrlevel, leveldata, boxGrow, time, index, scomp, ncomp);
     const MultiFab& mf_fillpatched = fpi.get_mf();
     MultiFab::Copy(leveldata, mf_fillpatched, 0, dcomp, ncomp, boxGrow);
 }
 
+bool
+AmrLevel::FillPatchIncremental (AmrLevel& amrlevel,
+                                MultiFab& leveldata,
+                                int       boxGrow,
+                                Real      time,
+                                int       index,
+                                int       scomp,
+                                int       ncomp,
+                                int       dcomp)
+{
+    //
+    // Only the valid cells at one of the times of the old data can be
+    // taken over.  The EB factories are tied to the BoxArray of the level.
+    //
+    if (boxGrow != 0) return false;
+    if (dynamic_cast<const FArrayBoxFactory*>(&leveldata.Factory()) == nullptr) return false;
+
+    Vector<MultiFab*> smf;
+    Vector<Real> stime;
+    amrlevel.state[index].getData(smf,stime,time);
+    if (smf.size() != 1) return false;
+    MultiFab& src = *smf[0];
+
+    const BoxArray& ba = leveldata.boxArray();
+    const DistributionMapping& dm = leveldata.DistributionMap();
+    Vector<int> same = amrex::sameBoxes(ba, src.boxArray());
+
+    BoxList bl_changed(ba.ixType());
+    Vector<int> changed, pmap_changed;
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        if (same[i] >= 0 && dm[i] != src.DistributionMap()[same[i]]) {
+            same[i] = -1;
+        }
+        if (same[i] < 0) {
+            bl_changed.push_back(ba[i]);
+            changed.push_back(i);
+            pmap_changed.push_back(dm[i]);
+        }
+    }
+    if (changed.size() == ba.size()) return false;
+
+    BL_PROFILE("AmrLevel::FillPatchIncremental()");
+    //
+    // The new and changed boxes first, for they may need the old data of
+    // the unchanged ones.
+    //
+    if (!changed.empty())
+    {
+        MultiFab mf_changed(BoxArray(bl_changed), DistributionMapping(std::move(pmap_changed)),
+                            leveldata.nComp(), 0, MFInfo().SetAlloc(false));
+        FillPatchIterator fpi(amrlevel, mf_changed, 0, time, index, scomp, ncomp);
+        const MultiFab& mf_fillpatched = fpi.get_mf();
+        for (MFIter mfi(mf_fillpatched); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            leveldata[changed[mfi.index()]].copy(mf_fillpatched[mfi], bx, 0, bx, dcomp, ncomp);
+        }
+    }
+    //
+    // The unchanged ones.  The level is thrown away after the regrid, so
+    // whole FABs are moved out of it.
+    //
+    const bool move = scomp == 0 && dcomp == 0
+        && ncomp == src.nComp() && ncomp == leveldata.nComp()
+        && src.nGrow() == leveldata.nGrow();
+
+    if (move)
+    {
+        for (MFIter mfi(leveldata); mfi.isValid(); ++mfi)
+        {
+            const int i = mfi.index();
+            if (same[i] >= 0) {
+                leveldata.swapFab(i, src, same[i]);
+                amrlevel.m_cells_moved += mfi.validbox().numPts();
+            }
+        }
+        amrlevel.m_donated.push_back(index);
+    }
+    else
+    {
+        long ncopied = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:ncopied)
+#endif
+        for (MFIter mfi(leveldata); mfi.isValid(); ++mfi)
+        {
+            const int i = mfi.index();
+            if (same[i] >= 0) {
+                const Box& bx = mfi.validbox();
+                leveldata[mfi].copy(src[same[i]], bx, scomp, bx, dcomp, ncomp);
+                ncopied += bx.numPts();
+            }
+        }
+        amrlevel.m_cells_copied += ncopied;
+    }
+
+    return true;
+}
+
 void
 AmrLevel::FillPatchAdd(AmrLevel& amrlevel,
 		       MultiFab& leveldata,
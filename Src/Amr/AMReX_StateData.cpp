@@ -52,7 +52,10 @@ StateData::StateData (StateData&& rhs) noexcept
       new_time(rhs.new_time),
       old_time(rhs.old_time),
       new_data(std::move(rhs.new_data)),
-      old_data(std::move(rhs.old_data))
+      old_data(std::move(rhs.old_data)),
+      hist_data(std::move(rhs.hist_data)),
+      hist_time(std::move(rhs.hist_time)),
+      old_valid(rhs.old_valid)
 {   
 }
 
@@ -74,6 +77,16 @@ StateData::operator= (StateData const& rhs)
     } else {
         old_data.reset();
     }
+    hist_data.clear();
+    hist_data.resize(rhs.hist_data.size());
+    for (int i = 0; i < hist_data.size(); ++i) {
+        if (rhs.hist_data[i]) {
+            hist_data[i].reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory));
+            MultiFab::Copy(*hist_data[i], *rhs.hist_data[i], 0, 0, desc->nComp(),desc->nExtra());
+        }
+    }
+    hist_time = rhs.hist_time;
+    old_valid = rhs.old_valid;
 }
 
 void
@@ -117,6 +130,8 @@ StateData::define (const Box&             p_domain,
 
     new_data.reset(new MultiFab(grids,dmap,ncomp,desc->nExtra(), MFInfo(), *m_factory));
     old_data.reset();
+    old_valid = false;
+    clearHistory();
 }
 
 void
@@ -133,6 +148,7 @@ StateData::copyOld (const StateData& state)
     MultiFab::Copy(*old_data, state.oldData(), 0, 0, nc, ng);
     
     old_time = state.old_time;
+    old_valid = true;
 }
 
 void
@@ -155,8 +171,28 @@ void
 StateData::reset ()
 {
     new_time = old_time;
-    old_time.start = old_time.stop = INVALID_TIME;
-    std::swap(old_data, new_data);
+    if (!hist_data.empty() && hist_data[0] != nullptr)
+    {
+        // Undo swapTimeLevels: the history moves back to the old data.
+        std::unique_ptr<MultiFab> discarded = std::move(new_data);
+        new_data = std::move(old_data);
+        old_data = std::move(hist_data[0]);
+        old_time = hist_time[0];
+        old_valid = (old_time.start != INVALID_TIME);
+        const int nhist = hist_data.size();
+        for (int i = 0; i < nhist-1; ++i) {
+            hist_data[i] = std::move(hist_data[i+1]);
+            hist_time[i] = hist_time[i+1];
+        }
+        hist_data[nhist-1] = std::move(discarded);
+        hist_time[nhist-1].start = hist_time[nhist-1].stop = INVALID_TIME;
+    }
+    else
+    {
+        old_time.start = old_time.stop = INVALID_TIME;
+        std::swap(old_data, new_data);
+        old_valid = false;
+    }
 }
 
 void
@@ -209,6 +245,8 @@ StateData::restartDoit (std::istream& is, const std::string& chkfile)
     new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
                                 MFInfo(), *m_factory));
     old_data.reset();
+    clearHistory();
+    old_valid = (nsets == 2);
     if (nsets == 2) {
         old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(),
                                     MFInfo(), *m_factory));
@@ -273,6 +311,8 @@ StateData::restart (const StateDescriptor& d,
     new_time.start = rhs.new_time.start;
     new_time.stop  = rhs.new_time.stop;
     old_data.reset();
+    old_valid = false;
+    clearHistory();
     new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory));
     new_data->setVal(0.);
 }
@@ -288,9 +328,53 @@ StateData::allocOldData ()
     if (old_data == nullptr)
     {
         old_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory));
+        old_valid = false;
     }
 }
 
+void
+StateData::removeOldData ()
+{
+    old_data.reset();
+    old_valid = false;
+    for (auto& mf : hist_data) {
+        mf.reset();
+    }
+    for (auto& t : hist_time) {
+        t.start = t.stop = INVALID_TIME;
+    }
+}
+
+void
+StateData::clearHistory ()
+{
+    const int nhist = (desc->timeType() == StateDescriptor::Point) ? desc->nHistory() : 0;
+    hist_data.clear();
+    hist_data.resize(nhist);
+    hist_time.resize(nhist);
+    for (auto& t : hist_time) {
+        t.start = t.stop = INVALID_TIME;
+    }
+}
+
+int
+StateData::nHistory () const
+{
+    int n = 0;
+    Real tnext = old_time.start;
+    for (int i = 0; i < hist_data.size(); ++i)
+    {
+        if (hist_data[i] == nullptr || hist_time[i].start == INVALID_TIME ||
+            !(hist_time[i].start < tnext))
+        {
+            break;
+        }
+        tnext = hist_time[i].start;
+        ++n;
+    }
+    return n;
+}
+
 BCRec
 StateData::getBC (int comp, int i) const
 {
@@ -364,6 +448,35 @@ StateData::setTimeLevel (Real time,
 void
 StateData::swapTimeLevels (Real dt)
 {
+    if (!hist_data.empty() && old_data != nullptr)
+    {
+        // Only the pointers move.  The oldest level, if there is one
+        // yet, is reused for the new data.
+        std::unique_ptr<MultiFab> recycled = std::move(hist_data.back());
+        for (int i = hist_data.size()-1; i > 0; --i) {
+            hist_data[i] = std::move(hist_data[i-1]);
+            hist_time[i] = hist_time[i-1];
+        }
+        // Old data that were only allocated, e.g., after define(), do
+        // not count as a time level of the history.
+        hist_data[0] = std::move(old_data);
+        hist_time[0] = old_time;
+        if (!old_valid) {
+            hist_time[0].start = hist_time[0].stop = INVALID_TIME;
+        }
+        old_data = std::move(new_data);
+        if (recycled) {
+            new_data = std::move(recycled);
+        } else {
+            new_data.reset(new MultiFab(grids,dmap,desc->nComp(),desc->nExtra(), MFInfo(), *m_factory));
+        }
+    }
+    else
+    {
+        std::swap(old_data, new_data);
+    }
+    old_valid = true;
+
     old_time = new_time;
     if (desc->timeType() == StateDescriptor::Point)
     {
@@ -375,13 +488,13 @@ StateData::swapTimeLevels (Real dt)
         new_time.start = new_time.stop;
         new_time.stop += dt;
     }
-    std::swap(old_data, new_data);
 }
 
 void
 StateData::replaceOldData (MultiFab&& mf)
 {
     old_data.reset(new MultiFab(std::move(mf)));
+    old_valid = true;
 }
 
 // This version does NOT delete the replaced data.
@@ -390,6 +503,7 @@ void
 StateData::replaceOldData (StateData& s)
 {
     std::swap(old_data, s.old_data);
+    std::swap(old_valid, s.old_valid);
 }
 
 void
@@ -654,6 +768,10 @@ StateData::getData (Vector<MultiFab*>& data,
 	    	    data.push_back(old_data.get());
 		    datatime.push_back(old_time.start);
 	    } else {
+		for (int i = nHistory()-1; i >= 0; --i) {
+		    data.push_back(hist_data[i].get());
+		    datatime.push_back(hist_time[i].start);
+		}
 		data.push_back(old_data.get());
 		data.push_back(new_data.get());
 		datatime.push_back(old_time.start);
@@ -160,6 +160,12 @@ DescriptorList::resetComponentBCs (int                               indx,
     desc[indx]->resetComponentBCs(comp,bc,func);
 }
 
+void
+DescriptorList::setHistory (int indx, int nhist)
+{
+    desc[indx]->setHistory(nhist);
+}
+
 void
 DescriptorList::setComponent (int                               indx,
                               int                               comp,
@@ -229,7 +235,8 @@ StateDescriptor::StateDescriptor ()
     ngrow(0),
     mapper(0),
     m_extrap(false),
-    m_store_in_checkpoint(true)
+    m_store_in_checkpoint(true),
+    m_nhist(0)
 {}
 
 StateDescriptor::StateDescriptor (IndexType                   btyp,
@@ -248,7 +255,8 @@ StateDescriptor::StateDescriptor (IndexType                   btyp,
     ngrow(nextra),
     mapper(a_interp),
     m_extrap(a_extrap),
-    m_store_in_checkpoint(a_store_in_checkpoint)
+    m_store_in_checkpoint(a_store_in_checkpoint),
+    m_nhist(0)
 {
     BL_ASSERT (num_comp > 0);
    
@@ -344,6 +352,20 @@ StateDescriptor::store_in_checkpoint () const
     return m_store_in_checkpoint;
 }
 
+void
+StateDescriptor::setHistory (int nhist)
+{
+    BL_ASSERT(nhist >= 0 && nhist <= 2);
+    BL_ASSERT(t_type == Point || nhist == 0);
+    m_nhist = nhist;
+}
+
+int
+StateDescriptor::nHistory () const
+{
+    return m_nhist;
+}
+
 
 const StateDescriptor::BndryFunc&
 StateDescriptor::bndryFill (int i) const
@@ -636,7 +658,8 @@ StateDescriptor::Print () const
                     << "==== StateDescriptor:  ngrow  = " << ngrow << "\n"
                     << "==== StateDescriptor:  mapper  = " << mapper << "\n"
                     << "==== StateDescriptor:  m_extrap  = " << m_extrap << "\n"
-                    << "==== StateDescriptor:  m_store_in_checkpoint  = " << m_store_in_checkpoint << std::endl;
+                    << "==== StateDescriptor:  m_store_in_checkpoint  = " << m_store_in_checkpoint << "\n"
+                    << "==== StateDescriptor:  m_nhist  = " << m_nhist << std::endl;
   for(int i(0); i < names.size(); ++i) {
     amrex::AllPrint() << "==== StateDescriptor:  names[" << i << "]  = " << names[i] << std::endl;
   }
@@ -2,17 +2,187 @@
 #include <AMReX.H>
 #include <AMReX_AmrMesh.H>
 #include <AMReX_Cluster.H>
+#include <AMReX_BoxIterator.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_Print.H>
 
+#include <algorithm>
+#include <future>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace amrex {
 
 namespace
 {
     bool initialized = false;
+
+    //
+    // All that the grids are made from in StartNewGrids, copied so that
+    // the helper thread shares nothing with the time steps.
+    //
+    struct GridJob
+    {
+        int  lbase;
+        int  max_crse;
+        bool fixed;
+        int  fixed_upto;
+        int  n_proper;
+        Real grid_eff;
+        Vector<IntVect> bf_lev;
+        Vector<IntVect> ref_ratio;
+        Vector<IntVect> max_grid_size;
+        Vector<int>     n_error_buf;
+        Vector<Box>     domain;
+        Vector<Box>     pc_domain;
+        IntVect         periodic;
+        Vector<BoxList> p_n;
+        Vector<Vector<IntVect> > tags; // by level, coarsened by bf_lev
+    };
+
+    struct GridResult
+    {
+        int new_finest;
+        Vector<BoxList> grids;
+    };
+
+    //
+    // The clustering half of AmrMesh::MakeNewGrids.
+    //
+    GridResult
+    ClusterTags (GridJob& job)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        GridResult r;
+        r.new_finest = job.lbase;
+        r.grids.resize(job.max_crse+2);
+
+        for (int levc = job.max_crse; levc >= job.lbase; levc--)
+        {
+            const int levf = levc+1;
+            Vector<IntVect>& tagvec = job.tags[levc];
+
+            if (levf < r.new_finest)
+            {
+                //
+                // Tag the projection of the new grids at levf+1, as the
+                // proper nesting tags of MakeNewGrids, buffered like the
+                // cells tagged by error estimation.
+                //
+                const IntVect& rr = job.ref_ratio[levf];
+                const int nerr = job.n_error_buf[levf];
+
+                BoxList bl_tagged(r.grids[levf+1]);
+                bl_tagged.simplify();
+                bl_tagged.coarsen(rr);
+                for (Box& bx : bl_tagged)
+                {
+                    for (int idir = 0; idir < AMREX_SPACEDIM; idir++)
+                    {
+                        if (bx.smallEnd(idir) == job.domain[levf].smallEnd(idir))
+                            bx.growLo(idir,nerr);
+                        if (bx.bigEnd(idir) == job.domain[levf].bigEnd(idir))
+                            bx.growHi(idir,nerr);
+                    }
+                }
+                Box mboxF = amrex::grow(bl_tagged.minimalBox(),1);
+                BoxList blFcomp;
+                blFcomp.complementIn(mboxF,bl_tagged);
+                blFcomp.simplify();
+                bl_tagged.clear();
+
+                blFcomp.accrete(IntVect(AMREX_D_DECL(nerr/rr[0], nerr/rr[1], nerr/rr[2])));
+                BoxList blF;
+                blF.complementIn(mboxF,blFcomp);
+                for (Box& bx : blF)
+                {
+                    bx.grow(job.n_proper);
+                    for (int idir = 0; idir < AMREX_SPACEDIM; idir++)
+                    {
+                        if (nerr > job.n_error_buf[levc]*job.ref_ratio[levc][idir])
+                            bx.grow(idir,nerr-job.n_error_buf[levc]*job.ref_ratio[levc][idir]);
+                    }
+                    bx.coarsen(job.ref_ratio[levc]);
+                    bx.grow(job.n_error_buf[levc]);
+                    bx.coarsen(job.bf_lev[levc]);
+
+                    //
+                    // Tags outside the domain are mapped through the
+                    // periodic boundaries, as in TagBoxArray::mapPeriodic.
+                    //
+                    const IntVect& len = job.pc_domain[levc].size();
+                    for (BoxIterator si(Box(-job.periodic, job.periodic)); si.ok(); ++si)
+                    {
+                        const Box& sbx = amrex::shift(bx, si()*len);
+                        for (const Box& pn : job.p_n[levc])
+                        {
+                            const Box& isect = sbx & pn;
+                            for (BoxIterator bi(isect); bi.ok(); ++bi) {
+                                tagvec.push_back(bi());
+                            }
+                        }
+                    }
+                }
+                std::sort(tagvec.begin(), tagvec.end());
+                tagvec.erase(std::unique(tagvec.begin(), tagvec.end()), tagvec.end());
+            }
+
+            if (job.fixed && levc < job.fixed_upto) {
+                r.new_finest = std::max(r.new_finest,levf);
+            }
+
+            if (tagvec.size() > 0)
+            {
+                if ( !(job.fixed && levc < job.fixed_upto) ) {
+                    r.new_finest = std::max(r.new_finest,levf);
+                }
+
+                ClusterList clist(&tagvec[0], tagvec.size());
+                clist.chop(job.grid_eff);
+                BoxDomain bd;
+                bd.add(job.p_n[levc]);
+                clist.intersect(bd);
+                bd.clear();
+
+                BoxList new_bx;
+                clist.boxList(new_bx);
+                new_bx.refine(job.bf_lev[levc]);
+                new_bx.simplify();
+
+                if (new_bx.size() > 0 && !job.domain[levc].contains(new_bx.minimalBox())) {
+                    new_bx = amrex::intersect(new_bx,job.domain[levc]);
+                }
+
+                new_bx.maxSize(job.max_grid_size[levf] / job.ref_ratio[levc]);
+                new_bx.refine(job.ref_ratio[levc]);
+
+                if (new_bx.size() > 0 && !job.domain[levf].contains(new_bx.minimalBox())) {
+                    new_bx = amrex::intersect(new_bx,job.domain[levf]);
+                }
+
+                if (levf > job.fixed_upto) {
+                    r.grids[levf] = new_bx;
+                }
+            }
+            tagvec.clear();
+        }
+
+        return r;
+    }
 }
 
+struct AmrMesh::PendingGrids
+{
+    int                      finest_level;
+    Vector<BoxArray>         grids;  // levels 0 to lbase when started
+    std::future<GridResult>  result;
+};
+
 void
 AmrMesh::Initialize ()
 {
@@ -61,6 +231,8 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, std::vecto
     use_fixed_upto_level   = 0;
     refine_grid_layout     = true;
     check_input            = true;
+    incremental_regrid     = false;
+    sfc_order              = 0;
     
     ParmParse pp("amr");
 
@@ -316,6 +488,13 @@ AmrMesh::InitAmrMesh (int max_level_in, const Vector<int>& n_cell_in, std::vecto
 
     pp.query("check_input", check_input);
 
+    pp.query("incremental_regrid", incremental_regrid);
+
+    pp.query("sfc_order", sfc_order);
+    if (sfc_order < 0 || sfc_order > 2) {
+        amrex::Error("amr.sfc_order must be 0, 1 or 2");
+    }
+
     finest_level = -1;
 
     if (check_input) checkInput();
@@ -377,6 +556,16 @@ AmrMesh::ChopGrids (int lev, BoxArray& ba, int target_size) const
 	    }
 	}
     }
+
+    OrderGrids(lev, ba);
+}
+
+void
+AmrMesh::OrderGrids (int lev, BoxArray& ba) const
+{
+    if (sfc_order > 0) {
+        ba = amrex::sfcOrder(ba, blocking_factor[lev], sfc_order == 2);
+    }
 }
 
 BoxArray
@@ -387,6 +576,8 @@ AmrMesh::MakeBaseGrids () const
     ba.refine(2);
     if (refine_grid_layout) {
 	ChopGrids(0, ba, ParallelDescriptor::NProcs());
+    } else {
+        OrderGrids(0, ba);
     }
     if (ba == grids[0]) {
 	ba = grids[0];  // to avoid duplicates
@@ -396,23 +587,17 @@ AmrMesh::MakeBaseGrids () const
 
 
 void
-AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>& new_grids)
+AmrMesh::MakeNestingDomains (int lbase, int max_crse,
+                             Vector<IntVect>& bf_lev, Vector<IntVect>& rr_lev,
+                             Vector<Box>& pc_domain,
+                             Vector<BoxList>& p_n, Vector<BoxList>& p_n_comp) const
 {
-    BL_PROFILE("AmrMesh::MakeNewGrids()");
-
-    BL_ASSERT(lbase < max_level);
-
-    // Add at most one new level
-    int max_crse = std::min(finest_level, max_level-1);
-
-    if (new_grids.size() < max_crse+2) new_grids.resize(max_crse+2);
-
     //
     // Construct problem domain at each level.
     //
-    Vector<IntVect> bf_lev(max_level); // Blocking factor at each level.
-    Vector<IntVect> rr_lev(max_level);
-    Vector<Box>     pc_domain(max_level);  // Coarsened problem domain.
+    bf_lev.resize(max_level);
+    rr_lev.resize(max_level);
+    pc_domain.resize(max_level);
 
     for (int i = 0; i <= max_crse; i++)
     {
@@ -431,8 +616,10 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
     //
     // Construct proper nesting domains.
     //
-    Vector<BoxList> p_n(max_level);      // Proper nesting domain.
-    Vector<BoxList> p_n_comp(max_level); // Complement proper nesting domain.
+    p_n.clear();
+    p_n.resize(max_level);
+    p_n_comp.clear();
+    p_n_comp.resize(max_level);
 
     BoxList bl(grids[lbase]);
     bl.simplify();
@@ -464,6 +651,54 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         p_n[i].complementIn(pc_domain[i],p_n_comp[i]);
         p_n[i].simplify();
     }
+}
+
+void
+AmrMesh::ChopNewGrids (int lbase, int new_finest, Vector<BoxArray>& new_grids) const
+{
+    for (int lev = lbase+1; lev <= new_finest; ++lev) {
+        if (new_grids[lev].empty())
+        {
+            if (!(useFixedCoarseGrids() && lev<useFixedUpToLevel()) ) {
+                amrex::Abort("AmrMesh::MakeNewGrids: how did this happen?");
+            }
+        } 
+        else
+        {
+            if (refine_grid_layout) {
+                ChopGrids(lev,new_grids[lev],ParallelDescriptor::NProcs());
+            } else {
+                OrderGrids(lev,new_grids[lev]);
+            }
+            if (new_grids[lev] == grids[lev]) {
+                new_grids[lev] = grids[lev]; // to avoid dupliates
+            }
+        }
+    }
+}
+
+void
+AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>& new_grids)
+{
+    BL_PROFILE("AmrMesh::MakeNewGrids()");
+
+    BL_ASSERT(lbase < max_level);
+
+    // Add at most one new level
+    int max_crse = std::min(finest_level, max_level-1);
+
+    if (new_grids.size() < max_crse+2) new_grids.resize(max_crse+2);
+
+    //
+    // Construct problem domain at each level.
+    //
+    Vector<IntVect> bf_lev(max_level); // Blocking factor at each level.
+    Vector<IntVect> rr_lev(max_level);
+    Vector<Box>     pc_domain(max_level);  // Coarsened problem domain.
+    Vector<BoxList> p_n(max_level);      // Proper nesting domain.
+    Vector<BoxList> p_n_comp(max_level); // Complement proper nesting domain.
+
+    MakeNestingDomains(lbase, max_crse, bf_lev, rr_lev, pc_domain, p_n, p_n_comp);
 
     //
     // Now generate grids from finest level down.
@@ -683,21 +918,99 @@ AmrMesh::MakeNewGrids (int lbase, Real time, int& new_finest, Vector<BoxArray>&
         }
     }
 
+    ChopNewGrids(lbase, new_finest, new_grids);
+}
+
+void
+AmrMesh::StartNewGrids (int lbase, Real time)
+{
+    BL_PROFILE("AmrMesh::StartNewGrids()");
+
+    BL_ASSERT(lbase < max_level);
+
+    const int max_crse = std::min(finest_level, max_level-1);
+
+    std::shared_ptr<GridJob> job = std::make_shared<GridJob>();
+    job->lbase         = lbase;
+    job->max_crse      = max_crse;
+    job->fixed         = useFixedCoarseGrids();
+    job->fixed_upto    = useFixedUpToLevel();
+    job->n_proper      = n_proper;
+    job->grid_eff      = grid_eff;
+    job->ref_ratio     = ref_ratio;
+    job->max_grid_size = max_grid_size;
+    job->n_error_buf   = n_error_buf;
+    job->domain.resize(max_crse+2);
+    for (int lev = 0; lev <= max_crse+1; ++lev) {
+        job->domain[lev] = Geom(lev).Domain();
+    }
+    job->tags.resize(max_crse+1);
+    job->periodic = IntVect(AMREX_D_DECL(Geometry::isPeriodic(0),
+                                         Geometry::isPeriodic(1),
+                                         Geometry::isPeriodic(2)));
+
+    Vector<IntVect> rr_lev;
+    Vector<BoxList> p_n_comp;
+    MakeNestingDomains(lbase, max_crse, job->bf_lev, rr_lev, job->pc_domain, job->p_n, p_n_comp);
+
+    for (int levc = max_crse; levc >= lbase; levc--)
+    {
+        TagBoxArray tags(grids[levc],dmap[levc],n_error_buf[levc]);
+
+        if ( ! (useFixedCoarseGrids() && levc < useFixedUpToLevel()) ) {
+	    ErrorEst(levc, tags, time, 0);
+	}
+
+        tags.buffer(n_error_buf[levc]);
+
+        if (useFixedCoarseGrids() && levc >= useFixedUpToLevel()) {
+            tags.setVal(GetAreaNotToTag(levc), TagBox::CLEAR);
+        }
+
+        tags.coarsen(job->bf_lev[levc]);
+	ManualTagsPlacement(levc, tags, job->bf_lev);
+        tags.mapPeriodic(Geometry(job->pc_domain[levc]));
+        tags.setVal(p_n_comp[levc],TagBox::CLEAR);
+
+        tags.collate(job->tags[levc]);
+    }
+
+    if (pending_grids.size() <= lbase) pending_grids.resize(lbase+1);
+
+    pending_grids[lbase].reset(new PendingGrids);
+    PendingGrids& p = *pending_grids[lbase];
+    p.finest_level = finest_level;
+    p.grids.assign(grids.begin(), grids.begin()+lbase+1);
+    p.result = std::async(std::launch::async, [job] () { return ClusterTags(*job); });
+}
+
+bool
+AmrMesh::FinishNewGrids (int lbase, int& new_finest, Vector<BoxArray>& new_grids)
+{
+    BL_PROFILE("AmrMesh::FinishNewGrids()");
+
+    if (pending_grids.size() <= lbase || !pending_grids[lbase]) return false;
+
+    std::unique_ptr<PendingGrids> p = std::move(pending_grids[lbase]);
+    GridResult r = p->result.get();
+
+    bool valid = (p->finest_level == finest_level);
+    for (int lev = 0; lev <= lbase && valid; ++lev) {
+        valid = (p->grids[lev] == grids[lev]);
+    }
+    if (!valid) return false;
+
+    new_finest = r.new_finest;
+    if (new_grids.size() < r.grids.size()) new_grids.resize(r.grids.size());
     for (int lev = lbase+1; lev <= new_finest; ++lev) {
-        if (new_grids[lev].empty())
-        {
-            if (!(useFixedCoarseGrids() && lev<useFixedUpToLevel()) ) {
-                amrex::Abort("AmrMesh::MakeNewGrids: how did this happen?");
-            }
-        } 
-        else if (refine_grid_layout)
-        {
-            ChopGrids(lev,new_grids[lev],ParallelDescriptor::NProcs());
-            if (new_grids[lev] == grids[lev]) {
-                new_grids[lev] = grids[lev]; // to avoid dupliates
-            }
+        if (r.grids[lev].isNotEmpty()) {
+            new_grids[lev] = BoxArray(std::move(r.grids[lev]));
         }
     }
+
+    ChopNewGrids(lbase, new_finest, new_grids);
+
+    return true;
 }
 
 void
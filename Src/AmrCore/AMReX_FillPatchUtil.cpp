@@ -1,6 +1,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_FillPatchUtil.H>
 #include <AMReX_FillPatchUtil_F.H>
+#include <AMReX_MultiFabExpr.H>
 #include <cmath>
 #include <limits>
 
@@ -59,30 +60,16 @@ namespace amrex
 	else if (smf.size() == 2) 
 	{
 	    BL_ASSERT(smf[0]->boxArray() == smf[1]->boxArray());
-	    MultiFab raii;
-	    MultiFab * dmf;
-	    int destcomp;
-	    bool sameba;
-	    if (mf.boxArray() == smf[0]->boxArray()) {
-		dmf = &mf;
-		destcomp = dcomp;
-		sameba = true;
-	    } else {
-		raii.define(smf[0]->boxArray(), smf[0]->DistributionMap(), ncomp, 0,
-                            MFInfo(), smf[0]->Factory());
-			    
-		dmf = &raii;
-		destcomp = 0;
-		sameba = false;
-	    }
 
+	    if (mf.boxArray() == smf[0]->boxArray())
+	    {
 #ifdef _OPENMP
 #pragma omp parallel 
 #endif
-	    for (MFIter mfi(*dmf,true); mfi.isValid(); ++mfi)
-	    {
-		const Box& bx = mfi.tilebox();
-		(*dmf)[mfi].linInterp((*smf[0])[mfi],
+		for (MFIter mfi(mf,true); mfi.isValid(); ++mfi)
+		{
+		    const Box& bx = mfi.tilebox();
+		    mf[mfi].linInterp((*smf[0])[mfi],
 				      scomp,
 				      (*smf[1])[mfi],
 				      scomp,
@@ -90,26 +77,73 @@ namespace amrex
 				      stime[1],
 				      time,
 				      bx,
-				      destcomp,
+				      dcomp,
 				      ncomp);
-	    }
-	    
-	    if (sameba)
-	    {
-		// Note that when sameba is true mf's BoxArray is nonoverlapping.
+		}
+
+		// Note that when the BoxArrays are the same mf's BoxArray is nonoverlapping.
 		// So FillBoundary is safe.
 		mf.FillBoundary(dcomp,ncomp,geom.periodicity());
 	    }
 	    else
 	    {
-		int src_ngrow = 0;
-		int dst_ngrow = mf.nGrow();
+		// Interpolate in time as the data are copied, instead of
+		// into a temporary on smf's BoxArray that is then copied.
+		const Real tol = 1.0e-16;
+		if (std::abs(stime[1]-stime[0]) > tol)
+		{
+		    const Real alpha = (stime[1]-time)/(stime[1]-stime[0]);
+		    const Real beta  = (time-stime[0])/(stime[1]-stime[0]);
+		    mf.ParallelCopyLinComb(alpha, *smf[0], beta, *smf[1], scomp, dcomp, ncomp,
+					   IntVect::TheZeroVector(), mf.nGrowVect(),
+					   geom.periodicity());
+		}
+		else
+		{
+		    mf.copy(*smf[0], scomp, dcomp, ncomp, 0, mf.nGrow(), geom.periodicity());
+		}
+	    }
+	}
+	else if (smf.size() <= 4)
+	{
+	    // Lagrange interpolation in time through 3 or 4 levels.
+	    const int nt = smf.size();
+	    Vector<Real> w(nt, 1.0);
+	    for (int i = 0; i < nt; ++i) {
+		BL_ASSERT(smf[i]->boxArray() == smf[0]->boxArray());
+		for (int j = 0; j < nt; ++j) {
+		    if (j != i) {
+			BL_ASSERT(stime[i] != stime[j]);
+			w[i] *= (time-stime[j])/(stime[i]-stime[j]);
+		    }
+		}
+	    }
 
-		mf.copy(*dmf, 0, dcomp, ncomp, src_ngrow, dst_ngrow, geom.periodicity());
+	    if (mf.boxArray() == smf[0]->boxArray())
+	    {
+		using MFExpr::ref;
+		if (nt == 3) {
+		    MFExpr::assign(mf, dcomp, ncomp, 0,
+				   w[0]*ref(*smf[0],scomp) + w[1]*ref(*smf[1],scomp)
+				   + w[2]*ref(*smf[2],scomp));
+		} else {
+		    MFExpr::assign(mf, dcomp, ncomp, 0,
+				   w[0]*ref(*smf[0],scomp) + w[1]*ref(*smf[1],scomp)
+				   + w[2]*ref(*smf[2],scomp) + w[3]*ref(*smf[3],scomp));
+		}
+		mf.FillBoundary(dcomp,ncomp,geom.periodicity());
+	    }
+	    else
+	    {
+		// Interpolate in time as the data are copied, as for two levels.
+		const Vector<FabArray<FArrayBox> const*> src(smf.begin(), smf.end());
+		mf.ParallelCopyLinComb(w, src, scomp, dcomp, ncomp,
+				       IntVect::TheZeroVector(), mf.nGrowVect(),
+				       geom.periodicity());
 	    }
 	}
 	else {
-	    amrex::Abort("FillPatchSingleLevel: high-order interpolation in time not implemented yet");
+	    amrex::Abort("FillPatchSingleLevel: interpolation in time from more than 4 levels not implemented");
 	}
 
 	physbcf.FillBoundary(mf, dcomp, ncomp, time);
@@ -165,15 +199,24 @@ namespace amrex
                                                                       IntVect(ngrow),
                                                                       coarsener, 
                                                                       amrex::coarsen(fgeom.Domain(),ratio));
+	    // FillPatchSingleLevel below may build and evict cached items.
+	    FabArrayBase::CachePin fpc_pin(fpc);
 
 	    if ( ! fpc.ba_crse_patch.empty())
 	    {
-		MultiFab mf_crse_patch(fpc.ba_crse_patch, fpc.dm_crse_patch, ncomp, 0, MFInfo(),
-                                       *fpc.fact_crse_patch);
-		
-                mf_crse_patch.setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), cgeom);
+		// The coarse patches are kept with the cached FPinfo, which also
+		// keeps the copy metadata of FillPatchSingleLevel in the cache.
+		MultiFab mf_crse_tmp;
+		MultiFab* mf_crse_patch = fpc.borrowCrsePatch(ncomp);
+		if (mf_crse_patch == nullptr) {
+		    mf_crse_tmp.define(fpc.ba_crse_patch, fpc.dm_crse_patch, ncomp, 0, MFInfo(),
+				       *fpc.fact_crse_patch);
+		    mf_crse_patch = &mf_crse_tmp;
+		}
+
+                mf_crse_patch->setDomainBndry(std::numeric_limits<Real>::quiet_NaN(), 0, ncomp, cgeom);
 
-		FillPatchSingleLevel(mf_crse_patch, time, cmf, ct, scomp, 0, ncomp, cgeom, cbc);
+		FillPatchSingleLevel(*mf_crse_patch, time, cmf, ct, scomp, 0, ncomp, cgeom, cbc);
 
 		int idummy1=0, idummy2=0;
 		bool cc = fpc.ba_crse_patch.ixType().cellCentered();
@@ -181,9 +224,9 @@ namespace amrex
 #ifdef _OPENMP
 #pragma omp parallel if (cc)
 #endif
-		for (MFIter mfi(mf_crse_patch); mfi.isValid(); ++mfi)
+		for (MFIter mfi(*mf_crse_patch); mfi.isValid(); ++mfi)
 		{
-                    FArrayBox& sfab = mf_crse_patch[mfi];
+                    FArrayBox& sfab = (*mf_crse_patch)[mfi];
 		    int li = mfi.LocalIndex();
 		    int gi = fpc.dst_idxs[li];	
                     FArrayBox& dfab = mf[gi];
@@ -208,6 +251,8 @@ namespace amrex
 
                     post_interp(dfab, dbx, dcomp, ncomp);
 		}
+
+		fpc.releaseCrsePatch(mf_crse_patch);
 	    }
 	}
 
@@ -339,6 +384,7 @@ namespace amrex
         bool include_physbndry = false;
         const auto& cfinfo = FabArrayBase::TheCFinfo(fine[0], fgeom, IntVect(ngrow),
                                                      include_periodic, include_physbndry);
+        FabArrayBase::CachePin cfinfo_pin(cfinfo);
 
         if (! cfinfo.ba_cfb.empty())
         {
@@ -1,10 +1,16 @@
 
 #include <climits>
+#include <cmath>
+#include <algorithm>
+#include <vector>
 
 #include <AMReX_FArrayBox.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_Interpolater.H>
 #include <AMReX_INTERP_F.H>
+#include <AMReX_BC_TYPES.H>
+#include <AMReX_RESTRICT.H>
+#include <AMReX_Utility.H>
 
 namespace amrex {
 
@@ -25,6 +31,396 @@ CellConservativeLinear    cell_cons_interp(0);
 CellConservativeProtected protected_interp;
 CellConservativeQuartic   quartic_interp;
 
+namespace {
+
+//
+// Scratch space of the interpolaters.  Every thread keeps one buffer that
+// only grows, so that the strips and slopes are not allocated on every
+// call.  A caller takes all its scratch with a single call and must not
+// call it again until it is done with the memory.
+//
+Real*
+interp_scratch (std::size_t n)
+{
+    static thread_local std::vector<Real> buf;
+    if (buf.size() < n) {
+        buf.clear();
+        buf.shrink_to_fit();
+        buf.resize(n);
+    }
+    return buf.data();
+}
+
+//
+// Same as Geometry::GetEdgeVolCoord, into vc[0:region.length(dir)].
+//
+void
+edge_vol_coord (const Geometry& geom, const Box& region, int dir, Real* vc)
+{
+    const int  len = region.length(dir) + 1;
+    const Real dx  = geom.CellSize(dir);
+    const Real off = CoordSys::Offset(dir) + dx*region.smallEnd(dir);
+    for (int i = 0; i < len; ++i) {
+        vc[i] = off + dx*i;
+    }
+#if (AMREX_SPACEDIM == 2)
+    if (dir == 0 && CoordSys::Coord() == CoordSys::RZ) {
+        for (int i = 0; i < len; ++i) {
+            const Real r = vc[i];
+            vc[i] = 0.5*r*r;
+        }
+    } else if (dir == 0 && CoordSys::Coord() == CoordSys::SPHERICAL) {
+        for (int i = 0; i < len; ++i) {
+            const Real r = vc[i];
+            vc[i] = 0.3*r*r*r;
+        }
+    }
+#endif
+}
+
+#if (AMREX_SPACEDIM > 1)
+
+inline Real
+lim_slope (Real cen, Real cm, Real c, Real cp)
+{
+    const Real forw = 2.0*(cp - c);
+    const Real back = 2.0*(c - cm);
+    Real slp = std::min(std::abs(forw),std::abs(back));
+    slp = (forw*back >= 0.0) ? slp : 0.0;
+    return std::copysign(1.0,cen)*std::min(slp,std::abs(cen));
+}
+
+inline bool
+ho_bndry (int bc)
+{
+    return bc == BCType::ext_dir || bc == BCType::hoextrap;
+}
+
+//
+// The linear conservative interpolation of amrex_linccinterp, one row of
+// coarse cells of cslope_bx at a time.  The slopes of a row are kept in
+// scratch and the fine cells under the row are then filled with unit
+// stride.  RX is the ratio in the first direction, or 0 if it is only
+// known at run time.  The arithmetic is done in the same order as in the
+// Fortran so that the results are identical.
+//
+template <int RX>
+void
+cell_cons_lin_interp (const FArrayBox& crse,
+                      int              crse_comp,
+                      FArrayBox&       fine,
+                      int              fine_comp,
+                      int              ncomp,
+                      const Box&       target_fine_region,
+                      const Box&       cslope_bx,
+                      const IntVect&   ratio,
+                      const Geometry&  crse_geom,
+                      const Geometry&  fine_geom,
+                      const Vector<BCRec>& bcr,
+                      bool             lin_limit)
+{
+    const int rx = (RX > 0) ? RX : ratio[0];
+    const int* rr = ratio.getVect();
+
+    const Box& cbox = crse.box();
+    const Box& fbox = fine.box();
+    const int* cslo = cslope_bx.loVect();
+    const int* cshi = cslope_bx.hiVect();
+    const int* fblo = target_fine_region.loVect();
+    const int* fbhi = target_fine_region.hiVect();
+
+    const int nc = cslope_bx.length(0);
+    int nf[AMREX_SPACEDIM];
+    std::size_t nscratch = 0;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        nf[d] = cslope_bx.length(d)*rr[d];
+        nscratch += (nf[d]+1) + (cslope_bx.length(d)+3) + nf[d];
+    }
+    nscratch += std::size_t(nc)*(2*AMREX_SPACEDIM*ncomp + ncomp + AMREX_SPACEDIM);
+
+    Real* p = interp_scratch(nscratch);
+    Real* voff[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; ++d)
+    {
+        //
+        // Edge volume coordinates of the refined cslope_bx and of cslope_bx
+        // grown by one, and the offsets of the fine cell centers.
+        //
+        Real* fvc = p;
+        Real* cvc = fvc + nf[d] + 1;
+        voff[d]   = cvc + cslope_bx.length(d) + 3;
+        p         = voff[d] + nf[d];
+        edge_vol_coord(fine_geom, amrex::refine(cslope_bx,ratio), d, fvc);
+        edge_vol_coord(crse_geom, amrex::grow(cslope_bx,1), d, cvc);
+        for (int i = 0; i < nf[d]; ++i) {
+            const int ic = i/rr[d] + 1;
+            const Real fcen = 0.5*(fvc[i]+fvc[i+1]);
+            const Real ccen = 0.5*(cvc[ic]+cvc[ic+1]);
+            voff[d][i] = (fcen-ccen)/(cvc[ic+1]-cvc[ic]);
+        }
+    }
+    Real* uc[AMREX_SPACEDIM];
+    Real* lc[AMREX_SPACEDIM];
+    Real* fac[AMREX_SPACEDIM];
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        uc[d]  = p;  p += nc*ncomp;
+        lc[d]  = p;  p += nc*ncomp;
+        fac[d] = p;  p += nc;
+    }
+    Real* alpha = p;
+
+    const Real eps = static_cast<Real>(1.e-10f);
+
+    const long cjs = cbox.length(0);
+    const long fjs = fbox.length(0);
+#if (AMREX_SPACEDIM == 3)
+    const long cks = cjs*cbox.length(1);
+    const long fks = fjs*fbox.length(1);
+    const int  ck0 = cbox.smallEnd(2);
+    const int  fk0 = fbox.smallEnd(2);
+    const int  klo = cslo[2], khi = cshi[2];
+#else
+    const long cks = 0, fks = 0;
+    const int  ck0 = 0, fk0 = 0;
+    const int  klo = 0, khi = 0;
+#endif
+    const long dstr[3] = { 1, cjs, cks };
+
+    for (int kc = klo; kc <= khi; ++kc) {
+    for (int jc = cslo[1]; jc <= cshi[1]; ++jc)
+    {
+        const long coff = (cslo[0]-cbox.smallEnd(0)) + (jc-cbox.smallEnd(1))*cjs + (kc-ck0)*cks;
+
+        for (int n = 0; n < ncomp; ++n)
+        {
+            const Real* c = crse.dataPtr(crse_comp+n) + coff;
+            const int* bc = bcr[n].vect();
+
+            for (int d = 0; d < AMREX_SPACEDIM; ++d)
+            {
+                const long s = dstr[d];
+                Real* u = uc[d] + n*nc;
+                Real* l = lc[d] + n*nc;
+
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < nc; ++i) {
+                    u[i] = 0.5*(c[i+s]-c[i-s]);
+                    l[i] = lim_slope(u[i], c[i-s], c[i], c[i+s]);
+                }
+
+                //
+                // One sided slopes next to ext_dir and hoextrap boundaries.
+                //
+                const int  ic = (d == 0) ? cslo[0] : (d == 1) ? jc : kc;
+                const int  nb = (d == 0) ? 1 : nc;
+                const bool ok = (cshi[d]-cslo[d]+1 >= 2);
+                if (ho_bndry(bc[d]) && ic == cslo[d])
+                {
+                    for (int i = 0; i < nb; ++i) {
+                        if (ok) {
+                            u[i] = -16.0/15.0*c[i-s] + 0.5*c[i]
+                                + (2.0/3.0)*c[i+s] - 0.1*c[i+2*s];
+                        } else {
+                            u[i] = 0.25*(c[i+s] + 5.0*c[i] - 6.0*c[i-s]);
+                        }
+                        l[i] = lim_slope(u[i], c[i-s], c[i], c[i+s]);
+                    }
+                }
+                if (ho_bndry(bc[d+AMREX_SPACEDIM]) && ((d == 0) ? cshi[0] : ic) == cshi[d])
+                {
+                    for (int i = nc-nb; i < nc; ++i) {
+                        if (ok) {
+                            u[i] = 16.0/15.0*c[i+s] - 0.5*c[i]
+                                - (2.0/3.0)*c[i-s] + 0.1*c[i-2*s];
+                        } else {
+                            u[i] = -0.25*(c[i-s] + 5.0*c[i] - 6.0*c[i+s]);
+                        }
+                        l[i] = lim_slope(u[i], c[i-s], c[i], c[i+s]);
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < nc*ncomp; ++i) {
+            alpha[i] = 1.0;
+        }
+
+        if (lin_limit)
+        {
+            //
+            // One factor per direction and cell for all the components.
+            //
+            for (int d = 0; d < AMREX_SPACEDIM; ++d)
+            {
+                Real* f = fac[d];
+                for (int i = 0; i < nc; ++i) {
+                    f[i] = 1.0;
+                }
+                for (int n = 0; n < ncomp; ++n) {
+                    const Real* u = uc[d] + n*nc;
+                    const Real* l = lc[d] + n*nc;
+                    AMREX_PRAGMA_SIMD
+                    for (int i = 0; i < nc; ++i) {
+                        const Real denom = (u[i] != 0.0) ? u[i] : 1.0;
+                        f[i] = std::min(f[i], l[i]/denom);
+                    }
+                }
+                for (int n = 0; n < ncomp; ++n) {
+                    const Real* u = uc[d] + n*nc;
+                    Real* l = lc[d] + n*nc;
+                    AMREX_PRAGMA_SIMD
+                    for (int i = 0; i < nc; ++i) {
+                        l[i] = f[i]*u[i];
+                    }
+                }
+            }
+        }
+        else
+        {
+            //
+            // Limit the slopes so that no fine cell under the coarse cell
+            // goes beyond the extrema of its neighborhood.
+            //
+            const int ry = rr[1];
+            const Real* vx = voff[0];
+            const Real* vy = voff[1] + (jc-cslo[1])*ry;
+#if (AMREX_SPACEDIM == 3)
+            const int rz = rr[2];
+            const Real* vz = voff[2] + (kc-cslo[2])*rz;
+#else
+            const int rz = 1;
+#endif
+            for (int n = 0; n < ncomp; ++n)
+            {
+                const Real* c = crse.dataPtr(crse_comp+n) + coff;
+                const Real* lx = lc[0] + n*nc;
+                const Real* ly = lc[1] + n*nc;
+#if (AMREX_SPACEDIM == 3)
+                const Real* lz = lc[2] + n*nc;
+#endif
+                Real* a = alpha + n*nc;
+
+                for (int i = 0; i < nc; ++i)
+                {
+                    const Real cc = c[i];
+                    Real cmax = cc, cmin = cc;
+#if (AMREX_SPACEDIM == 3)
+                    for (int koff = -1; koff <= 1; ++koff)
+#else
+                    const int koff = 0;
+#endif
+                    for (int joff = -1; joff <= 1; ++joff) {
+                        const Real* cn = c + i + joff*cjs + koff*cks;
+                        for (int ioff = -1; ioff <= 1; ++ioff) {
+                            cmax = std::max(cmax, cn[ioff]);
+                            cmin = std::min(cmin, cn[ioff]);
+                        }
+                    }
+
+                    const Real tol = eps*std::abs(cc);
+                    Real ai = 1.0;
+                    for (int kf = 0; kf < rz; ++kf) {
+                    for (int jf = 0; jf < ry; ++jf) {
+                        for (int iff = i*rx; iff < (i+1)*rx; ++iff)
+                        {
+                            const Real corr = AMREX_D_TERM(vx[iff]*lx[i],
+                                                           + vy[jf]*ly[i],
+                                                           + vz[kf]*lz[i]);
+                            const Real dummy = cc + corr;
+                            if (dummy > cmax && std::abs(corr) > tol) {
+                                ai = std::min(ai, (cmax-cc)/corr);
+                            }
+                            if (dummy < cmin && std::abs(corr) > tol) {
+                                ai = std::min(ai, (cmin-cc)/corr);
+                            }
+                        }
+                    }}
+                    a[i] = ai;
+                }
+            }
+        }
+
+        //
+        // The fine cells under this row of coarse cells.
+        //
+#if (AMREX_SPACEDIM == 3)
+        const int kflo = std::max(fblo[2], kc*rr[2]);
+        const int kfhi = std::min(fbhi[2], kc*rr[2]+rr[2]-1);
+#else
+        const int kflo = 0, kfhi = 0;
+#endif
+        const int jflo = std::max(fblo[1], jc*rr[1]);
+        const int jfhi = std::min(fbhi[1], jc*rr[1]+rr[1]-1);
+        const int ilo  = fblo[0];
+        const int len  = fbhi[0] - fblo[0] + 1;
+        const int ishift = fblo[0] - cslo[0]*rx;
+        const Real* vx = voff[0] + ishift;
+
+        for (int kf = kflo; kf <= kfhi; ++kf) {
+        for (int jf = jflo; jf <= jfhi; ++jf)
+        {
+            const Real vyj = voff[1][jf-cslo[1]*rr[1]];
+#if (AMREX_SPACEDIM == 3)
+            const Real vzk = voff[2][kf-cslo[2]*rr[2]];
+#endif
+            const long foff = (ilo-fbox.smallEnd(0)) + (jf-fbox.smallEnd(1))*fjs + (kf-fk0)*fks;
+
+            for (int n = 0; n < ncomp; ++n)
+            {
+                const Real* AMREX_RESTRICT c  = crse.dataPtr(crse_comp+n) + coff;
+                const Real* AMREX_RESTRICT a  = alpha + n*nc;
+                const Real* AMREX_RESTRICT lx = lc[0] + n*nc;
+                const Real* AMREX_RESTRICT ly = lc[1] + n*nc;
+#if (AMREX_SPACEDIM == 3)
+                const Real* AMREX_RESTRICT lz = lc[2] + n*nc;
+#endif
+                Real* AMREX_RESTRICT f = fine.dataPtr(fine_comp+n) + foff;
+
+                AMREX_PRAGMA_SIMD
+                for (int ii = 0; ii < len; ++ii)
+                {
+                    const int i = (ii + ishift)/rx;
+                    f[ii] = c[i] + a[i]*(AMREX_D_TERM(vx[ii]*lx[i],
+                                                      + vyj*ly[i],
+                                                      + vzk*lz[i]));
+                }
+            }
+        }}
+    }}
+}
+
+void
+cell_cons_lin_interp (const FArrayBox& crse,
+                      int              crse_comp,
+                      FArrayBox&       fine,
+                      int              fine_comp,
+                      int              ncomp,
+                      const Box&       target_fine_region,
+                      const Box&       cslope_bx,
+                      const IntVect&   ratio,
+                      const Geometry&  crse_geom,
+                      const Geometry&  fine_geom,
+                      const Vector<BCRec>& bcr,
+                      bool             lin_limit)
+{
+    if (!target_fine_region.ok()) return;
+
+    if (ratio[0] == 2) {
+        cell_cons_lin_interp<2>(crse, crse_comp, fine, fine_comp, ncomp, target_fine_region,
+                                cslope_bx, ratio, crse_geom, fine_geom, bcr, lin_limit);
+    } else if (ratio[0] == 4) {
+        cell_cons_lin_interp<4>(crse, crse_comp, fine, fine_comp, ncomp, target_fine_region,
+                                cslope_bx, ratio, crse_geom, fine_geom, bcr, lin_limit);
+    } else {
+        cell_cons_lin_interp<0>(crse, crse_comp, fine, fine_comp, ncomp, target_fine_region,
+                                cslope_bx, ratio, crse_geom, fine_geom, bcr, lin_limit);
+    }
+}
+
+#endif
+
+}
+
 Interpolater::~Interpolater () {}
 
 InterpolaterBoxCoarsener
@@ -115,7 +511,7 @@ NodeBilinear::interp (const FArrayBox&  crse,
     int len0       = crse.box().length(0);
     int slp_len    = num_slope*len0;
 
-    Vector<Real> strip(slp_len);
+    Real* strip = interp_scratch(slp_len);
 
     const Real* cdat  = crse.dataPtr(crse_comp);
     Real*       fdat  = fine.dataPtr(fine_comp);
@@ -124,7 +520,7 @@ NodeBilinear::interp (const FArrayBox&  crse,
     amrex_nbinterp (cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),AMREX_ARLIM(clo),AMREX_ARLIM(chi),
                    fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),AMREX_ARLIM(lo),AMREX_ARLIM(hi),
                    AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),&ncomp,
-                   strip.dataPtr(),&num_slope,&actual_comp,&actual_state);
+                   strip,&num_slope,&actual_comp,&actual_state);
 }
 
 CellBilinear::~CellBilinear () {}
@@ -190,11 +586,10 @@ CellBilinear::interp (const FArrayBox&  crse,
     int len0       = crse.box().length(0);
     int slp_len    = num_slope*len0;
 
-    Vector<Real> slope(slp_len);
-
     int strp_len = len0*ratio[0];
 
-    Vector<Real> strip(strp_len);
+    Real* slope = interp_scratch(slp_len + strp_len);
+    Real* strip = slope + slp_len;
 
     int strip_lo = ratio[0] * clo[0];
     int strip_hi = ratio[0] * chi[0];
@@ -206,7 +601,7 @@ CellBilinear::interp (const FArrayBox&  crse,
     amrex_cbinterp (cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),AMREX_ARLIM(clo),AMREX_ARLIM(chi),
                    fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),AMREX_ARLIM(lo),AMREX_ARLIM(hi),
                    AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),&ncomp,
-                   slope.dataPtr(),&num_slope,strip.dataPtr(),&strip_lo,&strip_hi,
+                   slope,&num_slope,strip,&strip_lo,&strip_hi,
                    &actual_comp,&actual_state);
 }
 
@@ -284,53 +679,41 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     //
     Box cslope_bx(crse_bx);
     cslope_bx.grow(-1);
+
+#if (AMREX_SPACEDIM > 1)
+
+    cell_cons_lin_interp(crse, crse_comp, fine, fine_comp, ncomp,
+                         target_fine_region, cslope_bx, ratio,
+                         crse_geom, fine_geom, bcr, do_linear_limiting);
+
+#else
     //
     // Make a refinement of cslope_bx
     //
     Box fine_version_of_cslope_bx = amrex::refine(cslope_bx,ratio);
     //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    int dir;
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
-    {
-        fine_geom.GetEdgeVolCoord(fvc[dir],fine_version_of_cslope_bx,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
-    }
-    //
-    // alloc tmp space for slope calc.
+    // Coarse and fine edge-centered volume coordinates, the slopes, the
+    // limiters and the offsets, all in the scratch space of this thread.
     //
-    // In ucc_slopes and lcc_slopes , there is a slight abuse of 
-    // the number of compenents argument
-    // --> there is a slope for each component in each coordinate 
-    //     direction
-    //
-    FArrayBox ucc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
-    FArrayBox lcc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
-    FArrayBox slope_factors(cslope_bx,AMREX_SPACEDIM);
-
-    FArrayBox  cmax(cslope_bx,ncomp);
-    FArrayBox  cmin(cslope_bx,ncomp);
-    FArrayBox alpha(cslope_bx,ncomp);
+    const int fvc_len = fine_version_of_cslope_bx.length(0) + 1;
+    const int cvc_len = crse_bx.length(0) + 1;
+    const int cs_len  = cslope_bx.length(0);
+
+    Real* fvc        = interp_scratch(2*fvc_len + cvc_len + (5*ncomp+1)*cs_len);
+    Real* voffx      = fvc + fvc_len;
+    Real* cvc        = voffx + fvc_len;
+    Real* ucc_xsldat = cvc + cvc_len;
+    Real* lcc_xsldat = ucc_xsldat + ncomp*cs_len;
+    Real* alpha      = lcc_xsldat + ncomp*cs_len;
+    Real* cmax       = alpha + ncomp*cs_len;
+    Real* cmin       = cmax + ncomp*cs_len;
+    Real* xslfac_dat = cmin + ncomp*cs_len;
+
+    edge_vol_coord(fine_geom, fine_version_of_cslope_bx, 0, fvc);
+    edge_vol_coord(crse_geom, crse_bx, 0, cvc);
 
-    Real* fdat       = fine.dataPtr(fine_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-    Real* ucc_xsldat = ucc_slopes.dataPtr(0);
-    Real* lcc_xsldat = lcc_slopes.dataPtr(0);
-    Real* xslfac_dat = slope_factors.dataPtr(0);
-#if (AMREX_SPACEDIM>=2)
-    Real* ucc_ysldat = ucc_slopes.dataPtr(ncomp);
-    Real* lcc_ysldat = lcc_slopes.dataPtr(ncomp);
-    Real* yslfac_dat = slope_factors.dataPtr(1);
-#endif
-#if (AMREX_SPACEDIM==3)
-    Real* ucc_zsldat = ucc_slopes.dataPtr(2*ncomp);
-    Real* lcc_zsldat = lcc_slopes.dataPtr(2*ncomp);
-    Real* zslfac_dat = slope_factors.dataPtr(2);
-#endif
-    
+    Real* fdat        = fine.dataPtr(fine_comp);
+    const Real* cdat  = crse.dataPtr(crse_comp);
     const int* flo    = fine.loVect();
     const int* fhi    = fine.hiVect();
     const int* clo    = crse.loVect();
@@ -343,19 +726,8 @@ CellConservativeLinear::interp (const FArrayBox& crse,
     const int* cvcblo = crse_bx.loVect();
     const int* fvcblo = fine_version_of_cslope_bx.loVect();
     int slope_flag    = 1;
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
-
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
-    {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
-    }
-
-    AMREX_D_TERM(Real* voffx = new Real[fvc[0].size()];,
-           Real* voffy = new Real[fvc[1].size()];,
-           Real* voffz = new Real[fvc[2].size()];);
+    int cvcbhi[1]     = { cvcblo[0] + cvc_len - 1 };
+    int fvcbhi[1]     = { fvcblo[0] + fvc_len - 1 };
 
     Vector<int> bc     = GetBCArray(bcr);
     const int* ratioV = ratio.getVect();
@@ -366,24 +738,14 @@ CellConservativeLinear::interp (const FArrayBox& crse,
                       cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
                       AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
                       ucc_xsldat, lcc_xsldat, xslfac_dat,
-#if (AMREX_SPACEDIM>=2)
-                      ucc_ysldat, lcc_ysldat, yslfac_dat,
-#endif
-#if (AMREX_SPACEDIM==3)
-                      ucc_zsldat, lcc_zsldat, zslfac_dat,
-#endif
                       AMREX_ARLIM(csblo), AMREX_ARLIM(csbhi),
                       csblo, csbhi,
-                      &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
+                      &ncomp,&ratioV[0],
                       bc.dataPtr(), &slope_flag, &lin_limit,
-                      AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                      AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                      AMREX_D_DECL(voffx,voffy,voffz),
-                      alpha.dataPtr(),cmax.dataPtr(),cmin.dataPtr(),
+                      fvc, cvc, voffx, alpha, cmax, cmin,
                       &actual_comp,&actual_state);
 
-    AMREX_D_TERM(delete [] voffx;, delete [] voffy;, delete [] voffz;);
-
+#endif /*(AMREX_SPACEDIM > 1)*/
 }
 
 CellQuadratic::CellQuadratic (bool limit)
@@ -444,8 +806,7 @@ CellQuadratic::interp (const FArrayBox& crse,
     long t_long = cslope_bx.numPts();
     BL_ASSERT(t_long < INT_MAX);
     int c_len = int(t_long);
-
-    Vector<Real> cslope(5*c_len);
+    const int cslope_len = 5*c_len;
 
     int loslp = cslope_bx.index(crse_bx.smallEnd());
     int hislp = cslope_bx.index(crse_bx.bigEnd());
@@ -462,21 +823,33 @@ CellQuadratic::interp (const FArrayBox& crse,
     //
     int dir;
     int f_len = fslope_bx.longside(dir);
+    //
+    // The slopes, the strip and the coarse and fine edge-centered volume
+    // coordinates share the scratch space of this thread.
+    //
+    std::size_t nscratch = cslope_len + (5+2)*f_len;
+    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        nscratch += target_fine_region.length(dir) + crse_bx.length(dir) + 2;
+    }
 
-    Vector<Real> strip((5+2)*f_len);
-
-    Real* fstrip = strip.dataPtr();
+    Real* cslope = interp_scratch(nscratch);
+    Real* fstrip = cslope + cslope_len;
     Real* foff   = fstrip + f_len;
     Real* fslope = foff + f_len;
     //
     // Get coarse and fine edge-centered volume coordinates.
     //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
+    Real* fvc[AMREX_SPACEDIM];
+    Real* cvc[AMREX_SPACEDIM];
+    Real* p = fslope + 5*f_len;
     for (dir = 0; dir < AMREX_SPACEDIM; dir++)
     {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+        fvc[dir] = p;
+        cvc[dir] = fvc[dir] + target_fine_region.length(dir) + 1;
+        p        = cvc[dir] + crse_bx.length(dir) + 1;
+        edge_vol_coord(fine_geom,target_fine_region,dir,fvc[dir]);
+        edge_vol_coord(crse_geom,crse_bx,dir,cvc[dir]);
     }
     //
     // Alloc tmp space for slope calc and to allow for vectorization.
@@ -503,10 +876,10 @@ CellQuadratic::interp (const FArrayBox& crse,
                    cdat,&clo,&chi,
                    AMREX_ARLIM(cblo), AMREX_ARLIM(cbhi),
                    fslo,fshi,
-                   cslope.dataPtr(),&c_len,fslope,fstrip,&f_len,foff,
+                   cslope,&c_len,fslope,fstrip,&f_len,foff,
                    bc.dataPtr(), &slope_flag,
-                   AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                   AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
+                   AMREX_D_DECL(fvc[0],fvc[1],fvc[2]),
+                   AMREX_D_DECL(cvc[0],cvc[1],cvc[2]),
                    &actual_comp,&actual_state);
 
 #endif /*(AMREX_SPACEDIM > 1)*/
@@ -562,7 +935,7 @@ PCInterp::interp (const FArrayBox& crse,
     int long_len = cregion.longside(long_dir);
     int s_len    = long_len*ratio[long_dir];
 
-    Vector<Real> strip(s_len);
+    Real* strip = interp_scratch(s_len);
 
     int strip_lo = ratio[long_dir] * cblo[long_dir];
     int strip_hi = ratio[long_dir] * (cbhi[long_dir]+1) - 1;
@@ -577,7 +950,7 @@ PCInterp::interp (const FArrayBox& crse,
     amrex_pcinterp (cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),cblo,cbhi,
                    fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),fblo,fbhi,
                    &long_dir,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                   &ncomp,strip.dataPtr(),&strip_lo,&strip_hi,
+                   &ncomp,strip,&strip_lo,&strip_hi,
                    &actual_comp,&actual_state);
 }
 
@@ -632,105 +1005,12 @@ CellConservativeProtected::interp (const FArrayBox& crse,
     //
     Box cslope_bx(crse_bx);
     cslope_bx.grow(-1);
-    //
-    // Make a refinement of cslope_bx
-    //
-    Box fine_version_of_cslope_bx = amrex::refine(cslope_bx,ratio);
-    //
-    // Get coarse and fine edge-centered volume coordinates.
-    //
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    int dir;
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
-    {
-        fine_geom.GetEdgeVolCoord(fvc[dir],fine_version_of_cslope_bx,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
-    }
-    //
-    // alloc tmp space for slope calc.
-    //
-    // In ucc_slopes and lcc_slopes , there is a slight abuse of 
-    // the number of compenents argument
-    // --> there is a slope for each component in each coordinate 
-    //     direction
-    //
-    FArrayBox ucc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
-    FArrayBox lcc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
-    FArrayBox slope_factors(cslope_bx,AMREX_SPACEDIM);
-
-    FArrayBox  cmax(cslope_bx,ncomp);
-    FArrayBox  cmin(cslope_bx,ncomp);
-    FArrayBox alpha(cslope_bx,ncomp);
-
-    Real* fdat       = fine.dataPtr(fine_comp);
-    const Real* cdat = crse.dataPtr(crse_comp);
-    Real* ucc_xsldat = ucc_slopes.dataPtr(0);
-    Real* lcc_xsldat = lcc_slopes.dataPtr(0);
-    Real* xslfac_dat = slope_factors.dataPtr(0);
-#if (AMREX_SPACEDIM>=2)
-    Real* ucc_ysldat = ucc_slopes.dataPtr(ncomp);
-    Real* lcc_ysldat = lcc_slopes.dataPtr(ncomp);
-    Real* yslfac_dat = slope_factors.dataPtr(1);
-#endif
-#if (AMREX_SPACEDIM==3)
-    Real* ucc_zsldat = ucc_slopes.dataPtr(2*ncomp);
-    Real* lcc_zsldat = lcc_slopes.dataPtr(2*ncomp);
-    Real* zslfac_dat = slope_factors.dataPtr(2);
-#endif
-    
-    const int* flo    = fine.loVect();
-    const int* fhi    = fine.hiVect();
-    const int* clo    = crse.loVect();
-    const int* chi    = crse.hiVect();
-    const int* fblo   = target_fine_region.loVect();
-    const int* fbhi   = target_fine_region.hiVect();
-    const int* csbhi  = cslope_bx.hiVect();
-    const int* csblo  = cslope_bx.loVect();
-    int lin_limit     = 1;
-    const int* cvcblo = crse_bx.loVect();
-    const int* fvcblo = fine_version_of_cslope_bx.loVect();
-
-    int cvcbhi[AMREX_SPACEDIM];
-    int fvcbhi[AMREX_SPACEDIM];
-
-    for (dir=0; dir<AMREX_SPACEDIM; dir++)
-    {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
-    }
-
-    AMREX_D_TERM(Real* voffx = new Real[fvc[0].size()];,
-           Real* voffy = new Real[fvc[1].size()];,
-           Real* voffz = new Real[fvc[2].size()];);
-
-    Vector<int> bc     = GetBCArray(bcr);
-    const int* ratioV = ratio.getVect();
-    int slope_flag    = 1;
 
 #if (AMREX_SPACEDIM > 1)
 
-    amrex_linccinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
-                      fblo, fbhi,
-                      AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                      cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
-                      AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
-                      ucc_xsldat, lcc_xsldat, xslfac_dat,
-                      ucc_ysldat, lcc_ysldat, yslfac_dat,
-#if (AMREX_SPACEDIM==3)
-                      ucc_zsldat, lcc_zsldat, zslfac_dat,
-#endif
-                      AMREX_ARLIM(csblo), AMREX_ARLIM(csbhi),
-                      csblo, csbhi,
-                      &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-                      bc.dataPtr(), &slope_flag, &lin_limit,
-                      AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
-                      AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
-                      AMREX_D_DECL(voffx,voffy,voffz),
-                      alpha.dataPtr(),cmax.dataPtr(),cmin.dataPtr(),
-                      &actual_comp,&actual_state);
-
-    AMREX_D_TERM(delete [] voffx;, delete [] voffy;, delete [] voffz;);
+    cell_cons_lin_interp(crse, crse_comp, fine, fine_comp, ncomp,
+                         target_fine_region, cslope_bx, ratio,
+                         crse_geom, fine_geom, bcr, true);
 
 #endif /*(AMREX_SPACEDIM > 1)*/
 }
@@ -768,29 +1048,34 @@ CellConservativeProtected::protect (const FArrayBox& crse,
     Box cs_bx(crse_bx);
     cs_bx.grow(-1);
 
+#if (AMREX_SPACEDIM == 2)
     //
     // Get coarse and fine edge-centered volume coordinates.
     //
-    int dir;
-    Vector<Real> fvc[AMREX_SPACEDIM];
-    Vector<Real> cvc[AMREX_SPACEDIM];
-    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
-    {
-        fine_geom.GetEdgeVolCoord(fvc[dir],target_fine_region,dir);
-        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
-    }
-
-#if (AMREX_SPACEDIM == 2)
     const int* cvcblo = crse_bx.loVect();
     const int* fvcblo = target_fine_region.loVect();
 
     int cvcbhi[AMREX_SPACEDIM];
     int fvcbhi[AMREX_SPACEDIM];
 
+    int dir;
     for (dir=0; dir<AMREX_SPACEDIM; dir++)
     {
-        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
-        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
+        cvcbhi[dir] = cvcblo[dir] + crse_bx.length(dir);
+        fvcbhi[dir] = fvcblo[dir] + target_fine_region.length(dir);
+    }
+
+    Real* fvc[AMREX_SPACEDIM];
+    Real* cvc[AMREX_SPACEDIM];
+    fvc[0] = interp_scratch(target_fine_region.length(0) + target_fine_region.length(1)
+                                  + crse_bx.length(0) + crse_bx.length(1) + 4);
+    fvc[1] = fvc[0] + target_fine_region.length(0) + 1;
+    cvc[0] = fvc[1] + target_fine_region.length(1) + 1;
+    cvc[1] = cvc[0] + crse_bx.length(0) + 1;
+    for (dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        edge_vol_coord(fine_geom,target_fine_region,dir,fvc[dir]);
+        edge_vol_coord(crse_geom,crse_bx,dir,cvc[dir]);
     }
 #endif
 
@@ -819,9 +1104,9 @@ CellConservativeProtected::protect (const FArrayBox& crse,
                          cdat,AMREX_ARLIM(clo),AMREX_ARLIM(chi),
                          csblo, csbhi,
 #if (AMREX_SPACEDIM == 2)
-                         fvc[0].dataPtr(),fvc[1].dataPtr(),
+                         fvc[0],fvc[1],
                          AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
-                         cvc[0].dataPtr(),cvc[1].dataPtr(),
+                         cvc[0],cvc[1],
                          AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
 #endif
                          state_dat, AMREX_ARLIM(slo), AMREX_ARLIM(shi),
@@ -908,18 +1193,20 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
     Vector<int> bc     = GetBCArray(bcr);
     const int* ratioV = ratio.getVect();
 
-    int ltmp = fb2hi[0]-fb2lo[0]+1;
-    Vector<Real> ftmp(ltmp);
-
+    int lftmp = fb2hi[0]-fb2lo[0]+1;
+    int lctmp = 0, lctmp2 = 0;
 #if (AMREX_SPACEDIM >= 2)
-    ltmp = (cbhi[0]-cblo[0]+1)*ratio[1];
-    Vector<Real> ctmp(ltmp);    
-#endif    
-
+    lctmp = (cbhi[0]-cblo[0]+1)*ratio[1];
+#endif
 #if (AMREX_SPACEDIM == 3)
-    ltmp = (cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2];
-    Vector<Real> ctmp2(ltmp);    
-#endif    
+    lctmp2 = (cbhi[0]-cblo[0]+1)*(cbhi[1]-cblo[1]+1)*ratio[2];
+#endif
+
+    Real* ftmp  = interp_scratch(lftmp + lctmp + lctmp2);
+    Real* ctmp  = ftmp + lftmp;
+    Real* ctmp2 = ctmp + lctmp;
+    amrex::ignore_unused(ctmp);
+    amrex::ignore_unused(ctmp2);
 
     amrex_quartinterp (fdat,AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
 		      fblo, fbhi, fb2lo, fb2hi,
@@ -927,7 +1214,7 @@ CellConservativeQuartic::interp (const FArrayBox&  crse,
 		      cblo, cbhi, cb2lo, cb2hi,
 		      &ncomp,
 		      AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
-		      AMREX_D_DECL(ftmp.dataPtr(), ctmp.dataPtr(), ctmp2.dataPtr()),
+		      AMREX_D_DECL(ftmp, ctmp, ctmp2),
 		      bc.dataPtr(),&actual_comp,&actual_state);
 }
 
@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <climits>
+#include <cstring>
 
 #include <AMReX_TagBox.H>
 #include <AMReX_Geometry.H>
@@ -11,6 +12,274 @@
 
 namespace amrex {
 
+namespace {
+
+    int popCount (std::uint64_t x)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(x);
+#else
+        int n = 0;
+        for (; x; x &= x - 1) ++n;
+        return n;
+#endif
+    }
+
+    //
+    // The number of nonzero chars in p[0:n), eight at a time.
+    //
+    long countTags (const TagBox::TagType* p, long n)
+    {
+        const std::uint64_t lo7 = 0x7F7F7F7F7F7F7F7FULL;
+        const std::uint64_t hi1 = 0x8080808080808080ULL;
+        long nt = 0L;
+        long i = 0;
+        for (; i+8 <= n; i += 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p+i, sizeof(w));
+            if (w) {
+                // The high bit of every nonzero byte.
+                nt += popCount((((w & lo7) + lo7) | w) & hi1);
+            }
+        }
+        for (; i < n; ++i) {
+            if (p[i] != TagBox::CLEAR) ++nt;
+        }
+        return nt;
+    }
+
+    //
+    // Floor of i/r.
+    //
+    int crsn (int i, int r)
+    {
+        return (i < 0) ? -((-i-1)/r) - 1 : i/r;
+    }
+}
+
+TagBitMask::TagBitMask (const Box& bx)
+    : m_box(bx)
+{
+    for (int d = 0; d < 3; ++d) {
+        m_lo[d]  = 0;
+        m_len[d] = 1;
+    }
+    if (bx.ok()) {
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            m_lo[d]  = bx.smallEnd(d);
+            m_len[d] = bx.length(d);
+        }
+    } else {
+        m_len[0] = 0;
+    }
+    m_nw = (m_len[0]+63)/64;
+    m_bits.assign(long(m_nw)*m_len[1]*m_len[2], 0);
+}
+
+TagBitMask::TagBitMask (const TagBox& tb, const Box& region, TagBox::TagType minval)
+    : TagBitMask(tb.box())
+{
+    const Box& bx = region & m_box;
+    if (!bx.ok()) return;
+
+    const int* lo = bx.loVect();
+    const int* hi = bx.hiVect();
+    int jlo = 0, jhi = 0, klo = 0, khi = 0;
+    AMREX_D_TERM(,
+                 jlo = lo[1]; jhi = hi[1];,
+                 klo = lo[2]; khi = hi[2];)
+    const int ni = hi[0] - lo[0] + 1;
+    const int ioff = lo[0] - m_lo[0];
+
+    for (int k = klo; k <= khi; ++k) {
+        for (int j = jlo; j <= jhi; ++j) {
+            const TagBox::TagType* p = tb.dataPtr() + m_box.index(IntVect(AMREX_D_DECL(lo[0],j,k)));
+            Word* w = row(j,k);
+            int i = 0;
+            while (i < ni) {
+                if (i+8 <= ni) {
+                    std::uint64_t x;
+                    std::memcpy(&x, p+i, sizeof(x));
+                    if (x == 0) {
+                        i += 8;
+                        continue;
+                    }
+                }
+                if (p[i] >= minval) {
+                    const int b = ioff + i;
+                    w[b/64] |= Word(1) << (b%64);
+                }
+                ++i;
+            }
+        }
+    }
+}
+
+bool
+TagBitMask::test (const IntVect& iv) const
+{
+    BL_ASSERT(m_box.contains(iv));
+    int j = 0, k = 0;
+    AMREX_D_TERM(, j = iv[1];, k = iv[2];)
+    const int b = iv[0] - m_lo[0];
+    return (row(j,k)[b/64] >> (b%64)) & 1;
+}
+
+void
+TagBitMask::set (const IntVect& iv)
+{
+    BL_ASSERT(m_box.contains(iv));
+    int j = 0, k = 0;
+    AMREX_D_TERM(, j = iv[1];, k = iv[2];)
+    const int b = iv[0] - m_lo[0];
+    row(j,k)[b/64] |= Word(1) << (b%64);
+}
+
+void
+TagBitMask::dilateWords (int n)
+{
+    const int nrows = m_len[1]*m_len[2];
+    const int nbits = m_len[0];
+    const Word last = (nbits%64 == 0) ? ~Word(0) : ((Word(1) << (nbits%64)) - 1);
+
+    std::vector<Word> t(m_nw);
+    for (int r = 0; r < nrows; ++r)
+    {
+        Word* w = m_bits.data() + long(r)*m_nw;
+        bool any = false;
+        for (int iw = 0; iw < m_nw; ++iw) any = any || w[iw];
+        if (!any) continue;
+        //
+        // Cells within cover of a set cell are set; double cover at each
+        // step by or-ing the row shifted by up to cover+1 both ways.
+        //
+        for (int cover = 0; cover < n; )
+        {
+            const int s = std::min(cover+1, n-cover);
+            const int q = s/64;
+            const int b = s%64;
+            std::copy(w, w+m_nw, t.begin());
+            for (int iw = 0; iw < m_nw; ++iw)
+            {
+                // toward higher cells
+                if (iw-q >= 0) {
+                    Word x = t[iw-q] << b;
+                    if (b > 0 && iw-q-1 >= 0) x |= t[iw-q-1] >> (64-b);
+                    w[iw] |= x;
+                }
+                // toward lower cells
+                if (iw+q < m_nw) {
+                    Word x = t[iw+q] >> b;
+                    if (b > 0 && iw+q+1 < m_nw) x |= t[iw+q+1] << (64-b);
+                    w[iw] |= x;
+                }
+            }
+            w[m_nw-1] &= last;
+            cover += s;
+        }
+    }
+}
+
+void
+TagBitMask::dilateRows (int dir, int n)
+{
+    //
+    // Rows along dir are stride words apart; there are cnt of them in
+    // each of the nblk blocks.
+    //
+    const long stride = (dir == 1) ? m_nw : long(m_nw)*m_len[1];
+    const int  cnt    = m_len[dir];
+    const long nblk   = long(m_bits.size()) / (stride*cnt);
+
+    std::vector<Word> t;
+    for (int cover = 0; cover < n; )
+    {
+        const int s = std::min(cover+1, n-cover);
+        t = m_bits;
+        for (long blk = 0; blk < nblk; ++blk)
+        {
+            Word*       a = m_bits.data() + blk*stride*cnt;
+            const Word* b = t.data()      + blk*stride*cnt;
+            for (int p = 0; p < cnt; ++p)
+            {
+                Word* ap = a + p*stride;
+                if (p-s >= 0) {
+                    const Word* bp = b + (p-s)*stride;
+                    for (long w = 0; w < stride; ++w) ap[w] |= bp[w];
+                }
+                if (p+s < cnt) {
+                    const Word* bp = b + (p+s)*stride;
+                    for (long w = 0; w < stride; ++w) ap[w] |= bp[w];
+                }
+            }
+        }
+        cover += s;
+    }
+}
+
+void
+TagBitMask::dilate (int n)
+{
+    if (n <= 0 || m_bits.empty()) return;
+
+    dilateWords(n);
+#if (AMREX_SPACEDIM > 1)
+    dilateRows(1, n);
+#endif
+#if (AMREX_SPACEDIM > 2)
+    dilateRows(2, n);
+#endif
+}
+
+TagBitMask
+TagBitMask::coarsen (const IntVect& ratio) const
+{
+    TagBitMask c(amrex::coarsen(m_box, ratio));
+    if (m_bits.empty()) return c;
+
+    int ry = 1, rz = 1;
+    AMREX_D_TERM(, ry = ratio[1];, rz = ratio[2];)
+    const int rx = ratio[0];
+
+    for (int k = 0; k < m_len[2]; ++k)
+    {
+        const int kc = crsn(m_lo[2]+k, rz);
+        for (int j = 0; j < m_len[1]; ++j)
+        {
+            const int jc = crsn(m_lo[1]+j, ry);
+            const Word* w = row(m_lo[1]+j, m_lo[2]+k);
+            Word* cw = c.row(jc, kc);
+            for (int iw = 0; iw < m_nw; ++iw)
+            {
+                Word x = w[iw];
+                while (x) {
+                    const int b = iw*64 + lowBit(x);
+                    const int ic = crsn(m_lo[0]+b, rx) - c.m_lo[0];
+                    cw[ic/64] |= Word(1) << (ic%64);
+                    // Skip the other fine cells of the same coarse cell.
+                    const int bnext = (ic + c.m_lo[0] + 1)*rx - m_lo[0];
+                    if (bnext >= (iw+1)*64) {
+                        x = 0;
+                    } else {
+                        x &= ~Word(0) << (bnext - iw*64);
+                    }
+                }
+            }
+        }
+    }
+    return c;
+}
+
+long
+TagBitMask::count () const
+{
+    long n = 0L;
+    for (Word w : m_bits) {
+        if (w) n += popCount(w);
+    }
+    return n;
+}
+
 TagBox::TagBox () {}
 
 TagBox::TagBox (const Box& bx,
@@ -28,77 +297,81 @@ TagBox::coarsen (const IntVect& ratio, bool owner)
 {
     BL_ASSERT(nComp() == 1);
 
-    TagType*   fdat     = dataPtr();
-    IntVect    lov      = domain.smallEnd();
-    IntVect    hiv      = domain.bigEnd();
-    IntVect    d_length = domain.size();
-    const int* flo      = lov.getVect();
-    const int* fhi      = hiv.getVect();
-    const int* flen     = d_length.getVect();
-
     const Box& cbox = amrex::coarsen(domain,ratio);
 
-    this->resize(cbox);
-
-    if (!owner) return;
-
-    const int* clo      = cbox.loVect();
-    IntVect    cbox_len = cbox.size();
-    const int* clen     = cbox_len.getVect();
-
-    Box b1(amrex::refine(cbox,ratio));
-    const int* lo       = b1.loVect();
-    int        longlen  = b1.longside();
+    if (!owner) {
+        this->resize(cbox);
+        return;
+    }
 
-    Vector<TagType> cfab(numpts);
+    const int* flo = domain.loVect();
+    const int* fhi = domain.hiVect();
+    const int* clo = cbox.loVect();
+    int klo = 0, khi = 0, jlo = 0, jhi = 0;
+    AMREX_D_TERM(,
+                 jlo = flo[1]; jhi = fhi[1];,
+                 klo = flo[2]; khi = fhi[2];)
+    int ratioy = 1, ratioz = 1;
+    AMREX_D_TERM(,
+                 ratioy = ratio[1];,
+                 ratioz = ratio[2];)
+    const int ratiox = ratio[0];
+    const int ni = domain.length(0);
+    // Fine cell i of a row is in coarse cell (i+ioff)/ratiox of its row.
+    const int ioff = flo[0] - clo[0]*ratiox;
+
+    Vector<TagType> cfab(cbox.numPts(), TagBox::CLEAR);
     TagType* cdat = cfab.dataPtr();
+    const TagType* fdat = dataPtr();
+    //
+    // A coarse cell gets the largest tag of the fine cells it covers.
+    // Eight fine cells at a time are skipped if none of them is tagged.
+    //
+    for (int k = klo; k <= khi; k++)
+    {
+        const int kc = crsn(k,ratioz);
+        for (int j = jlo; j <= jhi; j++)
+        {
+            const int jc = crsn(j,ratioy);
+            TagType*       c = cdat + cbox.index(IntVect(AMREX_D_DECL(clo[0],jc,kc)));
+            const TagType* f = fdat + domain.index(IntVect(AMREX_D_DECL(flo[0],j,k)));
+            int i = 0;
+            while (i < ni)
+            {
+                if (i+8 <= ni) {
+                    std::uint64_t w;
+                    std::memcpy(&w, f+i, sizeof(w));
+                    if (w == 0) {
+                        i += 8;
+                        continue;
+                    }
+                }
+                //
+                // Through the coarse cell with the end of these eight.
+                //
+                const int istop = std::min(i+8, ni);
+                int ic   = (i+ioff)/ratiox;
+                int iend = std::min((ic+1)*ratiox - ioff, ni);
+                while (i < istop)
+                {
+                    TagType m = c[ic];
+                    for ( ; i < iend; ++i) {
+                        m = std::max(m, f[i]);
+                    }
+                    c[ic] = m;
+                    ++ic;
+                    iend = std::min(iend+ratiox, ni);
+                }
+            }
+        }
+    }
+
+    this->resize(cbox);
 
-    Vector<TagType> t(longlen,TagBox::CLEAR);
-
-    int klo = 0, khi = 0, jlo = 0, jhi = 0, ilo, ihi;
-    AMREX_D_TERM(ilo=flo[0]; ihi=fhi[0]; ,
-           jlo=flo[1]; jhi=fhi[1]; ,
-           klo=flo[2]; khi=fhi[2];)
-
-#define IXPROJ(i,r) (((i)+(r)*std::abs(i))/(r) - std::abs(i))
-#define IOFF(j,k,lo,len) AMREX_D_TERM(0, +(j-lo[1])*len[0], +(k-lo[2])*len[0]*len[1])
-   
-   int ratiox = 1, ratioy = 1, ratioz = 1;
-   AMREX_D_TERM(ratiox = ratio[0];,
-          ratioy = ratio[1];,
-          ratioz = ratio[2];)
-
-   for (int k = klo; k <= khi; k++)
-   {
-       const int kc = IXPROJ(k,ratioz);
-       for (int j = jlo; j <= jhi; j++)
-       {
-           const int     jc = IXPROJ(j,ratioy);
-           TagType*       c = cdat + IOFF(jc,kc,clo,clen);
-           const TagType* f = fdat + IOFF(j,k,flo,flen);
-           //
-           // Copy fine grid row of values into tmp array.
-           //
-           for (int i = ilo; i <= ihi; i++)
-               t[i-lo[0]] = f[i-ilo];
-
-           for (int off = 0; off < ratiox; off++)
-           {
-               for (int ic = 0; ic < clen[0]; ic++)
-               {
-                   const int i = ic*ratiox + off;
-                   c[ic] = std::max(c[ic],t[i]);
-               }
-           }
-       }
-   }
-
-#undef IXPROJ
-#undef IOFF
-
-   for (int i = 0; i < numpts; ++i) {
-       fdat[i] = cdat[i];
-   }
+    TagType* d = dataPtr();
+    for (long i = 0, N = cfab.size(); i < N; ++i) {
+        d[i] = cdat[i];
+    }
 }
 
 void 
@@ -111,48 +384,34 @@ TagBox::buffer (int nbuff,
     //
     Box inside(domain);
     inside.grow(-nwid);
-    const int* inlo = inside.loVect();
-    const int* inhi = inside.hiVect();
-    int klo = 0, khi = 0, jlo = 0, jhi = 0, ilo, ihi;
-    AMREX_D_TERM(ilo=inlo[0]; ihi=inhi[0]; ,
-           jlo=inlo[1]; jhi=inhi[1]; ,
-           klo=inlo[2]; khi=inhi[2];)
+    if (!inside.ok()) return;
+
+    TagBitMask mask(*this, inside, TagBox::SET);
+    mask.dilate(nbuff);
 
-    IntVect d_length = domain.size();
-    const int* len = d_length.getVect();
-    const int* lo = domain.loVect();
-    int ni = 0, nj = 0, nk = 0;
-    AMREX_D_TERM(ni, =nj, =nk) = nbuff;
     TagType* d = dataPtr();
+    mask.forEach([d] (const IntVect&, long n)
+    {
+        if (d[n] != TagBox::SET) d[n] = TagBox::BUF;
+    });
+}
 
-#define OFF(i,j,k,lo,len) AMREX_D_TERM(i-lo[0], +(j-lo[1])*len[0] , +(k-lo[2])*len[0]*len[1])
-   
-    for (int k = klo; k <= khi; k++)
+void
+TagBox::setTags (const TagBitMask& mask)
+{
+    TagType* d = dataPtr();
+    if (mask.box() == domain)
     {
-        for (int j = jlo; j <= jhi; j++)
+        mask.forEach([d] (const IntVect&, long n) { d[n] = TagBox::SET; });
+    }
+    else
+    {
+        const Box& dom = domain;
+        mask.forEach([d,&dom] (const IntVect& iv, long)
         {
-            for (int i = ilo; i <= ihi; i++)
-            {
-                TagType* d_check = d + OFF(i,j,k,lo,len);
-                if (*d_check == TagBox::SET)
-                {
-                    for (int kk = -nk; kk <= nk; kk++)
-                    {
-                        for (int jj = -nj; jj <= nj; jj++)
-                        {
-                            for (int ii = -ni; ii <= ni; ii++)
-                            {
-                                TagType* dn = d_check+ AMREX_D_TERM(ii, +jj*len[0], +kk*len[0]*len[1]);
-                                if (*dn !=TagBox::SET)
-                                    *dn = TagBox::BUF;
-                            }
-                        }
-                    }
-                }
-            }
-        }
+            if (dom.contains(iv)) d[dom.index(iv)] = TagBox::SET;
+        });
     }
-#undef OFF
 }
 
 void 
@@ -205,23 +464,30 @@ TagBox::merge (const TagBox& src)
 long
 TagBox::numTags () const
 {
-    long nt = 0L;
-    long len = domain.numPts();
-    const TagType* d = dataPtr();
-    for (long n = 0; n < len; ++n)
-    {
-	if (d[n] != TagBox::CLEAR)
-	    ++nt;
-    }
-    return nt;
+    return countTags(dataPtr(), domain.numPts());
 }
 
 long
 TagBox::numTags (const Box& b) const
 {
-   TagBox tempTagBox(b,1);
-   tempTagBox.copy(*this);
-   return tempTagBox.numTags();
+    const Box& bx = b & domain;
+    if (!bx.ok()) return 0L;
+
+    const int* lo = bx.loVect();
+    const int* hi = bx.hiVect();
+    int jlo = 0, jhi = 0, klo = 0, khi = 0;
+    AMREX_D_TERM(,
+                 jlo = lo[1]; jhi = hi[1];,
+                 klo = lo[2]; khi = hi[2];)
+
+    long nt = 0L;
+    for (int k = klo; k <= khi; ++k) {
+        for (int j = jlo; j <= jhi; ++j) {
+            const TagType* p = dataPtr() + domain.index(IntVect(AMREX_D_DECL(lo[0],j,k)));
+            nt += countTags(p, bx.length(0));
+        }
+    }
+    return nt;
 }
 
 long
@@ -230,7 +496,8 @@ TagBox::collate (Vector<IntVect>& ar, int start) const
     BL_ASSERT(start >= 0);
     //
     // Starting at given offset of array ar, enter location (IntVect) of
-    // each tagged cell in tagbox.
+    // each tagged cell in tagbox.  Eight cells at a time are skipped if
+    // none of them is tagged.
     //
     long count       = 0;
     IntVect d_length = domain.size();
@@ -244,14 +511,24 @@ TagBox::collate (Vector<IntVect>& ar, int start) const
     {
         for (int j = 0; j < nj; j++)
         {
-            for (int i = 0; i < ni; i++)
+            const TagType* dn = d + AMREX_D_TERM(0, +j*len[0], +k*len[0]*len[1]);
+            int i = 0;
+            while (i < ni)
             {
-                const TagType* dn = d + AMREX_D_TERM(i, +j*len[0], +k*len[0]*len[1]);
-                if (*dn != TagBox::CLEAR)
+                if (i+8 <= ni) {
+                    std::uint64_t w;
+                    std::memcpy(&w, dn+i, sizeof(w));
+                    if (w == 0) {
+                        i += 8;
+                        continue;
+                    }
+                }
+                if (dn[i] != TagBox::CLEAR)
                 {
                     ar[start++] = IntVect(AMREX_D_DECL(lo[0]+i,lo[1]+j,lo[2]+k));
                     count++;
                 }
+                ++i;
             }
         }
     }
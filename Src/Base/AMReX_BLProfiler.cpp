@@ -34,6 +34,7 @@ bool BLProfiler::groupSets = false;
 bool BLProfiler::bFirstCommWrite = true;  // header
 bool BLProfiler::bInitialized = false;
 bool BLProfiler::bFlushPrint = true;
+bool BLProfiler::bChromeTrace = false;
 
 const int defaultFlushSize = 8192000;
 const int defaultReserveSize = 8192000;
@@ -112,6 +113,90 @@ Real BLProfiler::CallStats::maxCallTime(-1.0);
 #endif
 
 
+namespace {
+  // ---- chrome trace event tracks, one set per process
+  const int chromeCallTid(0);
+  const int chromeCommTid(1);
+  const int chromeRegionTid(2);
+  const std::string chromeTracePrefix("bl_trace_events");
+
+  bool bFirstChromeWrite(true);
+  // ---- message counts used to pair sends and receives
+  std::map<std::pair<int,int>, long> chromeSendSeq;     // [(dst, tag), nsent]
+  std::map<std::pair<int,int>, long> chromeRecvSeq;     // [(src, tag), nreceived]
+  std::map<std::pair<int,int>, long> chromePendingRecv; // [(src or -1, tag), nposted]
+
+  std::string JsonString(const std::string &str) {
+    std::string res("\"");
+    for(std::size_t i(0); i < str.size(); ++i) {
+      const char c(str[i]);
+      if(c == '"' || c == '\\') {
+        res += '\\';
+        res += c;
+      } else if(static_cast<unsigned char>(c) < 0x20) {
+        res += ' ';
+      } else {
+        res += c;
+      }
+    }
+    res += '"';
+    return res;
+  }
+
+  // ---- times are in seconds, chrome wants microseconds
+  void ChromeEvent(std::ostream &os, const std::string &name, const char *cat,
+                   const char *ph, int pid, int tid, Real ts)
+  {
+    os << "{\"name\":" << JsonString(name) << ",\"cat\":\"" << cat
+       << "\",\"ph\":\"" << ph << "\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"ts\":" << ts * 1.0e6;
+  }
+
+  // ---- the flow id is the same on the sending and the receiving process
+  // ---- because MPI does not let messages with the same (src, dst, tag) overtake
+  std::string ChromeFlowId(int src, int dst, int tag, long seq) {
+    std::ostringstream id;
+    id << src << '.' << dst << '.' << tag << '.' << seq;
+    return JsonString(id.str());
+  }
+
+  void ChromeFlow(std::ostream &os, const char *ph, int pid, Real ts,
+                  int src, int dst, int tag, long seq)
+  {
+    ChromeEvent(os, "message", "comm", ph, pid, chromeCommTid, ts);
+    os << ",\"id\":" << ChromeFlowId(src, dst, tag, seq);
+    if(ph[0] == 'f') {
+      os << ",\"bp\":\"e\"";
+    }
+    os << "},\n";
+  }
+
+  // ---- a completed receive from src.  receives completed by a wait are
+  // ---- only counted if a matching receive was posted, since the statuses
+  // ---- of completed sends are not meaningful
+  void ChromeRecvDone(std::ostream &os, int myProc, int src, int tag, Real ts,
+                      bool bNeedPost)
+  {
+    if(src < 0) {
+      return;
+    }
+    if(bNeedPost) {
+      std::map<std::pair<int,int>, long>::iterator it =
+                                 chromePendingRecv.find(std::make_pair(src, tag));
+      if(it == chromePendingRecv.end() || it->second == 0) {
+        it = chromePendingRecv.find(std::make_pair(-1, tag));
+      }
+      if(it == chromePendingRecv.end() || it->second == 0) {
+        return;
+      }
+      --(it->second);
+    }
+    long seq(chromeRecvSeq[std::make_pair(src, tag)]++);
+    ChromeFlow(os, "f", myProc, ts, src, myProc, tag, seq);
+  }
+}
+
+
 BLProfiler::BLProfiler(const std::string &funcname)
     : bltstart(0.0), bltelapsed(0.0)
     , fname(funcname)
@@ -278,6 +363,7 @@ void BLProfiler::InitParams() {
   pParse.query("prof_flushinterval", flushInterval);
   pParse.query("prof_flushtimeinterval", flushTimeInterval);
   pParse.query("prof_flushprint", bFlushPrint);
+  pParse.query("prof_chrome_trace", bChromeTrace);
 #if 0
   amrex::Print() << "PPPPPPPP::  nProfFiles         = " << nProfFiles << '\n';
   amrex::Print() << "PPPPPPPP::  csFlushSize        = " << csFlushSize << '\n';
@@ -493,6 +579,10 @@ void BLProfiler::Finalize(bool bFlushing, bool memCheck) {
   WriteCommStats(bFlushing, memCheck);
 #endif
 
+  if(bChromeTrace && ! bFlushing && ! bFirstChromeWrite) {
+    WriteChromeTraceFile();
+  }
+
   WriteFortProfErrors();
 #ifdef AMREX_DEBUG
 #else
@@ -1104,6 +1194,74 @@ void BLProfiler::WriteCallTrace(bool bFlushing, bool memCheck) {   // ---- write
     }
 
 
+    if(bChromeTrace) {  // ---- the same data as chrome trace events
+      std::ostringstream events;
+      events << std::fixed << std::setprecision(3);
+
+      Vector<std::string> fNames(mFNameNumbers.size());
+      for(std::map<std::string, int>::iterator it = mFNameNumbers.begin();
+          it != mFNameNumbers.end(); ++it)
+      {
+        fNames[it->second] = it->first;
+      }
+      Vector<std::string> rNames(mRegionNameNumbers.size());
+      for(std::map<std::string, int>::iterator it = mRegionNameNumbers.begin();
+          it != mRegionNameNumbers.end(); ++it)
+      {
+        rNames[it->second] = it->first;
+      }
+
+      for(int i(0); i < rStartStop.size(); ++i) {
+        const RStartStop &rss = rStartStop[i];
+        if(rss.rssRNumber < 0 || rss.rssRNumber >= rNames.size() ||
+           rNames[rss.rssRNumber] == noRegionName)
+        {
+          continue;
+        }
+        ChromeEvent(events, rNames[rss.rssRNumber], "region", rss.rssStart ? "B" : "E",
+                    myProc, chromeRegionTid, rss.rssTime);
+        events << "},\n";
+      }
+
+      // ---- calls that have not returned yet get a begin event here
+      // ---- and an end event when they are patched
+      std::set<int> openCalls;
+      for(int ci(0); ci < callIndexStack.size(); ++ci) {
+        if( ! callIndexStack[ci].bFlushed) {
+          openCalls.insert(callIndexStack[ci].index);
+        }
+      }
+      for(int i(0); i < vCallTrace.size(); ++i) {
+        const CallStats &cs = vCallTrace[i];
+        if(cs.csFNameNumber < 0 || cs.csFNameNumber >= fNames.size()) {
+          continue;
+        }
+        if(openCalls.find(i) != openCalls.end()) {
+          ChromeEvent(events, fNames[cs.csFNameNumber], "call", "B",
+                      myProc, chromeCallTid, cs.callTime);
+        } else {
+          ChromeEvent(events, fNames[cs.csFNameNumber], "call", "X",
+                      myProc, chromeCallTid, cs.callTime);
+          events << ",\"dur\":" << cs.totalTime * 1.0e6
+                 << ",\"args\":{\"exclusive_us\":" << cs.stackTime * 1.0e6 << '}';
+        }
+        events << "},\n";
+      }
+      if( ! bFlushing) {
+        for(int ci(0); ci < callIndexPatch.size(); ++ci) {
+          const CallStats &cs = callIndexPatch[ci].callStats;
+          if(cs.totalTime > 0.0 && cs.csFNameNumber >= 0 && cs.csFNameNumber < fNames.size()) {
+            ChromeEvent(events, fNames[cs.csFNameNumber], "call", "E",
+                        myProc, chromeCallTid, cs.callTime + cs.totalTime);
+            events << "},\n";
+          }
+        }
+      }
+
+      WriteChromeTraceEvents(events.str());
+    }
+
+
     if(bFlushing) {  // ---- save stacked CallStats
       for(int ci(0); ci < callIndexStack.size(); ++ci) {
 	CallStatsStack &csStack = callIndexStack[ci];
@@ -1206,6 +1364,97 @@ void BLProfiler::WriteCommStats(bool bFlushing, bool memCheck) {
   const int   nProcs    = ParallelDescriptor::NProcs();
   const int   nOutFiles = std::max(1, std::min(nProcs, nProfFiles));
 
+  if(bChromeTrace) {  // ---- the same data as chrome trace events
+    // ---- most calls add a CommStats before and one after the mpi call.
+    // ---- these become one slice.  waits add one after the call for each
+    // ---- completed request.  sends get flow arrows to the waits or
+    // ---- receives that complete them on the other process.
+    std::ostringstream events;
+    events << std::fixed << std::setprecision(3);
+
+    std::map<int, std::string> barrierIndexNames;  // [seekindex, name]
+    for(int ib(0); ib < CommStats::barrierNames.size(); ++ib) {
+      barrierIndexNames[CommStats::barrierNames[ib].second] = CommStats::barrierNames[ib].first;
+    }
+
+    int openIndex(-1);
+    CommFuncType lastCFT(InvalidCFT);
+    Real lastMidTime(0.0);
+    for(int ics(0); ics <= vCommStats.size(); ++ics) {
+      const bool bEnd(ics == vCommStats.size());
+      const CommStats *cs = bEnd ? 0 : &vCommStats[ics];
+      const CommFuncType cft(bEnd ? InvalidCFT : cs->cfType);
+      const bool bBefore( ! bEnd && (cs->size == BeforeCall() || cs->commpid == BeforeCall()));
+      const bool bWait(cft == Wait || cft == Waitall || cft == Waitany || cft == Waitsome);
+
+      if( ! bEnd && (cft == TagWrap)) {
+        continue;
+      }
+      if( ! bEnd && (cft == NameTag)) {
+        if(cs->tag >= 0 && cs->tag < CommStats::nameTagNames.size()) {
+          ChromeEvent(events, CommStats::nameTagNames[cs->tag], "comm", "i",
+                      myProc, chromeCommTid, cs->timeStamp);
+          events << ",\"s\":\"t\"},\n";
+        }
+        continue;
+      }
+
+      if( ! bBefore && openIndex >= 0 && vCommStats[openIndex].cfType == cft) {
+        // ---- the end of the open call
+        const CommStats &csb = vCommStats[openIndex];
+        std::string name(CommStats::CFTToString(cft));
+        std::map<int, std::string>::iterator bit = barrierIndexNames.find(openIndex);
+        if(bit != barrierIndexNames.end()) {
+          name += "  " + bit->second;
+        }
+        const int size(std::max(csb.size, cs->size));
+        const int cpid(csb.commpid >= 0 ? csb.commpid : cs->commpid);
+        const int tag(csb.tag >= 0 ? csb.tag : cs->tag);
+        ChromeEvent(events, name, "comm", "X", myProc, chromeCommTid, csb.timeStamp);
+        events << ",\"dur\":" << (cs->timeStamp - csb.timeStamp) * 1.0e6
+               << ",\"args\":{\"size\":" << size << ",\"pid\":" << cpid
+               << ",\"tag\":" << tag << "}},\n";
+
+        lastCFT = cft;
+        lastMidTime = 0.5 * (csb.timeStamp + cs->timeStamp);
+
+        if(cft == AsendTsii || cft == AsendTsiiM || cft == AsendvTii ||
+           cft == SendTsii  || cft == SendvTii)
+        {
+          if(csb.commpid >= 0) {
+            long seq(chromeSendSeq[std::make_pair(csb.commpid, csb.tag)]++);
+            ChromeFlow(events, "s", myProc, lastMidTime, myProc, csb.commpid, csb.tag, seq);
+          }
+        } else if(cft == ArecvTsii || cft == ArecvTsiiM || cft == ArecvTii || cft == ArecvvTii) {
+          ++chromePendingRecv[std::make_pair(std::max(csb.commpid, -1), csb.tag)];
+        } else if(cft == RecvTsii || cft == RecvvTii) {
+          ChromeRecvDone(events, myProc, cs->commpid, cs->tag, lastMidTime, false);
+        } else if(bWait && cs->size >= 0) {
+          ChromeRecvDone(events, myProc, cs->commpid, cs->tag, lastMidTime, true);
+        }
+        openIndex = -1;
+
+      } else if( ! bBefore && openIndex < 0 && bWait && lastCFT == cft) {
+        // ---- another request completed by the last wait
+        if(cs->size >= 0) {
+          ChromeRecvDone(events, myProc, cs->commpid, cs->tag, lastMidTime, true);
+        }
+
+      } else {
+        if(openIndex >= 0) {  // ---- never ended, just mark it
+          const CommStats &csb = vCommStats[openIndex];
+          ChromeEvent(events, CommStats::CFTToString(csb.cfType), "comm", "i",
+                      myProc, chromeCommTid, csb.timeStamp);
+          events << ",\"s\":\"t\"},\n";
+        }
+        openIndex = bEnd ? -1 : ics;
+        lastCFT = InvalidCFT;
+      }
+    }
+
+    WriteChromeTraceEvents(events.str());
+  }
+
   // ---- write the global header
   if(ParallelDescriptor::IOProcessor() && bFirstCommWrite) {
     std::string globalHeaderFileName(cdir + '/' + commprofPrefix + "_H");
@@ -1336,6 +1585,86 @@ void BLProfiler::WriteCommStats(bool bFlushing, bool memCheck) {
 }
 
 
+void BLProfiler::WriteChromeTraceEvents(const std::string &events) {
+  // ---- append this process's events to its nfiles data file
+  std::string cdir(blProfDirName);
+  const int   nProcs    = ParallelDescriptor::NProcs();
+  const int   nOutFiles = std::max(1, std::min(nProcs, nProfFiles));
+  std::string longDFileNamePrefix(cdir + '/' + chromeTracePrefix + "_D_");
+
+  if( ! blProfDirCreated) {
+    amrex::UtilCreateCleanDirectory(cdir);
+    blProfDirCreated = true;
+  }
+
+  bool setBuf(true);
+  bool appendFirstFile( ! bFirstChromeWrite);
+  bFirstChromeWrite = false;
+
+  NFilesIter nfiDatafile(nOutFiles, longDFileNamePrefix, groupSets, setBuf);
+  for( ; nfiDatafile.ReadyToWrite(appendFirstFile); ++nfiDatafile) {
+    nfiDatafile.Stream().write(events.data(), events.size());
+  }
+}
+
+
+void BLProfiler::WriteChromeTraceFile() {
+  // ---- combine the data files into one json array that can be loaded
+  // ---- into chrome://tracing or ui.perfetto.dev.  each process is a
+  // ---- track group with a track each for calls, comm, and regions.
+  Real wctfStart(amrex::second());
+  std::string cdir(blProfDirName);
+  const int   nProcs    = ParallelDescriptor::NProcs();
+  const int   nOutFiles = std::max(1, std::min(nProcs, nProfFiles));
+  std::string longDFileNamePrefix(cdir + '/' + chromeTracePrefix + "_D_");
+
+  ParallelDescriptor::Barrier("BLProfiler::WriteChromeTraceFile");
+
+  if(ParallelDescriptor::IOProcessor()) {
+    std::string traceFileName(cdir + '/' + chromeTracePrefix + ".json");
+    std::ofstream traceFile;
+    traceFile.open(traceFileName.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if( ! traceFile.good()) {
+      amrex::FileOpenFailed(traceFileName);
+    }
+    traceFile << "[\n";
+
+    std::set<std::string> dFileNames;
+    for(int i(0); i < nProcs; ++i) {
+      dFileNames.insert(NFilesIter::FileName(nOutFiles, longDFileNamePrefix, i, groupSets));
+    }
+    for(std::set<std::string>::iterator it = dFileNames.begin(); it != dFileNames.end(); ++it) {
+      std::ifstream dFile(it->c_str(), std::ios::in | std::ios::binary);
+      if(dFile.good() && dFile.peek() != std::ifstream::traits_type::eof()) {
+        traceFile << dFile.rdbuf();
+      }
+      dFile.close();
+      amrex::UnlinkFile(*it);
+    }
+
+    const char *threadNames[3] = { "calls", "comm", "regions" };
+    for(int i(0); i < nProcs; ++i) {
+      std::ostringstream pname;
+      pname << "Rank " << i;
+      traceFile << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << i
+                << ",\"tid\":0,\"args\":{\"name\":" << JsonString(pname.str()) << "}},\n";
+      traceFile << "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << i
+                << ",\"tid\":0,\"args\":{\"sort_index\":" << i << "}},\n";
+      for(int t(0); t < 3; ++t) {
+        traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << i
+                  << ",\"tid\":" << t << ",\"args\":{\"name\":\"" << threadNames[t] << "\"}}"
+                  << ((i == nProcs - 1 && t == 2) ? "\n" : ",\n");
+      }
+    }
+    traceFile << "]\n";
+    traceFile.close();
+  }
+
+  amrex::Print() << "BLProfiler::WriteChromeTraceFile():  time:  "
+                 << amrex::second() - wctfStart << "\n";
+}
+
+
 void BLProfiler::WriteFortProfErrors() {
   // report any fortran errors.  should really check with all procs, just iop for now
   if(ParallelDescriptor::IOProcessor()) {
@@ -5,6 +5,9 @@
 #include <AMReX_Utility.H>
 #include <AMReX_MFIter.H>
 #include <AMReX_BaseFab.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
 
 #ifdef BL_MEM_PROFILING
 #include <AMReX_MemProfiler.H>
@@ -28,8 +31,156 @@ long BARef::total_hash_bytes_hwm = 0L;
 bool    BARef::initialized = false;
 bool BoxArray::initialized = false;
 
+int BARef::use_tree = 0;
+
+const int BoxTree::fanout;
+
 namespace {
     const int bl_ignore_max = 100000;
+    //
+    // The tree is used when the hash bins hold on average more boxes than this.
+    //
+    const std::size_t tree_min_bin_size = 4;
+}
+
+void
+BoxTree::build (const Vector<Box>& boxes, const std::vector<int>& a_order)
+{
+    clear();
+
+    const int N = a_order.size();
+    if (N == 0) return;
+
+    order = a_order;
+    //
+    // Morton keys of the box centers (times two), with as many bits per
+    // direction as fit in 64 bits.
+    //
+    IntVect cmin = boxes[order[0]].smallEnd() + boxes[order[0]].bigEnd();
+    IntVect cmax = cmin;
+    for (int r = 0; r < N; ++r) {
+        const Box& b = boxes[order[r]];
+        const IntVect c = b.smallEnd() + b.bigEnd();
+        cmin.min(c);
+        cmax.max(c);
+    }
+    const int nbits = 63 / AMREX_SPACEDIM;
+    int shift = 0;
+    while (((long)(cmax - cmin).max() >> shift) >= (1L << nbits)) {
+        ++shift;
+    }
+
+    std::vector<std::pair<unsigned long long,int> > keys(N);
+    for (int r = 0; r < N; ++r)
+    {
+        const Box& b = boxes[order[r]];
+        const IntVect c = b.smallEnd() + b.bigEnd() - cmin;
+        unsigned long long key = 0;
+        for (int bit = 0; bit < nbits; ++bit) {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                key |= (((unsigned long long)c[d] >> (bit+shift)) & 1ULL) << (bit*AMREX_SPACEDIM+d);
+            }
+        }
+        keys[r] = std::make_pair(key,r);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    const int nb = 2*AMREX_SPACEDIM;
+
+    perm.resize(N);
+    bnd.resize(1);
+    bnd[0].resize(N*nb);
+    for (int k = 0; k < N; ++k)
+    {
+        perm[k] = keys[k].second;
+        const Box& b = boxes[order[perm[k]]];
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            bnd[0][k*nb+d]                = b.smallEnd(d);
+            bnd[0][k*nb+AMREX_SPACEDIM+d] = b.bigEnd(d);
+        }
+    }
+
+    while (bnd.back().size() > fanout*nb)
+    {
+        const std::vector<int>& below = bnd.back();
+        const int nbelow = below.size() / nb;
+        const int nabove = (nbelow+fanout-1)/fanout;
+        std::vector<int> above(nabove*nb);
+        for (int j = 0; j < nabove; ++j)
+        {
+            const int kbeg = j*fanout;
+            const int kend = std::min(kbeg+fanout, nbelow);
+            for (int d = 0; d < nb; ++d) {
+                above[j*nb+d] = below[kbeg*nb+d];
+            }
+            for (int k = kbeg+1; k < kend; ++k) {
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                    above[j*nb+d] = std::min(above[j*nb+d], below[k*nb+d]);
+                    above[j*nb+AMREX_SPACEDIM+d] = std::max(above[j*nb+AMREX_SPACEDIM+d],
+                                                            below[k*nb+AMREX_SPACEDIM+d]);
+                }
+            }
+        }
+        bnd.push_back(std::move(above));
+    }
+}
+
+void
+BoxTree::clear ()
+{
+    std::vector<int>().swap(order);
+    std::vector<int>().swap(perm);
+    std::vector< std::vector<int> >().swap(bnd);
+}
+
+long
+BoxTree::bytes () const
+{
+    long b = amrex::bytesOf(order) + amrex::bytesOf(perm);
+    for (const auto& x : bnd) {
+        b += amrex::bytesOf(x);
+    }
+    return b;
+}
+
+void
+BoxTree::query (const IntVect& lo, const IntVect& hi, std::vector<int>& hits) const
+{
+    if (empty()) return;
+
+    const int nb = 2*AMREX_SPACEDIM;
+    //
+    // Depth-first, with the nodes still to visit on a stack of (level, node).
+    //
+    std::pair<int,int> stack[fanout*64];
+    int nstack = 0;
+
+    const int top = bnd.size() - 1;
+    for (int j = bnd[top].size()/nb - 1; j >= 0; --j) {
+        stack[nstack++] = std::make_pair(top,j);
+    }
+
+    while (nstack > 0)
+    {
+        const int level = stack[--nstack].first;
+        const int j     = stack[  nstack].second;
+        const int* b = &bnd[level][j*nb];
+        bool overlap = true;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            overlap = overlap && b[d] <= hi[d] && b[AMREX_SPACEDIM+d] >= lo[d];
+        }
+        if (!overlap) continue;
+
+        if (level == 0) {
+            hits.push_back(perm[j]);
+        } else {
+            const int kbeg = j*fanout;
+            const int kend = std::min(kbeg+fanout, int(bnd[level-1].size()/nb));
+            for (int k = kend-1; k >= kbeg; --k) {
+                stack[nstack++] = std::make_pair(level-1,k);
+            }
+        }
+    }
 }
 
 BARef::BARef () 
@@ -181,6 +332,7 @@ BARef::resize (long n) {
 #endif
     m_abox.resize(n);
     hash.clear();
+    tree.clear();
     has_hashmap = false;
 #ifdef BL_MEM_PROFILING
     updateMemoryUsage_box(1);
@@ -209,7 +361,7 @@ void
 BARef::updateMemoryUsage_hash (int s)
 {
     if (hash.size() > 0) {
-	long b = sizeof(hash);
+	long b = sizeof(hash) + tree.bytes();
 	for (const auto& x: hash) {
 	    b += amrex::gcc_map_node_extra_bytes
 		+ sizeof(IntVect) + amrex::bytesOf(x.second);
@@ -229,6 +381,9 @@ BARef::Initialize ()
 {
     if (!initialized) {
 	initialized = true;
+
+        ParmParse pp("boxarray");
+        pp.query("use_tree", use_tree);
 #ifdef BL_MEM_PROFILING
 	MemProfiler::add("BoxArray", std::function<MemProfiler::MemInfo()>
 			 ([] () -> MemProfiler::MemInfo {
@@ -1098,7 +1253,31 @@ BoxArray::intersections (const Box&                         bx,
 
     isects.resize(0);
 
-    if (!BoxHashMap.empty())
+    if (!m_ref->tree.empty())
+    {
+        BL_ASSERT(bx.ixType() == ixType());
+
+        const Box& gbx = amrex::grow(bx,ng);
+
+        static thread_local std::vector<int> cands;
+        treeCandidates(gbx.smallEnd() - getDoiHi(), gbx.bigEnd() + getDoiLo(), cands);
+
+        bool super_simple = m_simple && m_crse_ratio==1 && m_typ.cellCentered();
+        auto& abox = m_ref->m_abox;
+
+        for (const int index : cands)
+        {
+            const Box& ibox = super_simple ? abox[index] : (*this)[index];
+            const Box& isect = bx & amrex::grow(ibox,ng);
+
+            if (isect.ok())
+            {
+                isects.push_back(std::pair<int,Box>(index,isect));
+                if (first_only) return;
+            }
+        }
+    }
+    else if (!BoxHashMap.empty())
     {
         BL_ASSERT(bx.ixType() == ixType());
 
@@ -1162,12 +1341,44 @@ BoxArray::complementIn (BoxList& bl, const Box& bx) const
     bl.set(bx.ixType());
     bl.push_back(bx);
 
-    if (!empty()) 
+    if (empty()) return;
+
+    BARef::HashType& BoxHashMap = getHashMap();
+
+    BL_ASSERT(bx.ixType() == ixType());
+
+    if (!m_ref->tree.empty())
     {
-	BARef::HashType& BoxHashMap = getHashMap();
+        static thread_local std::vector<int> cands;
+        treeCandidates(bx.smallEnd() - getDoiHi(), bx.bigEnd() + getDoiLo(), cands);
+
+        BoxList newbl(bl.ixType());
+        newbl.reserve(bl.capacity());
+        BoxList newdiff(bl.ixType());
+
+        bool super_simple = m_simple && m_crse_ratio==1 && m_typ.cellCentered();
+        auto& abox = m_ref->m_abox;
 
-	BL_ASSERT(bx.ixType() == ixType());
+        for (int k = 0, N = cands.size(); k < N && bl.isNotEmpty(); ++k)
+        {
+            const int index = cands[k];
+            const Box& isect = (super_simple)
+                ? (bx & abox[index])
+                : (bx & (*this)[index]);
 
+            if (isect.ok())
+            {
+                newbl.clear();
+                for (const Box& b : bl) {
+                    amrex::boxDiff(newdiff, b, isect);
+                    newbl.join(newdiff);
+                }
+                bl.swap(newbl);
+            }
+        }
+    }
+    else
+    {
 	Box gbx = bx;
 
 	IntVect glo = gbx.smallEnd();
@@ -1233,6 +1444,7 @@ BoxArray::clear_hash_bin () const
 	m_ref->updateMemoryUsage_hash(-1);
 #endif
         m_ref->hash.clear();
+        m_ref->tree.clear();
         m_ref->has_hashmap = false;
     }
 }
@@ -1253,7 +1465,7 @@ BoxArray::removeOverlap (bool simplify)
 
     uniqify();
 
-    BARef::HashType& BoxHashMap = m_ref->hash;
+    BARef::HashType& BoxHashMap = getHashMap();
 
     const Box EmptyBox;
 
@@ -1266,6 +1478,10 @@ BoxArray::removeOverlap (bool simplify)
     m_ref->updateMemoryUsage_hash(-1);
     long total_hash_bytes_save = m_ref->total_hash_bytes;
 #endif
+    //
+    // The boxes added below go into the hash bins only.
+    //
+    m_ref->tree.clear();
 
     BoxList bl_diff;
 
@@ -1386,6 +1602,34 @@ BoxArray::getHashMap () const
             m_ref->crsn = maxext;
             m_ref->bbox =boundingbox.coarsen(maxext);
             m_ref->bbox.normalize();
+            //
+            // With boxes of very different sizes the bins, which have the
+            // size of the largest box, each hold many boxes.
+            //
+            const int use_tree = BARef::use_tree;
+            if (use_tree > 0 ||
+                (use_tree == 0 && static_cast<std::size_t>(N) > tree_min_bin_size*BoxHashMap.size()))
+            {
+                //
+                // Order the boxes as the loop over the bins in intersections
+                // meets them: by bin, with the last direction slowest, and
+                // then by index.
+                //
+                std::vector<IntVect> bin(N);
+                std::vector<int> order(N);
+                for (int i = 0; i < N; ++i) {
+                    bin[i] = amrex::coarsen(m_ref->m_abox[i].smallEnd(),maxext);
+                    order[i] = i;
+                }
+                std::sort(order.begin(), order.end(), [&] (int a, int b) -> bool
+                {
+                    for (int d = AMREX_SPACEDIM-1; d >= 0; --d) {
+                        if (bin[a][d] != bin[b][d]) return bin[a][d] < bin[b][d];
+                    }
+                    return a < b;
+                });
+                m_ref->tree.build(m_ref->m_abox, order);
+            }
 
 	    m_ref->has_hashmap = true;
 
@@ -1398,6 +1642,26 @@ BoxArray::getHashMap () const
     return BoxHashMap;
 }
 
+void
+BoxArray::treeCandidates (const IntVect& lo, const IntVect& hi, std::vector<int>& cands) const
+{
+    cands.clear();
+    //
+    // lo:hi are in the index space of this BoxArray; go to the cells of the
+    // boxes in m_ref.
+    //
+    m_ref->tree.query(lo*m_crse_ratio, (hi+1)*m_crse_ratio-1, cands);
+    //
+    // The positions in tree.order are in the order of the loop over the
+    // hash bins.
+    //
+    std::sort(cands.begin(), cands.end());
+    const std::vector<int>& order = m_ref->tree.order;
+    for (int& c : cands) {
+        c = order[c];
+    }
+}
+
 void
 BoxArray::uniqify ()
 {
@@ -1668,6 +1932,116 @@ bool match (const BoxArray& x, const BoxArray& y)
     }
 }
 
+Vector<int> sameBoxes (const BoxArray& x, const BoxArray& y)
+{
+    Vector<int> r(x.size(), -1);
+    if (x == y) {
+        for (int i = 0, N = x.size(); i < N; ++i) {
+            r[i] = i;
+        }
+    } else if (x.ixType() == y.ixType() && !y.empty()) {
+        std::vector< std::pair<int,Box> > isects;
+        for (int i = 0, N = x.size(); i < N; ++i) {
+            const Box& bx = x[i];
+            y.intersections(bx, isects);
+            for (const auto& is : isects) {
+                if (is.second == bx && y[is.first] == bx) {
+                    r[i] = is.first;
+                    break;
+                }
+            }
+        }
+    }
+    return r;
+}
+
+namespace {
+    //
+    // Skilling's transform of the coordinates X[0:n) with b bits each into
+    // the transpose of their Hilbert index.
+    //
+    void hilbertTranspose (unsigned int* X, int b, int n)
+    {
+        const unsigned int M = 1u << (b-1);
+        for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+            const unsigned int P = Q - 1;
+            for (int i = 0; i < n; ++i)
+            {
+                if (X[i] & Q) {
+                    X[0] ^= P;
+                } else {
+                    const unsigned int t = (X[0] ^ X[i]) & P;
+                    X[0] ^= t;
+                    X[i] ^= t;
+                }
+            }
+        }
+        for (int i = 1; i < n; ++i) {
+            X[i] ^= X[i-1];
+        }
+        unsigned int t = 0;
+        for (unsigned int Q = M; Q > 1; Q >>= 1) {
+            if (X[n-1] & Q) t ^= Q-1;
+        }
+        for (int i = 0; i < n; ++i) {
+            X[i] ^= t;
+        }
+    }
+}
+
+BoxArray
+sfcOrder (const BoxArray& ba, const IntVect& granularity, bool hilbert)
+{
+    BL_PROFILE("amrex::sfcOrder()");
+
+    const int N = ba.size();
+    if (N <= 1) return ba;
+
+    const Box& mbx = amrex::coarsen(ba.minimalBox(), granularity);
+    const IntVect& lo = mbx.smallEnd();
+    int nbits = 1;
+    while (nbits < 63/AMREX_SPACEDIM && (1L << nbits) < mbx.longside()) {
+        ++nbits;
+    }
+
+    std::vector<std::pair<unsigned long long,int> > keys(N);
+    for (int i = 0; i < N; ++i)
+    {
+        const Box& bx = ba[i];
+        const IntVect& iv = amrex::coarsen(bx.smallEnd(), granularity) - lo;
+        unsigned int X[AMREX_SPACEDIM];
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            X[d] = iv[AMREX_SPACEDIM-1-d];
+        }
+        if (hilbert && AMREX_SPACEDIM > 1) {
+            hilbertTranspose(X, nbits, AMREX_SPACEDIM);
+        }
+        unsigned long long key = 0;
+        for (int b = nbits-1; b >= 0; --b) {
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                key = (key << 1) | ((X[d] >> b) & 1u);
+            }
+        }
+        keys[i] = std::make_pair(key, i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    bool sorted = true;
+    for (int i = 0; i < N && sorted; ++i) {
+        sorted = (keys[i].second == i);
+    }
+    if (sorted) return ba;
+
+    BoxList bl(ba.ixType());
+    bl.reserve(N);
+    for (const auto& k : keys) {
+        bl.push_back(ba[k.second]);
+    }
+    return BoxArray(std::move(bl));
+}
+
 std::ostream&
 operator<< (std::ostream& os, const BoxArray::RefID& id)
 {
@@ -18,6 +18,7 @@
 #include <map>
 #include <vector>
 #include <queue>
+#include <functional>
 #include <algorithm>
 #include <numeric>
 #include <string>
@@ -1289,6 +1290,54 @@ DistributionMapping::makeKnapSack (const Vector<Real>& rcost)
     return r;
 }
 
+DistributionMapping
+DistributionMapping::makeIncremental (const BoxArray& ba,
+                                      const BoxArray& old_ba,
+                                      const DistributionMapping& old_dm)
+{
+    BL_PROFILE("makeIncremental");
+
+    const int nprocs = ParallelContext::NProcsSub();
+    const int N = ba.size();
+
+    const Vector<int>& same = amrex::sameBoxes(ba, old_ba);
+
+    Vector<int>  pmap(N, -1);
+    Vector<long> load(nprocs, 0L);
+    std::vector<LIpair> fresh;
+
+    for (int i = 0; i < N; ++i)
+    {
+        const long npts = ba[i].numPts();
+        if (same[i] >= 0 && old_dm[same[i]] < nprocs) {
+            pmap[i] = old_dm[same[i]];
+            load[pmap[i]] += npts;
+        } else {
+            fresh.push_back(LIpair(npts,i));
+        }
+    }
+
+    Sort(fresh, true);
+
+    //
+    // (cells, rank) with the least loaded rank on top.
+    //
+    std::priority_queue<LIpair, std::vector<LIpair>, std::greater<LIpair> > pq;
+    for (int p = 0; p < nprocs; ++p) {
+        pq.push(LIpair(load[p],p));
+    }
+    for (const auto& f : fresh)
+    {
+        LIpair lr = pq.top();
+        pq.pop();
+        pmap[f.second] = lr.second;
+        lr.first += f.first;
+        pq.push(lr);
+    }
+
+    return DistributionMapping(std::move(pmap));
+}
+
 DistributionMapping
 DistributionMapping::makeKnapSack (const MultiFab& weight, int nmax)
 {
@@ -4,6 +4,7 @@
 #include <AMReX_Utility.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_FArrayBox.H>
+#include <AMReX_MultiFab.H>
 
 #include <AMReX_BArena.H>
 #include <AMReX_CArena.H>
@@ -24,6 +25,7 @@ namespace amrex {
 bool    FabArrayBase::do_async_sends;
 int     FabArrayBase::MaxComp;
 int     FabArrayBase::use_cuda_aware_mpi;
+long    FabArrayBase::cache_max_bytes;
 
 #if defined(AMREX_USE_GPU) && defined(AMREX_USE_GPU_PRAGMA)
 
@@ -67,6 +69,8 @@ FabArrayBase::CacheStats           FabArrayBase::m_CPC_stats("CopyCache");
 FabArrayBase::CacheStats           FabArrayBase::m_FPinfo_stats("FillPatchCache");
 FabArrayBase::CacheStats           FabArrayBase::m_CFinfo_stats("CrseFineCache");
 
+long                               FabArrayBase::m_cache_clock = 0L;
+
 std::map<FabArrayBase::BDKey, int> FabArrayBase::m_BD_count;
 
 FabArrayBase::FabArrayStats        FabArrayBase::m_FA_stats;
@@ -88,6 +92,7 @@ FabArrayBase::Initialize ()
     //
     FabArrayBase::do_async_sends    = true;
     FabArrayBase::MaxComp           = 25;
+    FabArrayBase::cache_max_bytes   = 0L;
 
     ParmParse pp("fabarray");
 
@@ -114,6 +119,14 @@ FabArrayBase::Initialize ()
     if (MaxComp < 1)
         MaxComp = 1;
 
+    long cache_max_mb = 0;
+    pp.query("cache_max_mb", cache_max_mb);
+#ifdef USE_PERILLA
+    // Perilla keeps pointers to the cached items for as long as it runs.
+    cache_max_mb = 0;
+#endif
+    FabArrayBase::cache_max_bytes = std::max(cache_max_mb, 0L) * 1024L * 1024L;
+
 #ifdef AMREX_USE_CUDA
     FabArrayBase::use_cuda_aware_mpi = 1;
     pp.query("use_cuda_aware_mpi", FabArrayBase::use_cuda_aware_mpi);
@@ -149,6 +162,14 @@ FabArrayBase::Initialize ()
 		     ([] () -> MemProfiler::MemInfo {
 			 return {m_CFinfo_stats.bytes, m_CFinfo_stats.bytes_hwm};
 		     }));
+    for (CacheStats* stats : {&m_TAC_stats, &m_FBC_stats, &m_CPC_stats,
+                              &m_FPinfo_stats, &m_CFinfo_stats})
+    {
+        MemProfiler::add(stats->name, std::function<MemProfiler::CacheInfo()>
+                         ([stats] () -> MemProfiler::CacheInfo {
+                             return {stats->nhit(), stats->nbuild, stats->nevict};
+                         }));
+    }
 #endif
 }
 
@@ -572,9 +593,7 @@ FabArrayBase::flushCPC (bool no_assertion) const
 	    }
 	}
 
-#ifdef BL_MEM_PROFILING
-	m_CPC_stats.bytes -= it->second->bytes();
-#endif
+	m_CPC_stats.bytes -= it->second->m_bytes;
 	m_CPC_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -599,9 +618,7 @@ FabArrayBase::flushCPCache ()
 	}
     }
     m_TheCPCache.clear();
-#ifdef BL_MEM_PROFILING
     m_CPC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::CPC&
@@ -629,6 +646,7 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
 	    it->second->m_dstba  == boxArray())
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_lastuse = ++m_cache_clock;
 	    m_CPC_stats.recordUse();
 	    return *(it->second);
 	}
@@ -637,12 +655,11 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     // Have to build a new one
     CPC* new_cpc = new CPC(*this, dstng, src, srcng, period);
 
-#ifdef BL_MEM_PROFILING
-    m_CPC_stats.bytes += new_cpc->bytes();
-    m_CPC_stats.bytes_hwm = std::max(m_CPC_stats.bytes_hwm, m_CPC_stats.bytes);
-#endif    
+    new_cpc->m_bytes = new_cpc->bytes();
+    m_CPC_stats.addBytes(new_cpc->m_bytes);
 
     new_cpc->m_nuse = 1;
+    new_cpc->m_lastuse = ++m_cache_clock;
     m_CPC_stats.recordBuild();
     m_CPC_stats.recordUse();
 
@@ -650,6 +667,8 @@ FabArrayBase::getCPC (const IntVect& dstng, const FabArrayBase& src, const IntVe
     if (srckey != dstkey)
 	m_TheCPCache.insert(          CPCache::value_type(srckey,new_cpc));
 
+    evictCaches(new_cpc);
+
     return *new_cpc;
 }
 
@@ -1094,9 +1113,7 @@ FabArrayBase::flushFB (bool no_assertion) const
     std::pair<FBCacheIter,FBCacheIter> er_it = m_TheFBCache.equal_range(m_bdkey);
     for (FBCacheIter it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef BL_MEM_PROFILING
-	m_FBC_stats.bytes -= it->second->bytes();
-#endif
+	m_FBC_stats.bytes -= it->second->m_bytes;
 	m_FBC_stats.recordErase(it->second->m_nuse);
 	delete it->second;
     }
@@ -1112,9 +1129,7 @@ FabArrayBase::flushFBCache ()
 	delete it->second;
     }
     m_TheFBCache.clear();
-#ifdef BL_MEM_PROFILING
     m_FBC_stats.bytes = 0L;
-#endif
 }
 
 const FabArrayBase::FB&
@@ -1135,6 +1150,7 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
 	    it->second->m_period     == period              )
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_lastuse = ++m_cache_clock;
 	    m_FBC_stats.recordUse();
 	    return *(it->second);
 	}
@@ -1143,17 +1159,18 @@ FabArrayBase::getFB (const IntVect& nghost, const Periodicity& period,
     // Have to build a new one
     FB* new_fb = new FB(*this, nghost, cross, period, enforce_periodicity_only);
 
-#ifdef BL_PROFILE
-    m_FBC_stats.bytes += new_fb->bytes();
-    m_FBC_stats.bytes_hwm = std::max(m_FBC_stats.bytes_hwm, m_FBC_stats.bytes);
-#endif
+    new_fb->m_bytes = new_fb->bytes();
+    m_FBC_stats.addBytes(new_fb->m_bytes);
 
     new_fb->m_nuse = 1;
+    new_fb->m_lastuse = ++m_cache_clock;
     m_FBC_stats.recordBuild();
     m_FBC_stats.recordUse();
 
     m_TheFBCache.insert(er_it.second, FBCache::value_type(m_bdkey,new_fb));
 
+    evictCaches(new_fb);
+
     return *new_fb;
 }
 
@@ -1163,7 +1180,8 @@ FabArrayBase::FPinfo::FPinfo (const FabArrayBase& srcfa,
 			      const IntVect&      dstng,
 			      const BoxConverter& coarsener,
                               const Box&          cdomain)
-    : m_srcbdk   (srcfa.getBDKey()),
+    : m_crse_patch_busy(false),
+      m_srcbdk   (srcfa.getBDKey()),
       m_dstbdk   (dstfa.getBDKey()),
       m_dstdomain(dstdomain),
       m_dstng    (dstng),
@@ -1227,6 +1245,42 @@ FabArrayBase::FPinfo::~FPinfo ()
     delete m_coarsener;
 }
 
+MultiFab*
+FabArrayBase::FPinfo::borrowCrsePatch (int ncomp) const
+{
+    bool busy = false;
+    if (!m_crse_patch_busy.compare_exchange_strong(busy, true)) return nullptr;
+
+    if (mf_crse_patch == nullptr || mf_crse_patch->nComp() < ncomp)
+    {
+        const int ncomp_old = (mf_crse_patch == nullptr) ? 0 : mf_crse_patch->nComp();
+        mf_crse_patch.reset();
+        mf_crse_patch.reset(new MultiFab(ba_crse_patch, dm_crse_patch, ncomp, 0, MFInfo(),
+                                         *fact_crse_patch));
+        //
+        // The buffer counts against the cache budget.
+        //
+        long npts = 0;
+        const int myproc = ParallelDescriptor::MyProc();
+        for (int i = 0, N = ba_crse_patch.size(); i < N; ++i) {
+            if (dm_crse_patch[i] == myproc) npts += ba_crse_patch[i].numPts();
+        }
+        const long nbytes = npts * (ncomp-ncomp_old) * sizeof(Real);
+        m_bytes += nbytes;
+        m_FPinfo_stats.addBytes(nbytes);
+    }
+
+    return mf_crse_patch.get();
+}
+
+void
+FabArrayBase::FPinfo::releaseCrsePatch (MultiFab* mf) const
+{
+    if (mf == mf_crse_patch.get()) {
+        m_crse_patch_busy = false;
+    }
+}
+
 long
 FabArrayBase::FPinfo::bytes () const
 {
@@ -1261,6 +1315,7 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
 	    it->second->m_coarsener->doit(it->second->m_dstdomain) == coarsener.doit(dstdomain))
 	{
 	    ++(it->second->m_nuse);
+	    it->second->m_lastuse = ++m_cache_clock;
 	    m_FPinfo_stats.recordUse();
 	    return *(it->second);
 	}
@@ -1269,12 +1324,11 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     // Have to build a new one
     FPinfo* new_fpc = new FPinfo(srcfa, dstfa, dstdomain, dstng, coarsener, cdomain);
 
-#ifdef BL_MEM_PROFILING
-    m_FPinfo_stats.bytes += new_fpc->bytes();
-    m_FPinfo_stats.bytes_hwm = std::max(m_FPinfo_stats.bytes_hwm, m_FPinfo_stats.bytes);
-#endif
+    new_fpc->m_bytes = new_fpc->bytes();
+    m_FPinfo_stats.addBytes(new_fpc->m_bytes);
     
     new_fpc->m_nuse = 1;
+    new_fpc->m_lastuse = ++m_cache_clock;
     m_FPinfo_stats.recordBuild();
     m_FPinfo_stats.recordUse();
 
@@ -1282,6 +1336,8 @@ FabArrayBase::TheFPinfo (const FabArrayBase& srcfa,
     if (srckey != dstkey)
 	m_TheFillPatchCache.insert(          FPinfoCache::value_type(srckey,new_fpc));
 
+    evictCaches(new_fpc);
+
     return *new_fpc;
 }
 
@@ -1291,6 +1347,7 @@ FabArrayBase::flushFPinfo (bool no_assertion)
     BL_ASSERT(no_assertion || getBDKey() == m_bdkey);
 
     std::vector<FPinfoCacheIter> others;
+    std::vector<FPinfo*> dead;
 
     std::pair<FPinfoCacheIter,FPinfoCacheIter> er_it = m_TheFillPatchCache.equal_range(m_bdkey);
 
@@ -1313,11 +1370,9 @@ FabArrayBase::flushFPinfo (bool no_assertion)
 	    }
 	} 
 
-#ifdef BL_MEM_PROFILING
-	m_FPinfo_stats.bytes -= it->second->bytes();
-#endif
+	m_FPinfo_stats.bytes -= it->second->m_bytes;
 	m_FPinfo_stats.recordErase(it->second->m_nuse);
-	delete it->second;
+	dead.push_back(it->second);
     }
     
     m_TheFillPatchCache.erase(er_it.first, er_it.second);
@@ -1327,6 +1382,12 @@ FabArrayBase::flushFPinfo (bool no_assertion)
     {
 	m_TheFillPatchCache.erase(*it);
     }
+
+    // Deleted last, because the patch buffers are FabArrays that flush
+    // their own cache entries when they go away.
+    for (FPinfo* fpc : dead) {
+        delete fpc;
+    }
 }
 
 FabArrayBase::CFinfo::CFinfo (const FabArrayBase& finefa,
@@ -1426,6 +1487,7 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
             it->second->m_ng          == ng)
         {
             ++(it->second->m_nuse);
+            it->second->m_lastuse = ++m_cache_clock;
             m_CFinfo_stats.recordUse();
             return *(it->second);
         }
@@ -1434,17 +1496,18 @@ FabArrayBase::TheCFinfo (const FabArrayBase& finefa,
     // Have to build a new one
     CFinfo* new_cfinfo = new CFinfo(finefa, finegm, ng, include_periodic, include_physbndry);
 
-#ifdef BL_MEM_PROFILING
-    m_CFinfo_stats.bytes += new_cfinfo->bytes();
-    m_CFinfo_stats.bytes_hwm = std::max(m_CFinfo_stats.bytes_hwm, m_CFinfo_stats.bytes);
-#endif
+    new_cfinfo->m_bytes = new_cfinfo->bytes();
+    m_CFinfo_stats.addBytes(new_cfinfo->m_bytes);
 
     new_cfinfo->m_nuse = 1;
+    new_cfinfo->m_lastuse = ++m_cache_clock;
     m_CFinfo_stats.recordBuild();
     m_CFinfo_stats.recordUse();
 
     m_TheCrseFineCache.insert(er_it.second, CFinfoCache::value_type(key,new_cfinfo));
 
+    evictCaches(new_cfinfo);
+
     return *new_cfinfo;
 }
 
@@ -1455,9 +1518,7 @@ FabArrayBase::flushCFinfo (bool no_assertion)
     auto er_it = m_TheCrseFineCache.equal_range(m_bdkey);
     for (auto it = er_it.first; it != er_it.second; ++it)
     {
-#ifdef BL_MEM_PROFILING
-        m_CFinfo_stats.bytes -= it->second->bytes();
-#endif
+        m_CFinfo_stats.bytes -= it->second->m_bytes;
         m_CFinfo_stats.recordErase(it->second->m_nuse);
         delete it->second;
     }
@@ -1515,11 +1576,7 @@ FabArrayBase::getTileArray (const IntVect& tilesize) const
 	    buildTileArray(tilesize, *p);
 	    p->nuse = 0;
 	    m_TAC_stats.recordBuild();
-#ifdef BL_MEM_PROFILING
-	    m_TAC_stats.bytes += p->bytes();
-	    m_TAC_stats.bytes_hwm = std::max(m_TAC_stats.bytes_hwm,
-					     m_TAC_stats.bytes);
-#endif
+	    m_TAC_stats.addBytes(p->bytes());
 	}
 #ifdef _OPENMP
 #pragma omp master
@@ -1640,9 +1697,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
 	    for (TAMap::const_iterator tai_it = tao_it->second.begin();
 		 tai_it != tao_it->second.end(); ++tai_it)
 	    {
-#ifdef BL_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 	    }
 	    tao.erase(tao_it);
@@ -1653,9 +1708,7 @@ FabArrayBase::flushTileArray (const IntVect& tileSize, bool no_assertion) const
             const IntVect& crse_ratio = boxArray().crseRatio();
 	    TAMap::iterator tai_it = tai.find(std::pair<IntVect,IntVect>(tileSize,crse_ratio));
 	    if (tai_it != tai.end()) {
-#ifdef BL_MEM_PROFILING
 		m_TAC_stats.bytes -= tai_it->second.bytes();
-#endif		
 		m_TAC_stats.recordErase(tai_it->second.nuse);
 		tai.erase(tai_it);
 	    }
@@ -1676,9 +1729,144 @@ FabArrayBase::flushTileArrayCache ()
 	}
     }
     m_TheTileArrayCache.clear();
-#ifdef BL_MEM_PROFILING
     m_TAC_stats.bytes = 0L;
-#endif
+}
+
+long
+FabArrayBase::cacheBytes ()
+{
+    return m_TAC_stats.bytes + m_FBC_stats.bytes + m_CPC_stats.bytes
+        + m_FPinfo_stats.bytes + m_CFinfo_stats.bytes;
+}
+
+namespace {
+    template <class Cache, class Key, class T>
+    void eraseCacheItem (Cache& cache, const Key& key, const T* p)
+    {
+        auto er_it = cache.equal_range(key);
+        for (auto it = er_it.first; it != er_it.second; ++it) {
+            if (it->second == p) {
+                cache.erase(it);
+                return;
+            }
+        }
+    }
+}
+
+void
+FabArrayBase::evictCaches (const CacheItem* keep)
+{
+    if (cache_max_bytes <= 0) return;
+
+    long excess = cacheBytes() - cache_max_bytes;
+    if (excess <= 0) return;
+
+    BL_PROFILE("FabArrayBase::evictCaches()");
+
+    enum { FBItem = 0, CPCItem, FPItem, CFItem };
+
+    struct Candidate {
+        long       lastuse;
+        int        cache;
+        BDKey      key;
+        CacheItem* item;
+    };
+    std::vector<Candidate> cands;
+
+    auto evictable = [keep] (const CacheItem* p) -> bool {
+        return p != keep && p->m_npin == 0;
+    };
+    //
+    // The CPC and FPinfo items are under the destination key, and also
+    // under the source key if it is different; take them once.
+    //
+    for (const auto& kv : m_TheFBCache) {
+        if (evictable(kv.second)) {
+            cands.push_back({kv.second->m_lastuse, FBItem, kv.first, kv.second});
+        }
+    }
+    for (const auto& kv : m_TheCPCache) {
+        if (kv.first == kv.second->m_dstbdk && evictable(kv.second)) {
+            cands.push_back({kv.second->m_lastuse, CPCItem, kv.first, kv.second});
+        }
+    }
+    for (const auto& kv : m_TheFillPatchCache) {
+        if (kv.first == kv.second->m_dstbdk && evictable(kv.second)
+            && !kv.second->m_crse_patch_busy) {
+            cands.push_back({kv.second->m_lastuse, FPItem, kv.first, kv.second});
+        }
+    }
+    for (const auto& kv : m_TheCrseFineCache) {
+        if (evictable(kv.second)) {
+            cands.push_back({kv.second->m_lastuse, CFItem, kv.first, kv.second});
+        }
+    }
+
+    std::sort(cands.begin(), cands.end(), [] (const Candidate& a, const Candidate& b) -> bool
+              { return a.lastuse < b.lastuse; });
+
+    std::vector<FB*>     dead_fb;
+    std::vector<CPC*>    dead_cpc;
+    std::vector<FPinfo*> dead_fp;
+    std::vector<CFinfo*> dead_cf;
+
+    for (const auto& c : cands)
+    {
+        if (excess <= 0) break;
+        excess -= c.item->m_bytes;
+
+        switch (c.cache)
+        {
+        case FBItem:
+        {
+            FB* p = static_cast<FB*>(c.item);
+            eraseCacheItem(m_TheFBCache, c.key, p);
+            m_FBC_stats.bytes -= p->m_bytes;
+            m_FBC_stats.recordEvict(p->m_nuse);
+            dead_fb.push_back(p);
+            break;
+        }
+        case CPCItem:
+        {
+            CPC* p = static_cast<CPC*>(c.item);
+            eraseCacheItem(m_TheCPCache, p->m_dstbdk, p);
+            if (p->m_srcbdk != p->m_dstbdk) {
+                eraseCacheItem(m_TheCPCache, p->m_srcbdk, p);
+            }
+            m_CPC_stats.bytes -= p->m_bytes;
+            m_CPC_stats.recordEvict(p->m_nuse);
+            dead_cpc.push_back(p);
+            break;
+        }
+        case FPItem:
+        {
+            FPinfo* p = static_cast<FPinfo*>(c.item);
+            eraseCacheItem(m_TheFillPatchCache, p->m_dstbdk, p);
+            if (p->m_srcbdk != p->m_dstbdk) {
+                eraseCacheItem(m_TheFillPatchCache, p->m_srcbdk, p);
+            }
+            m_FPinfo_stats.bytes -= p->m_bytes;
+            m_FPinfo_stats.recordEvict(p->m_nuse);
+            dead_fp.push_back(p);
+            break;
+        }
+        default:
+        {
+            CFinfo* p = static_cast<CFinfo*>(c.item);
+            eraseCacheItem(m_TheCrseFineCache, c.key, p);
+            m_CFinfo_stats.bytes -= p->m_bytes;
+            m_CFinfo_stats.recordEvict(p->m_nuse);
+            dead_cf.push_back(p);
+        }
+        }
+    }
+
+    for (FB*     p : dead_fb ) delete p;
+    for (CPC*    p : dead_cpc) delete p;
+    for (CFinfo* p : dead_cf ) delete p;
+    // Deleted last, because the patch buffers are FabArrays that flush
+    // their own cache entries when they go away.
+    for (FPinfo* p : dead_fp ) delete p;
 }
 
 void
@@ -2,6 +2,9 @@
 #include <AMReX_MFIter.H>
 #include <AMReX_FabArray.H>
 #include <AMReX_FArrayBox.H>
+#ifdef AMREX_TINY_PROFILING
+#include <AMReX_TinyProfiler.H>
+#endif
 
 namespace amrex {
 
@@ -171,6 +174,18 @@ MFIter::MFIter (const FabArrayBase& fabarray_, const MFItInfo& info)
 
 MFIter::~MFIter ()
 {
+#ifdef AMREX_TINY_PROFILING
+    // the cells of the tiles visited by this thread, for the tiny profiler's counters
+    if (TinyProfiler::CountingCells() && tile_array != nullptr && !dynamic)
+    {
+        long ncells = 0;
+        for (int i = beginIndex, n = std::min(currentIndex,endIndex); i < n; ++i) {
+            ncells += (*tile_array)[i].numPts();
+        }
+        TinyProfiler::AddCells(ncells);
+    }
+#endif
+
 #if BL_USE_TEAM
     if ( ! (flags & NoTeamBarrier) )
 	ParallelDescriptor::MyTeam().MemoryBarrier();
@@ -46,6 +46,19 @@ MemProfiler::add (const std::string& name, std::function<NBuildsInfo()>&& f)
     mprofiler.the_funcs_builds.push_back(std::move(f));
 }
 
+void 
+MemProfiler::add (const std::string& name, std::function<CacheInfo()>&& f)
+{
+    MemProfiler& mprofiler = getInstance();
+    auto it = std::find(mprofiler.the_names_caches.begin(), mprofiler.the_names_caches.end(), name);
+    if (it != mprofiler.the_names_caches.end()) {
+        std::string s = "MemProfiler::add (CacheInfo) failed because " + name + " already existed";
+        amrex::Abort(s.c_str());
+    }
+    mprofiler.the_names_caches.push_back(name);
+    mprofiler.the_funcs_caches.push_back(std::move(f));
+}
+
 MemProfiler& 
 MemProfiler::getInstance ()
 {
@@ -98,6 +111,16 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
     std::vector<int>  num_builds_max = num_builds_min;
     std::vector<int>  hwm_builds_max = hwm_builds_min;
 
+    // hits, misses and evictions of every cache
+    std::vector<long> cache_min;
+    for (auto&& f: the_funcs_caches) {
+	const CacheInfo& cinfo = f();
+	cache_min.push_back(cinfo.hits);
+	cache_min.push_back(cinfo.misses);
+	cache_min.push_back(cinfo.evictions);
+    }
+    std::vector<long> cache_max = cache_min;
+
 #ifdef __linux
     const int N = 9;
 #else
@@ -213,6 +236,11 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
     ParallelDescriptor::ReduceIntMin (&hwm_builds_min[0], hwm_builds_min.size(), IOProc);
     ParallelDescriptor::ReduceIntMax (&hwm_builds_max[0], hwm_builds_max.size(), IOProc);
 
+    if (!cache_min.empty()) {
+	ParallelDescriptor::ReduceLongMin(&cache_min[0], cache_min.size(), IOProc);
+	ParallelDescriptor::ReduceLongMax(&cache_max[0], cache_max.size(), IOProc);
+    }
+
     if (ParallelDescriptor::IOProcessor()) {
 
 	std::ofstream memlog(memory_log_name.c_str(), 
@@ -225,6 +253,8 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
 		width_name = std::max(width_name, int(x.size()));
 	    for (auto& x: the_names_builds)
 		width_name = std::max(width_name, int(x.size()));
+	    for (auto& x: the_names_caches)
+		width_name = std::max(width_name, int(x.size()));
 	}
 	const int width_bytes = 18;
 
@@ -292,6 +322,33 @@ MemProfiler::report_ (const std::string& prefix, const std::string& memory_log_n
 	    }
 	}
 
+	// Cache hits, misses and evictions
+	if (!the_names_caches.empty())
+	{
+	    memlog << "\n";
+	    memlog << ident;
+	    memlog << "| " << std::setw(width_name) << std::left << "Name" << " | "
+		   << std::setw(width_bytes) << std::right << "Hits        " << " | "
+		   << std::setw(width_bytes) << "Misses       " << " | "
+		   << std::setw(width_bytes) << "Evictions     " << " |\n";
+	    std::setw(0);
+
+	    memlog << ident;
+	    memlog << "|-" << dash_name << "-+-" << dash_bytes << "-+-" << dash_bytes
+		   << "-+-" << dash_bytes << "-|\n";
+
+	    for (int i = 0, N = the_names_caches.size(); i < N; ++i) {
+		if (cache_max[3*i] > 0 || cache_max[3*i+1] > 0) {
+		    memlog << ident;
+		    memlog << "| " << std::setw(width_name) << std::left << the_names_caches[i] << " | ";
+		    for (int j = 0; j < 3; ++j) {
+			memlog << Counts{cache_min[3*i+j],cache_max[3*i+j]} << " |";
+			memlog << ((j < 2) ? " " : "\n");
+		    }
+		}
+	    }
+	}
+
 #ifdef __linux
 	if (ierr_proc_status == 0) {
 	    memlog << "\n";
@@ -366,4 +423,13 @@ operator<< (std::ostream& os, const MemProfiler::Builds& builds)
     return os;
 }
 
+std::ostream& 
+operator<< (std::ostream& os, const MemProfiler::Counts& counts)
+{
+    os << std::setw(6) << std::right << counts.mn << " ... "
+       << std::setw(7) << std::left  << counts.mx; 
+    os << std::setw(0);
+    return os;
+}
+
 }
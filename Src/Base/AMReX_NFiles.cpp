@@ -313,8 +313,13 @@ bool NFilesIter::ReadyToWrite(bool appendFirst) {
   if(finishedWriting) {
     return false;
   }
-  fileStream.open(fullFileName.c_str(),
-                  std::ios::out | std::ios::trunc | std::ios::binary);
+  if( ! appendFirst) {
+    fileStream.open(fullFileName.c_str(),
+                    std::ios::out | std::ios::trunc | std::ios::binary);
+  } else {
+    fileStream.open(fullFileName.c_str(),
+                    std::ios::out | std::ios::app | std::ios::binary);
+  }
   if( ! fileStream.good()) {
     amrex::FileOpenFailed(fullFileName);
   }
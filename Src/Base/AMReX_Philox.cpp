@@ -0,0 +1,52 @@
+
+#include <AMReX_Philox.H>
+#include <AMReX_RESTRICT.H>
+#include <AMReX_BLProfiler.H>
+
+namespace amrex {
+
+void
+FillRandom (Real* AMREX_RESTRICT data, long n, unsigned long seed,
+            unsigned long first_index, unsigned int stream)
+{
+    BL_PROFILE("amrex::FillRandom()");
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < n; ++i) {
+        data[i] = Philox::uniform(seed, first_index+i, stream);
+    }
+}
+
+void
+FillRandom (Real* AMREX_RESTRICT data, const long* AMREX_RESTRICT index, long n,
+            unsigned long seed, unsigned int stream)
+{
+    BL_PROFILE("amrex::FillRandom()");
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < n; ++i) {
+        data[i] = Philox::uniform(seed, index[i], stream);
+    }
+}
+
+void
+FillRandomNormal (Real* AMREX_RESTRICT data, long n, Real mean, Real stddev,
+                  unsigned long seed, unsigned long first_index, unsigned int stream)
+{
+    BL_PROFILE("amrex::FillRandomNormal()");
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < n; ++i) {
+        data[i] = Philox::normal(mean, stddev, seed, first_index+i, stream);
+    }
+}
+
+void
+FillRandomNormal (Real* AMREX_RESTRICT data, const long* AMREX_RESTRICT index, long n,
+                  Real mean, Real stddev, unsigned long seed, unsigned int stream)
+{
+    BL_PROFILE("amrex::FillRandomNormal()");
+    AMREX_PRAGMA_SIMD
+    for (long i = 0; i < n; ++i) {
+        data[i] = Philox::normal(mean, stddev, seed, index[i], stream);
+    }
+}
+
+}
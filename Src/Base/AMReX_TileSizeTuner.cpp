@@ -0,0 +1,276 @@
+
+#include <AMReX_TileSizeTuner.H>
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace amrex {
+
+namespace
+{
+    bool initialized = false;
+
+    int         tune    = 1;
+    int         trials  = 2;
+    int         verbose = 0;
+    std::string cache_file;
+    std::string node_type;
+
+    Vector<IntVect> candidates;
+
+    struct Record
+    {
+        Vector<double> times;  // the best time of each candidate
+        int     ncalls = 0;
+        bool    done   = false;
+        bool    tuned  = false;  // in this run
+        IntVect best;
+    };
+
+    std::map<std::string,Record> records;
+
+    std::string
+    noSpaces (std::string s)
+    {
+        for (auto& c : s) {
+            if (std::isspace(static_cast<unsigned char>(c))) c = '_';
+        }
+        return s;
+    }
+
+    //
+    // The CPU model, the number of threads and the dimension.
+    //
+    std::string
+    nodeType ()
+    {
+        std::string model("unknown");
+        std::ifstream ifs("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            if (line.compare(0, 10, "model name") == 0)
+            {
+                const std::size_t pos = line.find(':');
+                if (pos != std::string::npos) {
+                    const std::size_t b = line.find_first_not_of(" \t", pos+1);
+                    if (b != std::string::npos) model = line.substr(b);
+                }
+                break;
+            }
+        }
+        int nthreads = 1;
+#ifdef _OPENMP
+        nthreads = omp_get_max_threads();
+#endif
+        std::ostringstream os;
+        os << model << ' ' << nthreads << "threads " << AMREX_SPACEDIM << 'd';
+        return noSpaces(os.str());
+    }
+
+    bool
+    readLine (const std::string& line, std::string& node, std::string& key, IntVect& ts)
+    {
+        std::istringstream is(line);
+        if (!(is >> node >> key)) return false;
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            if (!(is >> ts[d]) || ts[d] <= 0) return false;
+        }
+        return true;
+    }
+}
+
+void
+TileSizeTuner::Initialize ()
+{
+    if (initialized) return;
+    initialized = true;
+
+    tune    = 1;
+    trials  = 2;
+    verbose = 0;
+    cache_file.clear();
+
+    ParmParse pp("tile_tuner");
+    pp.query("tune",    tune);
+    pp.query("trials",  trials);
+    pp.query("verbose", verbose);
+    pp.query("file",    cache_file);
+    trials = std::max(trials, 1);
+
+    node_type = nodeType();
+
+    //
+    // The default tile size first, so that it wins ties.
+    //
+    const int big = 1024000;
+    candidates.clear();
+    candidates.push_back(FabArrayBase::mfiter_tile_size);
+#if (AMREX_SPACEDIM == 1)
+    candidates.push_back(IntVect(big));
+    candidates.push_back(IntVect(4096));
+    candidates.push_back(IntVect(1024));
+#elif (AMREX_SPACEDIM == 2)
+    candidates.push_back(IntVect(big,big));
+    for (int t : {64, 32, 16, 8}) {
+        candidates.push_back(IntVect(big,t));
+    }
+    candidates.push_back(IntVect(64,16));
+#else
+    candidates.push_back(IntVect(big,big,big));
+    for (int t : {32, 16, 8, 4}) {
+        candidates.push_back(IntVect(big,t,t));
+    }
+    candidates.push_back(IntVect(64,8,8));
+    candidates.push_back(IntVect(32,16,8));
+#endif
+    for (int i = candidates.size()-1; i > 0; --i) {
+        if (std::find(candidates.begin(), candidates.begin()+i, candidates[i])
+            != candidates.begin()+i)
+        {
+            candidates.erase(candidates.begin()+i);
+        }
+    }
+
+    records.clear();
+    if (!cache_file.empty())
+    {
+        std::ifstream ifs(cache_file.c_str());
+        std::string line, node, key;
+        IntVect ts;
+        while (std::getline(ifs, line))
+        {
+            if (readLine(line, node, key, ts) && node == node_type) {
+                Record& r = records[key];
+                r.done = true;
+                r.best = ts;
+            }
+        }
+    }
+
+    amrex::ExecOnFinalize(TileSizeTuner::Finalize);
+}
+
+void
+TileSizeTuner::Finalize ()
+{
+    if (!initialized) return;
+
+    bool tuned = false;
+    for (const auto& kv : records) {
+        tuned = tuned || kv.second.tuned;
+    }
+
+    if (tuned && !cache_file.empty() && ParallelDescriptor::IOProcessor())
+    {
+        //
+        // Keep the lines of the other kinds of nodes and of the loops
+        // that did not run.
+        //
+        std::vector<std::string> lines;
+        {
+            std::ifstream ifs(cache_file.c_str());
+            std::string line, node, key;
+            IntVect ts;
+            while (std::getline(ifs, line))
+            {
+                if (readLine(line, node, key, ts) &&
+                    !(node == node_type && records.count(key) > 0 && records[key].done))
+                {
+                    lines.push_back(line);
+                }
+            }
+        }
+
+        std::ofstream ofs(cache_file.c_str(), std::ios::trunc);
+        if (!ofs.good()) {
+            amrex::Warning("TileSizeTuner: cannot write " + cache_file);
+        } else {
+            for (const auto& line : lines) {
+                ofs << line << '\n';
+            }
+            for (const auto& kv : records)
+            {
+                if (kv.second.done) {
+                    ofs << node_type << ' ' << kv.first;
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                        ofs << ' ' << kv.second.best[d];
+                    }
+                    ofs << '\n';
+                }
+            }
+        }
+    }
+
+    records.clear();
+    candidates.clear();
+    initialized = false;
+}
+
+TileSizeTuner::TileSizeTuner (const std::string& tag, const FabArrayBase& fa)
+    :
+    m_tile_size(FabArrayBase::mfiter_tile_size),
+    m_candidate(-1),
+    m_start(0.0)
+{
+#ifdef _OPENMP
+    BL_ASSERT(!omp_in_parallel());
+#endif
+
+    Initialize();
+
+    std::ostringstream os;
+    os << noSpaces(tag) << ':' << fa.nComp();
+    m_key = os.str();
+
+    Record& r = records[m_key];
+    if (r.done) {
+        m_tile_size = r.best;
+    } else if (tune) {
+        if (r.times.empty()) {
+            r.times.resize(candidates.size(), std::numeric_limits<double>::max());
+        }
+        m_candidate = r.ncalls / trials;
+        m_tile_size = candidates[m_candidate];
+        m_start = amrex::second();
+    }
+}
+
+TileSizeTuner::~TileSizeTuner ()
+{
+    if (m_candidate < 0) return;
+
+    const double t = amrex::second() - m_start;
+
+    Record& r = records[m_key];
+    r.times[m_candidate] = std::min(r.times[m_candidate], t);
+
+    if (++r.ncalls == trials * static_cast<int>(candidates.size()))
+    {
+        const int ibest = std::min_element(r.times.begin(), r.times.end()) - r.times.begin();
+        r.best  = candidates[ibest];
+        r.done  = true;
+        r.tuned = true;
+
+        if (verbose > 0) {
+            amrex::Print() << "TileSizeTuner: " << m_key << " uses tile size " << r.best
+                           << ", " << r.times[ibest] << " vs. " << r.times[0]
+                           << " seconds with " << candidates[0] << "\n";
+        }
+    }
+}
+
+}
@@ -6,49 +6,255 @@
 #include <iomanip>
 #include <cmath>
 #include <set>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #include <AMReX_TinyProfiler.H>
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_Utility.H>
 #include <AMReX_Print.H>
+#include <AMReX_ParmParse.H>
 
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define AMREX_TINY_PROFILER_USE_TSC
+#endif
+
+#if defined(__linux__)
+#include <cstring>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#define AMREX_TINY_PROFILER_USE_PERF
+#endif
+
 namespace amrex {
 
-std::vector<std::string>          TinyProfiler::regionstack;
-std::stack<std::pair<double,double> > TinyProfiler::ttstack;
-std::map<std::string,std::map<std::string, TinyProfiler::Stats> > TinyProfiler::statsmap;
+std::vector<int>         TinyProfiler::regionstack;
+std::vector<std::string> TinyProfiler::regionnames;
+std::vector<std::unique_ptr<TinyProfiler::ThreadStats> > TinyProfiler::threadstats;
 double TinyProfiler::t_init = std::numeric_limits<double>::max();
+double TinyProfiler::tick_init = 0.0;
+bool TinyProfiler::perf_counters = false;
+int TinyProfiler::perf_kind = 0;
+constexpr int TinyProfiler::NCounters;
 
 namespace {
     std::set<std::string> improperly_nested_timers;
     static constexpr char mainregion[] = "main";
+    bool finalized = false;
+
+    // Interned names.  A deque does not move its elements, so the c_str()
+    // of a name stays valid for the CallSite keys.
+    std::mutex                           name_mutex;
+    std::deque<std::string>              name_table;
+    std::unordered_map<std::string, int> name_ids;
+
+    // The timestamp counter costs a few ns where a clock call costs tens.
+    // Ticks are converted to seconds with the rate measured between
+    // Initialize and Finalize.
+    inline double ticks ()
+    {
+#ifdef AMREX_TINY_PROFILER_USE_TSC
+        return static_cast<double>(__rdtsc());
+#else
+        return amrex::second();
+#endif
+    }
+
+    // The thread that called Initialize.  Threads of its own, such as the
+    // one making grids for the next regrid, are not timed.
+    std::thread::id main_thread;
+
+    inline int thread_num ()
+    {
+#ifdef _OPENMP
+        // Nested teams would reuse thread numbers.
+        if (omp_get_level() > 1) return -1;
+        const int t = omp_get_thread_num();
+        if (t == 0 && std::this_thread::get_id() != main_thread) return -1;
+        return t;
+#else
+        return (std::this_thread::get_id() == main_thread) ? 0 : -1;
+#endif
+    }
+
+    // The three events of each kind of counter group.  The last slot of
+    // the counts holds the cells.
+    constexpr int nevents = TinyProfiler::NCounters - 1;
+    const char* hw_event_names[nevents] = {"Cycles", "Instr.", "LLC Miss"};
+    const char* sw_event_names[nevents] = {"Task ns", "Page Flt.", "Ctx. Sw."};
+
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    int perf_open (std::uint32_t type, std::uint64_t config, int group_fd)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = (group_fd == -1);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        // count the calling thread on any cpu
+        return syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+
+    //! Open a group counting the calling thread.  Returns the fds, leader first.
+    std::vector<int> perf_open_group (int kind)
+    {
+        const std::uint32_t type = (kind == 1) ? PERF_TYPE_HARDWARE : PERF_TYPE_SOFTWARE;
+        const std::uint64_t hw_configs[nevents] = {PERF_COUNT_HW_CPU_CYCLES,
+                                                   PERF_COUNT_HW_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_CACHE_MISSES};
+        const std::uint64_t sw_configs[nevents] = {PERF_COUNT_SW_TASK_CLOCK,
+                                                   PERF_COUNT_SW_PAGE_FAULTS,
+                                                   PERF_COUNT_SW_CONTEXT_SWITCHES};
+        const std::uint64_t* configs = (kind == 1) ? hw_configs : sw_configs;
+
+        std::vector<int> fds;
+        for (int i = 0; i < nevents; ++i) {
+            int fd = perf_open(type, configs[i], fds.empty() ? -1 : fds[0]);
+            if (fd < 0) {
+                for (int f : fds) close(f);
+                return std::vector<int>();
+            }
+            fds.push_back(fd);
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        return fds;
+    }
+#endif
+
+    //! Close a group, the members before the leader.
+    void perf_close_group (std::vector<int>& fds)
+    {
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+        for (auto it = fds.rbegin(); it != fds.rend(); ++it) {
+            close(*it);
+        }
+#endif
+        fds.clear();
+    }
+
+    //! The line size of the last level cache, whose misses are counted.
+    long llc_line_size ()
+    {
+        long linesize = 0;
+#if defined(AMREX_TINY_PROFILER_USE_PERF)
+#if defined(_SC_LEVEL3_CACHE_LINESIZE)
+        linesize = sysconf(_SC_LEVEL3_CACHE_LINESIZE);
+#endif
+#if defined(_SC_LEVEL2_CACHE_LINESIZE)
+        if (linesize <= 0) linesize = sysconf(_SC_LEVEL2_CACHE_LINESIZE);
+#endif
+#if defined(_SC_LEVEL1_DCACHE_LINESIZE)
+        if (linesize <= 0) linesize = sysconf(_SC_LEVEL1_DCACHE_LINESIZE);
+#endif
+#endif
+        return (linesize > 0) ? linesize : 64;
+    }
+}
+
+int
+TinyProfiler::Intern (const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(name_mutex);
+    auto it = name_ids.find(name);
+    if (it != name_ids.end()) {
+        return it->second;
+    }
+    const int i = name_table.size();
+    name_table.push_back(name);
+    name_ids.insert(std::make_pair(name, i));
+    return i;
+}
+
+const std::string&
+TinyProfiler::Name (int i)
+{
+    std::lock_guard<std::mutex> lock(name_mutex);
+    return name_table[i];
+}
+
+int
+TinyProfiler::SiteId (CallSite& site, const char* name)
+{
+    // The key is set once, before the id is published, so a reader that
+    // sees the id also sees the key.  A call site whose name is not a
+    // literal falls through to Intern every time it changes pointer.
+    int i = site.id.load(std::memory_order_acquire);
+    if (i >= 0 && site.key == name) return i;
+
+    i = Intern(name);
+    std::lock_guard<std::mutex> lock(name_mutex);
+    if (site.id.load(std::memory_order_relaxed) < 0) {
+        site.key = name;
+        site.id.store(i, std::memory_order_release);
+    }
+    return i;
+}
+
+int
+TinyProfiler::SiteId (CallSite& site, const std::string& name)
+{
+    // For names built at run time, the key points to the interned copy and
+    // the check compares contents.
+    int i = site.id.load(std::memory_order_acquire);
+    if (i >= 0 && name == site.key) return i;
+
+    i = Intern(name);
+    std::lock_guard<std::mutex> lock(name_mutex);
+    if (site.id.load(std::memory_order_relaxed) < 0) {
+        site.key = name_table[i].c_str();
+        site.id.store(i, std::memory_order_release);
+    }
+    return i;
 }
 
 TinyProfiler::TinyProfiler (std::string funcname)
-    : fname(std::move(funcname))
+    : id(Intern(funcname)), tid(-1), cnt_depth(-1)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (std::string funcname, bool start_)
-    : fname(std::move(funcname))
+    : id(Intern(funcname)), tid(-1), cnt_depth(-1)
 {
     if (start_) start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname)
-    : fname(funcname)
+    : id(Intern(funcname)), tid(-1), cnt_depth(-1)
 {
     start();
 }
 
 TinyProfiler::TinyProfiler (const char* funcname, bool start_)
-    : fname(funcname)
+    : id(Intern(funcname)), tid(-1), cnt_depth(-1)
+{
+    if (start_) start();
+}
+
+TinyProfiler::TinyProfiler (CallSite& site, const char* funcname, bool start_)
+    : id(SiteId(site, funcname)), tid(-1), cnt_depth(-1)
+{
+    if (start_) start();
+}
+
+TinyProfiler::TinyProfiler (CallSite& site, const std::string& funcname, bool start_)
+    : id(SiteId(site, funcname)), tid(-1), cnt_depth(-1)
 {
     if (start_) start();
 }
@@ -61,91 +267,212 @@ TinyProfiler::~TinyProfiler ()
 void
 TinyProfiler::start ()
 {
-#ifdef _OPENMP
-#pragma omp master
-#endif
-    if (stats.empty())
-    {
-	double t = amrex::second();
+    if (tid >= 0) return;
+
+    const int t_id = thread_num();
+    if (t_id < 0 || t_id >= static_cast<int>(threadstats.size())) return;
+
+    ThreadStats& ts = *threadstats[t_id];
+
+    cnt_depth = -1;
+    if (perf_counters) {
+        std::array<double,NCounters> c;
+        if (ReadCounters(ts, c)) {
+            ts.cntstack.push_back(c);
+            cnt_depth = ts.cntstack.size();
+        }
+    }
+
+    double t = ticks();
 
-	ttstack.push(std::make_pair(t, 0.0));
-	global_depth = ttstack.size();
+    ts.ttstack.push_back(std::make_pair(t, 0.0));
+    global_depth = ts.ttstack.size();
+    nregions = regionstack.size();
+    tid = t_id;
 
 #ifdef AMREX_USE_CUDA
-	nvtx_id = nvtxRangeStartA(fname.c_str());
+    if (tid == 0) nvtx_id = nvtxRangeStartA(Name(id).c_str());
 #endif
 
-        for (auto const& region : regionstack)
-        {
-            Stats& st = statsmap[region][fname];
-            ++st.depth;
-            stats.push_back(&st);
-        }
+    for (int i = 0; i < nregions; ++i)
+    {
+        ++(ts.get(regionstack[i], id).depth);
     }
 }
 
 void
 TinyProfiler::stop ()
 {
-#ifdef _OPENMP
-#pragma omp master
-#endif
-    if (!stats.empty()) 
-    {
-	double t = amrex::second();
+    if (tid < 0) return;
 
-	while (static_cast<int>(ttstack.size()) > global_depth) {
-	    ttstack.pop();
-	};
+    ThreadStats& ts = *threadstats[tid];
 
-	if (static_cast<int>(ttstack.size()) == global_depth)
-	{
-	    const std::pair<double,double>& tt = ttstack.top();
-	    
-	    // first: wall time when the pair is pushed into the stack
-	    // second: accumulated dt of children
-	    
-	    double dtin = t - tt.first; // elapsed time since start() is called.
-	    double dtex = dtin - tt.second;
+    double t = ticks();
 
-            for (Stats* st : stats)
-            {
-                --(st->depth);
-                ++(st->n);
-                if (st->depth == 0) {
-                    st->dtin += dtin;
+    while (static_cast<int>(ts.ttstack.size()) > global_depth) {
+        ts.ttstack.pop_back();
+    };
+
+    if (static_cast<int>(ts.ttstack.size()) == global_depth &&
+        static_cast<int>(regionstack.size()) >= nregions)
+    {
+        const std::pair<double,double>& tt = ts.ttstack.back();
+
+        // first: ticks when the pair is pushed into the stack
+        // second: accumulated ticks of children
+
+        double dtin = t - tt.first; // elapsed time since start() is called.
+        double dtex = dtin - tt.second;
+
+        // counts since start(), including the children
+        std::array<double,NCounters> dcnt;
+        bool counted = false;
+        if (cnt_depth > 0 && static_cast<int>(ts.cntstack.size()) >= cnt_depth) {
+            ts.cntstack.resize(cnt_depth);
+            counted = ReadCounters(ts, dcnt);
+            for (int k = 0; k < NCounters; ++k) {
+                dcnt[k] -= ts.cntstack.back()[k];
+            }
+            ts.cntstack.pop_back();
+        }
+
+        for (int i = 0; i < nregions; ++i)
+        {
+            Stats& st = ts.get(regionstack[i], id);
+            --(st.depth);
+            ++(st.n);
+            if (st.depth == 0) {
+                st.dtin += dtin;
+                if (counted) {
+                    for (int k = 0; k < NCounters; ++k) {
+                        st.cnt[k] += dcnt[k];
+                    }
                 }
-                st->dtex += dtex;
             }
-                
-	    ttstack.pop();
-	    if (!ttstack.empty()) {
-		std::pair<double,double>& parent = ttstack.top();
-		parent.second += dtin;
-	    }
+            st.dtex += dtex;
+        }
+
+        ts.ttstack.pop_back();
+        if (!ts.ttstack.empty()) {
+            std::pair<double,double>& parent = ts.ttstack.back();
+            parent.second += dtin;
+        }
 
 #ifdef AMREX_USE_CUDA
-	    nvtxRangeEnd(nvtx_id);
+        if (tid == 0) nvtxRangeEnd(nvtx_id);
 #endif
-	} else {
-	    improperly_nested_timers.insert(fname);
-	} 
+    } else {
+        if (cnt_depth > 0 && static_cast<int>(ts.cntstack.size()) >= cnt_depth) {
+            ts.cntstack.resize(cnt_depth-1);
+        }
+#ifdef _OPENMP
+#pragma omp critical (amrex_tinyprofiler)
+#endif
+        improperly_nested_timers.insert(Name(id));
+    }
+
+    tid = -1;
+}
 
-        stats.clear();
+bool
+TinyProfiler::ReadCounters (ThreadStats& ts, std::array<double,NCounters>& c)
+{
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    if (!ts.perf_tried) {
+        ts.perf_tried = true;
+        ts.perf_fds = perf_open_group(perf_kind);
+    }
+    if (ts.perf_fds.empty()) return false;
+
+    std::uint64_t buf[1+nevents];  // the number of events, then the values
+    if (read(ts.perf_fds[0], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) {
+        return false;
+    }
+    for (int k = 0; k < nevents; ++k) {
+        c[k] = static_cast<double>(buf[1+k]);
     }
+    c[nevents] = static_cast<double>(ts.cells);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+TinyProfiler::InitParams ()
+{
+    ParmParse pp("tiny_profiler");
+    int use_counters = 0;
+    pp.query("perf_counters", use_counters);
+    if (!use_counters || threadstats.empty()) return;
+
+#ifdef AMREX_TINY_PROFILER_USE_PERF
+    // The hardware events are often not available in virtual machines.
+    for (int kind = 1; kind <= 2 && perf_kind == 0; ++kind) {
+        std::vector<int> fds = perf_open_group(kind);
+        if (!fds.empty()) {
+            perf_kind = kind;
+            threadstats[0]->perf_fds = fds;
+            threadstats[0]->perf_tried = true;
+        }
+    }
+#endif
+
+    // All the processes must count the same events.
+    int kind_min = (perf_kind == 0) ? 3 : perf_kind;
+    int kind_max = kind_min;
+    ParallelDescriptor::ReduceIntMin(kind_min);
+    ParallelDescriptor::ReduceIntMax(kind_max);
+    if (kind_max == 3 || kind_min != kind_max) {
+        perf_close_group(threadstats[0]->perf_fds);
+        perf_kind = 0;
+        amrex::Print() << "TinyProfiler: perf_event_open failed, "
+                       << "tiny_profiler.perf_counters is ignored\n";
+        return;
+    }
+    if (perf_kind == 2) {
+        amrex::Print() << "TinyProfiler: hardware events are not available, "
+                       << "counting software events\n";
+    }
+    perf_counters = true;
+}
+
+void
+TinyProfiler::AddCells (long ncells)
+{
+    if (!perf_counters) return;
+    const int t_id = thread_num();
+    if (t_id < 0 || t_id >= static_cast<int>(threadstats.size())) return;
+    threadstats[t_id]->cells += ncells;
 }
 
 void
 TinyProfiler::Initialize ()
 {
-    regionstack.push_back(mainregion);
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    main_thread = std::this_thread::get_id();
+    regionnames.assign(1, mainregion);
+    regionstack.assign(1, 0);
+    for (auto& ts : threadstats) {
+        perf_close_group(ts->perf_fds);
+    }
+    threadstats.clear();
+    for (int i = 0; i < nthreads; ++i) {
+        threadstats.emplace_back(new ThreadStats);
+        threadstats.back()->stats.resize(1);
+    }
     t_init = amrex::second();
+    tick_init = ticks();
+    finalized = false;
 }
 
 void
 TinyProfiler::Finalize (bool bFlushing)
 {
-    static bool finalized = false;
     if (!bFlushing) {		// If flushing, don't make this the last time!
       if (finalized) {
         return;
@@ -155,9 +482,33 @@ TinyProfiler::Finalize (bool bFlushing)
     }
 
     double t_final = amrex::second();
+    double tick_final = ticks();
+    const double sec_per_tick = (tick_final > tick_init)
+        ? (t_final - t_init) / (tick_final - tick_init) : 0.0;
 
     // make a local copy so that any functions call after this will not be recorded in the local copy.
-    auto lstatsmap = statsmap;
+    // For each region and name, there is one Stats per thread.
+    const int nthreads = threadstats.size();
+    std::map<std::string,std::map<std::string,std::vector<Stats> > > lstatsmap;
+    for (int r = 0, nr = regionnames.size(); r < nr; ++r)
+    {
+        auto& regstats = lstatsmap[regionnames[r]];
+        for (int t = 0; t < nthreads; ++t)
+        {
+            const std::vector<Stats>& thrstats = threadstats[t]->stats[r];
+            for (int i = 0, ni = thrstats.size(); i < ni; ++i)
+            {
+                if (thrstats[i].n > 0 || thrstats[i].depth > 0)
+                {
+                    auto& v = regstats[Name(i)];
+                    v.resize(nthreads);
+                    v[t] = thrstats[i];
+                    v[t].dtin *= sec_per_tick;
+                    v[t].dtex *= sec_per_tick;
+                }
+            }
+        }
+    }
 
     bool properly_nested = improperly_nested_timers.size() == 0;
     ParallelDescriptor::ReduceBoolAnd(properly_nested);
@@ -214,7 +565,7 @@ TinyProfiler::Finalize (bool bFlushing)
         if (!alreadySynced) {
             for (auto const& s : syncedRegions) {
                 if (lstatsmap.find(s) == lstatsmap.end()) {
-                    lstatsmap.insert(std::make_pair(s,std::map<std::string,Stats>()));
+                    lstatsmap.insert(std::make_pair(s,std::map<std::string,std::vector<Stats> >()));
                 }
             }
         }
@@ -228,10 +579,18 @@ TinyProfiler::Finalize (bool bFlushing)
             amrex::Print() << "END REGION " << kv.first << "\n";
         }
     }
+
+    if (!bFlushing) {
+        for (auto& ts : threadstats) {
+            perf_close_group(ts->perf_fds);
+        }
+        perf_counters = false;
+        perf_kind = 0;
+    }
 }
 
 void
-TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
+TinyProfiler::PrintStats (std::map<std::string,std::vector<Stats> >& regstats, double dt_max)
 {
     // make sure the set of profiled functions is the same on all processes
     {
@@ -247,7 +606,7 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
         if (! alreadySynced) {  // add the new name
             for (auto const& s : syncedStrings) {
                 if (regstats.find(s) == regstats.end()) {
-                    regstats.insert(std::make_pair(s, Stats()));
+                    regstats.insert(std::make_pair(s, std::vector<Stats>(threadstats.size())));
                 }
             }
         }
@@ -259,14 +618,29 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
     int ioproc = ParallelDescriptor::IOProcessorNumber();
 
     std::vector<ProcStats> allprocstats;
+    std::vector<ThreadProcStats> allthreadstats;
+    std::vector<CounterStats> allcntstats;
     int maxfnamelen = 0;
     long maxncalls = 0;
 
     // now collect global data onto the ioproc
     for (auto it = regstats.cbegin(); it != regstats.cend(); ++it)
     {
-	long n = it->second.n;
-	double dts[2] = {it->second.dtin, it->second.dtex};
+        // the master thread
+	long n = it->second[0].n;
+	double dts[2] = {it->second[0].dtin, it->second[0].dtex};
+
+        // inclusive time over all the threads
+        double thr[5] = {0.0, std::numeric_limits<double>::max(), 0.0, 0.0, 1.0};
+        for (auto const& st : it->second) {
+            if (st.n > 0) thr[0] += 1.0;
+            thr[1]  = std::min(thr[1], st.dtin);
+            thr[2] +=                  st.dtin;
+            thr[3]  = std::max(thr[3], st.dtin);
+        }
+        thr[2] /= it->second.size();
+        if (thr[2] > 0.0) thr[4] = thr[3]/thr[2];
+        std::vector<double> allthr(5*nprocs);
 
 	std::vector<long> ncalls(nprocs);
 	std::vector<double> dtdt(2*nprocs);
@@ -275,9 +649,11 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 	    ncalls[0] = n;
 	    dtdt[0] = dts[0];
 	    dtdt[1] = dts[1];
+            std::copy(thr, thr+5, allthr.begin());
 	} else {
 	    ParallelDescriptor::Gather(&n, 1, &ncalls[0], 1, ioproc);
 	    ParallelDescriptor::Gather(dts, 2, &dtdt[0], 2, ioproc);
+	    ParallelDescriptor::Gather(thr, 5, &allthr[0], 5, ioproc);
 	}
 
 	if (ParallelDescriptor::IOProcessor()) {
@@ -301,7 +677,41 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 	    allprocstats.push_back(pst);
 	    maxfnamelen = std::max(maxfnamelen, int(pst.fname.size()));
 	    maxncalls = std::max(maxncalls, pst.nmax);
+
+            ThreadProcStats tst;
+            for (int i = 0; i < nprocs; ++i) {
+                tst.nthreads  = std::max(tst.nthreads, int(allthr[5*i]));
+                tst.dtmin     = std::min(tst.dtmin,    allthr[5*i+1]);
+                tst.dtavg    +=                        allthr[5*i+2];
+                tst.dtmax     = std::max(tst.dtmax,    allthr[5*i+3]);
+                tst.imbalance = std::max(tst.imbalance,allthr[5*i+4]);
+            }
+            tst.dtavg /= nprocs;
+            tst.fname = it->first;
+            if (tst.nthreads > 1) {
+                allthreadstats.push_back(tst);
+            }
 	}
+
+        if (perf_counters)
+        {
+            // counts summed over the threads and the processes
+            double cnt[NCounters+1] = {0.0};
+            for (auto const& st : it->second) {
+                for (int k = 0; k < NCounters; ++k) {
+                    cnt[k] += st.cnt[k];
+                }
+                cnt[NCounters] += st.n;
+            }
+            ParallelReduce::Sum(cnt, NCounters+1, ioproc, ParallelDescriptor::Communicator());
+            if (ParallelDescriptor::IOProcessor()) {
+                CounterStats cst;
+                std::copy(cnt, cnt+NCounters, cst.cnt.begin());
+                cst.n = static_cast<long>(cnt[NCounters]);
+                cst.fname = it->first;
+                allcntstats.push_back(cst);
+            }
+        }
     }
 
     if (ParallelDescriptor::IOProcessor())
@@ -373,6 +783,100 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 	}
 	amrex::OutStream() << hline << "\n";
 
+        // Inclusive time per thread, for the functions called by more than one thread
+        if (!allthreadstats.empty())
+        {
+            int wn = std::max(int(std::log10(double(threadstats.size())))+1,
+                              int(std::string("NThreads").size()));
+            int wi = std::max(6, int(std::string("Imbal.").size()));
+            const std::string thline(maxfnamelen+wn+2+(wt+2)*3+wi+2,'-');
+
+            std::sort(allthreadstats.begin(), allthreadstats.end(), ThreadProcStats::compmax);
+            amrex::OutStream() << "\n" << thline << "\n";
+            amrex::OutStream() << std::left
+                      << std::setw(maxfnamelen) << "Name"
+                      << std::right
+                      << std::setw(wn+2) << "NThreads"
+                      << std::setw(wt+2) << "Thrd. Min"
+                      << std::setw(wt+2) << "Thrd. Avg"
+                      << std::setw(wt+2) << "Thrd. Max"
+                      << std::setw(wi+2) << "Imbal."
+                      << "\n" << thline << "\n";
+            for (auto it = allthreadstats.cbegin(); it != allthreadstats.cend(); ++it)
+            {
+                amrex::OutStream() << std::setprecision(4) << std::left
+                          << std::setw(maxfnamelen) << it->fname
+                          << std::right
+                          << std::setw(wn+2) << it->nthreads
+                          << std::setw(wt+2) << it->dtmin
+                          << std::setw(wt+2) << it->dtavg
+                          << std::setw(wt+2) << it->dtmax
+                          << std::setprecision(2) << std::setw(wi+2) << std::fixed
+                          << it->imbalance;
+                amrex::OutStream().unsetf(std::ios_base::fixed);
+                amrex::OutStream() << "\n";
+            }
+            amrex::OutStream() << thline << "\n";
+        }
+
+        // Event counts, for all the threads and processes
+        if (!allcntstats.empty())
+        {
+            const char** names = (perf_kind == 1) ? hw_event_names : sw_event_names;
+            const long linesize = llc_line_size();
+
+            long maxn = 1;
+            for (auto const& cst : allcntstats) maxn = std::max(maxn, cst.n);
+            int wn = std::max(int(std::log10(double(maxn)))+1, int(std::string("NCalls").size()));
+            int wc = 11;
+            for (int k = 0; k < nevents; ++k) {
+                wc = std::max(wc, int(std::string(names[k]).size()));
+            }
+            const int ncols = (perf_kind == 1) ? nevents+3 : nevents+1;
+            const std::string chline(maxfnamelen+wn+2+(wc+2)*ncols,'-');
+
+            std::sort(allcntstats.begin(), allcntstats.end(), CounterStats::compfirst);
+            amrex::OutStream() << "\n" << chline << "\n";
+            amrex::OutStream() << std::left
+                      << std::setw(maxfnamelen) << "Name"
+                      << std::right
+                      << std::setw(wn+2) << "NCalls";
+            for (int k = 0; k < nevents; ++k) {
+                amrex::OutStream() << std::setw(wc+2) << names[k];
+            }
+            if (perf_kind == 1) amrex::OutStream() << std::setw(wc+2) << "IPC";
+            amrex::OutStream() << std::setw(wc+2) << "Cells";
+            if (perf_kind == 1) amrex::OutStream() << std::setw(wc+2) << "Bytes/Cell";
+            amrex::OutStream() << "\n" << chline << "\n";
+            for (auto it = allcntstats.cbegin(); it != allcntstats.cend(); ++it)
+            {
+                amrex::OutStream() << std::setprecision(4) << std::left
+                          << std::setw(maxfnamelen) << it->fname
+                          << std::right
+                          << std::setw(wn+2) << it->n;
+                for (int k = 0; k < nevents; ++k) {
+                    amrex::OutStream() << std::setw(wc+2) << it->cnt[k];
+                }
+                if (perf_kind == 1) {
+                    // cycles and instructions
+                    double ipc = (it->cnt[0] > 0.0) ? it->cnt[1]/it->cnt[0] : 0.0;
+                    amrex::OutStream() << std::setw(wc+2) << ipc;
+                }
+                amrex::OutStream() << std::setw(wc+2) << it->cnt[nevents];
+                if (perf_kind == 1) {
+                    // the last level cache misses are the lines brought in from memory
+                    if (it->cnt[nevents] > 0.0) {
+                        amrex::OutStream() << std::setw(wc+2)
+                                           << it->cnt[2]*linesize/it->cnt[nevents];
+                    } else {
+                        amrex::OutStream() << std::setw(wc+2) << "-";
+                    }
+                }
+                amrex::OutStream() << "\n";
+            }
+            amrex::OutStream() << chline << "\n";
+        }
+
 	amrex::OutStream() << std::endl;
     }
 }
@@ -380,15 +884,24 @@ TinyProfiler::PrintStats (std::map<std::string,Stats>& regstats, double dt_max)
 void
 TinyProfiler::StartRegion (std::string regname)
 {
-    if (std::find(regionstack.begin(), regionstack.end(), regname) == regionstack.end()) {
-        regionstack.emplace_back(std::move(regname));
+    if (threadstats.empty()) return;
+
+    int r = std::find(regionnames.begin(), regionnames.end(), regname) - regionnames.begin();
+    if (r == static_cast<int>(regionnames.size())) {
+        regionnames.emplace_back(std::move(regname));
+        for (auto& ts : threadstats) {
+            ts->stats.resize(regionnames.size());
+        }
+    }
+    if (std::find(regionstack.begin(), regionstack.end(), r) == regionstack.end()) {
+        regionstack.push_back(r);
     }
 }
 
 void
 TinyProfiler::StopRegion (const std::string& regname)
 {
-    if (regname == regionstack.back()) {
+    if (!regionstack.empty() && regname == regionnames[regionstack.back()]) {
         regionstack.pop_back();
     }
 }
@@ -6,17 +6,25 @@
 #include <vector>
 #include <deque>
 #include <cerrno>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <AMReX_ccse-mpi.H>
 #include <AMReX_Utility.H>
 #include <AMReX_VisMF.H>
 #include <AMReX_ParmParse.H>
 #include <AMReX_NFiles.H>
+#include <AMReX_ParallelReduce.H>
 #include <AMReX_FPC.H>
 
 namespace amrex {
 
 static const char *TheMultiFabHdrFileSuffix = "_H";
+static const char *TheBinaryHdrFileSuffix = "_HB";
 static const char *FabFileSuffix = "_D_";
 static const char *TheFabOnDiskPrefix = "FabOnDisk:";
 
@@ -32,6 +40,7 @@ bool VisMF::checkFilePositions(false);
 bool VisMF::usePersistentIFStreams(false);
 bool VisMF::useSynchronousReads(false);
 bool VisMF::useDynamicSetSelection(true);
+bool VisMF::useLocalHeaderRead(false);
 bool VisMF::allowSparseWrites(true);
 
 long VisMF::ioBufferSize(VisMF::IO_Buffer_Size);
@@ -46,6 +55,123 @@ int VisMF::nMFFileInStreams(4);
 namespace
 {
     bool initialized = false;
+
+    //
+    // The binary header of NoFabHeaderBinary_v1 is a prologue of
+    // nBinaryPrologue int64s followed by one fixed-width record per fab:
+    //
+    //   int64  smallEnd[SPACEDIM], bigEnd[SPACEDIM], type[SPACEDIM]
+    //   int64  file number (index into Header::m_fileNames), file offset
+    //   double min[ncomp], max[ncomp]
+    //
+    // Everything is in native byte order; the magic number catches files
+    // written on a machine with the other order.
+    //
+    enum BinaryPrologue { bpMagic = 0, bpNBoxes, bpNComp, bpSpaceDim, bpRecordBytes,
+                          nBinaryPrologue = 8 };
+    const std::int64_t TheBinaryHeaderMagic(0x31764248584d4121);
+    const long nRecordInts(3*AMREX_SPACEDIM + 2);
+
+    long BinaryRecordBytes (int ncomp)
+    {
+        return nRecordInts*sizeof(std::int64_t) + 2*ncomp*sizeof(double);
+    }
+
+    //
+    // The distinct file names of the fabs in order of first appearance,
+    // and the index into that list of each fab.
+    //
+    void FileNameTable (const Vector<VisMF::FabOnDisk> &fod,
+                        Vector<std::string> &fileNames, Vector<int> &fileNumbers)
+    {
+        std::map<std::string, int> nameIndex;
+        fileNames.clear();
+        fileNumbers.resize(fod.size());
+        for(int i(0); i < fod.size(); ++i) {
+          auto it = nameIndex.find(fod[i].m_name);
+          if(it == nameIndex.end()) {
+            it = nameIndex.insert(std::make_pair(fod[i].m_name, int(fileNames.size()))).first;
+            fileNames.push_back(fod[i].m_name);
+          }
+          fileNumbers[i] = it->second;
+        }
+    }
+
+    //
+    // Check the prologue against the ASCII part of the header and return
+    // the number of records.
+    //
+    long CheckBinaryPrologue (const char *data, long nBytes, const std::string &fileName,
+                              const VisMF::Header &hdr)
+    {
+        std::int64_t prologue[nBinaryPrologue];
+        if(nBytes < static_cast<long>(sizeof(prologue))) {
+          amrex::Abort("VisMF:  binary header too short:  " + fileName);
+        }
+        std::memcpy(prologue, data, sizeof(prologue));
+        if(prologue[bpMagic] != TheBinaryHeaderMagic) {
+          amrex::Abort("VisMF:  bad binary header magic number:  " + fileName);
+        }
+        const long nBoxes(prologue[bpNBoxes]);
+        if(prologue[bpNComp] != hdr.m_ncomp ||
+           prologue[bpSpaceDim] != AMREX_SPACEDIM ||
+           prologue[bpRecordBytes] != BinaryRecordBytes(hdr.m_ncomp) ||
+           nBoxes != hdr.m_fod.size() ||
+           nBytes < static_cast<long>(sizeof(prologue)) + nBoxes * BinaryRecordBytes(hdr.m_ncomp))
+        {
+          amrex::Abort("VisMF:  binary header does not match the header:  " + fileName);
+        }
+        return nBoxes;
+    }
+
+    void PackRecord (char *rec, const Box &b, int fileNumber, long offset,
+                     const Real *mins, const Real *maxs, int ncomp)
+    {
+        std::int64_t ints[nRecordInts];
+        for(int d(0); d < AMREX_SPACEDIM; ++d) {
+          ints[d]                    = b.smallEnd(d);
+          ints[d +   AMREX_SPACEDIM] = b.bigEnd(d);
+          ints[d + 2*AMREX_SPACEDIM] = b.type(d);
+        }
+        ints[3*AMREX_SPACEDIM]     = fileNumber;
+        ints[3*AMREX_SPACEDIM + 1] = offset;
+        std::memcpy(rec, ints, sizeof(ints));
+        rec += sizeof(ints);
+        for(int n(0); n < ncomp; ++n) {
+          double mm[2] = { double(mins[n]), double(maxs[n]) };
+          std::memcpy(rec + n*sizeof(double), &mm[0], sizeof(double));
+          std::memcpy(rec + (ncomp + n)*sizeof(double), &mm[1], sizeof(double));
+        }
+    }
+
+    Box UnpackRecord (const char *rec, VisMF::Header &hdr, int idx)
+    {
+        std::int64_t ints[nRecordInts];
+        std::memcpy(ints, rec, sizeof(ints));
+        rec += sizeof(ints);
+        IntVect lo, hi, typ;
+        for(int d(0); d < AMREX_SPACEDIM; ++d) {
+          lo[d]  = ints[d];
+          hi[d]  = ints[d +   AMREX_SPACEDIM];
+          typ[d] = ints[d + 2*AMREX_SPACEDIM];
+        }
+        const int fileNumber(ints[3*AMREX_SPACEDIM]);
+        BL_ASSERT(fileNumber >= 0 && fileNumber < hdr.m_fileNames.size());
+        hdr.m_fod[idx].m_name = hdr.m_fileNames[fileNumber];
+        hdr.m_fod[idx].m_head = ints[3*AMREX_SPACEDIM + 1];
+
+        const int ncomp(hdr.m_ncomp);
+        hdr.m_min[idx].resize(ncomp);
+        hdr.m_max[idx].resize(ncomp);
+        for(int n(0); n < ncomp; ++n) {
+          double mn, mx;
+          std::memcpy(&mn, rec + n*sizeof(double), sizeof(double));
+          std::memcpy(&mx, rec + (ncomp + n)*sizeof(double), sizeof(double));
+          hdr.m_min[idx][n] = mn;
+          hdr.m_max[idx][n] = mx;
+        }
+        return Box(lo, hi, typ);
+    }
 }
 
 void
@@ -80,6 +206,7 @@ VisMF::Initialize ()
     pp.query("usepersistentifstreams", usePersistentIFStreams);
     pp.query("usesynchronousreads", useSynchronousReads);
     pp.query("usedynamicsetselection", useDynamicSetSelection);
+    pp.query("uselocalheaderread", useLocalHeaderRead);
     pp.query("iobuffersize", ioBufferSize);
     pp.query("allowsparsewrites", allowSparseWrites);
 
@@ -277,9 +404,21 @@ operator<< (std::ostream        &os,
         os << hd.m_ngrow    << '\n';
     }
 
-    hd.m_ba.writeOn(os); os << '\n';
+    if(hd.m_vers == VisMF::Header::NoFabHeaderBinary_v1) {
+      // ---- the boxes, fab offsets and fab mins and maxes are in the binary header
+      Vector<std::string> fileNames;
+      Vector<int> fileNumbers;
+      FileNameTable(hd.m_fod, fileNames, fileNumbers);
+      os << hd.m_ba.size() << '\n';
+      os << fileNames.size() << '\n';
+      for(int i(0); i < fileNames.size(); ++i) {
+        os << fileNames[i] << '\n';
+      }
+    } else {
+      hd.m_ba.writeOn(os); os << '\n';
 
-    os << hd.m_fod      << '\n';
+      os << hd.m_fod      << '\n';
+    }
 
     if(hd.m_vers == VisMF::Header::Version_v1 ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
@@ -288,7 +427,9 @@ operator<< (std::ostream        &os,
       os << hd.m_max      << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::NoFabHeaderBinary_v1)
+    {
       BL_ASSERT(hd.m_famin.size() == hd.m_ncomp);
       BL_ASSERT(hd.m_famin.size() == hd.m_famax.size());
       for(int i(0); i < hd.m_famin.size(); ++i) {
@@ -301,9 +442,7 @@ operator<< (std::ostream        &os,
       os << '\n';
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(VisMF::NoFabHeader(hd))
     {
       if(FArrayBox::getFormat() == FABio::FAB_NATIVE) {
         os << FPC::NativeRealDescriptor() << '\n';
@@ -357,13 +496,27 @@ operator>> (std::istream  &is,
     }
     BL_ASSERT(hd.m_ngrow.min() >= 0);
 
-    int ba_ndims = hd.m_ba.readFrom(is);
-    for (int i = ba_ndims; i < AMREX_SPACEDIM; ++i) {
-        hd.m_ngrow[i] = 0;
-    }
+    if(hd.m_vers == VisMF::Header::NoFabHeaderBinary_v1) {
+      // ---- m_ba, m_fod, m_min and m_max are filled by VisMF::ReadBinaryHeader
+      long nBoxes;
+      int nFiles;
+      is >> nBoxes >> nFiles;
+      BL_ASSERT(nBoxes >= 0 && nFiles >= 0);
+      hd.m_fileNames.resize(nFiles);
+      for(int i(0); i < nFiles; ++i) {
+        is >> hd.m_fileNames[i];
+      }
+      hd.m_ba = BoxArray();
+      hd.m_fod.resize(nBoxes);
+    } else {
+      int ba_ndims = hd.m_ba.readFrom(is);
+      for (int i = ba_ndims; i < AMREX_SPACEDIM; ++i) {
+          hd.m_ngrow[i] = 0;
+      }
 
-    is >> hd.m_fod;
-    BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
+      is >> hd.m_fod;
+      BL_ASSERT(hd.m_ba.size() == hd.m_fod.size());
+    }
 
     if(hd.m_vers == VisMF::Header::Version_v1 ||
        hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1)
@@ -374,7 +527,9 @@ operator>> (std::istream  &is,
       BL_ASSERT(hd.m_ba.size() == hd.m_max.size());
     }
 
-    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1) {
+    if(hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+       hd.m_vers == VisMF::Header::NoFabHeaderBinary_v1)
+    {
       char ch;
       hd.m_famin.resize(hd.m_ncomp);
       hd.m_famax.resize(hd.m_ncomp);
@@ -391,9 +546,7 @@ operator>> (std::istream  &is,
 	}
       }
     }
-    if(hd.m_vers == VisMF::Header::NoFabHeader_v1       ||
-       hd.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-       hd.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    if(VisMF::NoFabHeader(hd))
     {
       is >> hd.m_writtenRD;
     }
@@ -898,11 +1051,151 @@ VisMF::WriteHeader (const std::string &mf_name,
 	  }
 	}
 
+        if(hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1) {
+          bytesWritten += VisMF::WriteBinaryHeader(mf_name, hdr);
+        }
+
     }
     return bytesWritten;
 }
 
 
+long
+VisMF::WriteBinaryHeader (const std::string &mf_name,
+                          const VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::WriteBinaryHeader");
+
+    Vector<std::string> fileNames;
+    Vector<int> fileNumbers;
+    FileNameTable(hdr.m_fod, fileNames, fileNumbers);
+
+    const long nBoxes(hdr.m_ba.size());
+    const int  nComp(hdr.m_ncomp);
+    const long recordBytes(BinaryRecordBytes(nComp));
+    BL_ASSERT(nComp == 0 || hdr.m_min.size() == nBoxes);
+
+    std::int64_t prologue[nBinaryPrologue] = { 0 };
+    prologue[bpMagic]       = TheBinaryHeaderMagic;
+    prologue[bpNBoxes]      = nBoxes;
+    prologue[bpNComp]       = nComp;
+    prologue[bpSpaceDim]    = AMREX_SPACEDIM;
+    prologue[bpRecordBytes] = recordBytes;
+
+    Vector<char> buffer(sizeof(prologue) + nBoxes * recordBytes);
+    std::memcpy(buffer.dataPtr(), prologue, sizeof(prologue));
+    char *records = buffer.dataPtr() + sizeof(prologue);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(long i = 0; i < nBoxes; ++i) {
+      PackRecord(records + i * recordBytes, hdr.m_ba[i], fileNumbers[i], hdr.m_fod[i].m_head,
+                 nComp > 0 ? hdr.m_min[i].dataPtr() : nullptr,
+                 nComp > 0 ? hdr.m_max[i].dataPtr() : nullptr, nComp);
+    }
+
+    std::string BinHdrFileName(mf_name + TheBinaryHdrFileSuffix);
+    std::ofstream BinHdrFile(BinHdrFileName.c_str(),
+                             std::ios::out | std::ios::trunc | std::ios::binary);
+    if( ! BinHdrFile.good()) {
+        amrex::FileOpenFailed(BinHdrFileName);
+    }
+    BinHdrFile.write(buffer.dataPtr(), buffer.size());
+    BinHdrFile.close();
+    if( ! BinHdrFile.good()) {
+        amrex::Error("Write of VisMF binary header failed");
+    }
+
+    return buffer.size();
+}
+
+
+void
+VisMF::ReadBinaryHeader (const std::string &mf_name,
+                         VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::ReadBinaryHeader()");
+    BL_ASSERT(hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1);
+
+    std::string BinHdrFileName(mf_name + TheBinaryHdrFileSuffix);
+    Vector<char> buffer;
+    ParallelDescriptor::ReadAndBcastFile(BinHdrFileName, buffer);
+
+    // ---- ReadAndBcastFile adds a trailing null
+    const long nBoxes(CheckBinaryPrologue(buffer.dataPtr(), buffer.size() - 1,
+                                          BinHdrFileName, hdr));
+    const long recordBytes(BinaryRecordBytes(hdr.m_ncomp));
+    const char *records = buffer.dataPtr() + nBinaryPrologue * sizeof(std::int64_t);
+
+    Vector<Box> boxes(nBoxes);
+    hdr.m_min.resize(nBoxes);
+    hdr.m_max.resize(nBoxes);
+
+    // ---- the records are independent, so they can be parsed in parallel
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(long i = 0; i < nBoxes; ++i) {
+      boxes[i] = UnpackRecord(records + i * recordBytes, hdr, i);
+    }
+
+    hdr.m_ba = BoxArray(BoxList(std::move(boxes)));
+}
+
+
+void
+VisMF::ReadBinaryHeader (const std::string &mf_name,
+                         VisMF::Header &hdr,
+                         const BoxArray &ba,
+                         const Vector<int> &indices)
+{
+    BL_PROFILE("VisMF::ReadBinaryHeader(local)");
+    BL_ASSERT(hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1);
+
+    std::string BinHdrFileName(mf_name + TheBinaryHdrFileSuffix);
+
+    int fd(open(BinHdrFileName.c_str(), O_RDONLY));
+    if(fd < 0) {
+      amrex::FileOpenFailed(BinHdrFileName);
+    }
+    struct stat statBuf;
+    if(fstat(fd, &statBuf) != 0) {
+      amrex::FileOpenFailed(BinHdrFileName);
+    }
+    const long nBytes(statBuf.st_size);
+
+    // ---- only the pages holding our records are read from the file
+    void *mapped = mmap(nullptr, nBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED) {
+      amrex::Abort("VisMF::ReadBinaryHeader:  mmap failed for " + BinHdrFileName
+                   + ":  " + strerror(errno));
+    }
+    const char *data = static_cast<const char *>(mapped);
+
+    const long nBoxes(CheckBinaryPrologue(data, nBytes, BinHdrFileName, hdr));
+    if(nBoxes != ba.size()) {
+      amrex::Abort("VisMF::ReadBinaryHeader:  BoxArray size mismatch for " + BinHdrFileName);
+    }
+    const long recordBytes(BinaryRecordBytes(hdr.m_ncomp));
+    const char *records = data + nBinaryPrologue * sizeof(std::int64_t);
+
+    hdr.m_ba = ba;
+    hdr.m_min.resize(nBoxes);
+    hdr.m_max.resize(nBoxes);
+
+    for(int i(0); i < indices.size(); ++i) {
+      const int idx(indices[i]);
+      if(UnpackRecord(records + idx * recordBytes, hdr, idx) != ba[idx]) {
+        amrex::Abort("VisMF::ReadBinaryHeader:  box mismatch in " + BinHdrFileName);
+      }
+    }
+
+    munmap(mapped, nBytes);
+}
+
+
 long
 VisMF::Write (const FabArray<FArrayBox>&    mf,
               const std::string& mf_name,
@@ -1061,7 +1354,8 @@ VisMF::Write (const FabArray<FArrayBox>&    mf,
     }
 
     if(currentVersion == VisMF::Header::Version_v1 ||
-       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1)
+       currentVersion == VisMF::Header::NoFabHeaderMinMax_v1 ||
+       currentVersion == VisMF::Header::NoFabHeaderBinary_v1)
     {
       hdr.CalculateMinMax(mf, coordinatorProc);
     }
@@ -1292,6 +1586,8 @@ VisMF::RemoveFiles(const std::string &mf_name, bool verbose)
 	            << strerror(errno) << std::endl;
         }
       }
+      // ---- only there for NoFabHeaderBinary_v1
+      std::remove((mf_name + TheBinaryHdrFileSuffix).c_str());
       for(int ip(0); ip < nOutFiles; ++ip) {
         std::string fileName(NFilesIter::FileName(nOutFiles, mf_name + FabFileSuffix, ip, true));
         if(verbose) {
@@ -1324,6 +1620,10 @@ VisMF::VisMF (const std::string &fafab_name)
 
     infs >> m_hdr;
 
+    if(m_hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1) {
+        VisMF::ReadBinaryHeader(m_fafabname, m_hdr);
+    }
+
     m_pa.resize(m_hdr.m_ncomp);
 
     for(int n(0); n < m_pa.size(); ++n) {
@@ -1427,6 +1727,77 @@ VisMF::readFAB (FabArray<FArrayBox> &mf,
 }
 
 
+void
+VisMF::ReadLocalFABs (FabArray<FArrayBox> &mf,
+                      const std::string   &mf_name,
+                      const VisMF::Header &hdr)
+{
+    BL_PROFILE("VisMF::ReadLocalFABs()");
+
+    // ---- our fabs in each data file, in file order
+    const int nFiles(hdr.m_fileNames.size());
+    std::map<std::string, int> fileIndex;
+    for(int i(0); i < nFiles; ++i) {
+      fileIndex[hdr.m_fileNames[i]] = i;
+    }
+    Vector<std::map<long, int> > myReads(nFiles);  // ---- [file]<seek, index>
+    for(MFIter mfi(mf); mfi.isValid(); ++mfi) {
+      const int idx(mfi.index());
+      myReads[fileIndex[hdr.m_fod[idx].m_name]][hdr.m_fod[idx].m_head] = idx;
+    }
+
+#ifdef BL_USE_MPI
+    // ---- which ranks read which files
+    const int nProcs(ParallelDescriptor::NProcs());
+    const int myProc(ParallelDescriptor::MyProc());
+    Vector<int> myFiles(nFiles), allFiles(nFiles * nProcs);
+    for(int f(0); f < nFiles; ++f) {
+      myFiles[f] = ! myReads[f].empty();
+    }
+    ParallelAllGather::AllGather(myFiles.dataPtr(), nFiles, allFiles.dataPtr(),
+                                 ParallelDescriptor::Communicator());
+
+    // ---- the readers of a file are dealt out to nMFFileInStreams chains,
+    // ---- the ranks of a chain read one after another.  All ranks go
+    // ---- through the files in the same order, so the chains cannot block
+    // ---- each other.
+    for(int f(0); f < nFiles; ++f) {
+      if(myReads[f].empty()) {
+        continue;
+      }
+      Vector<int> fileRanks;
+      int myIndex(-1);
+      for(int p(0); p < nProcs; ++p) {
+        if(allFiles[p * nFiles + f]) {
+          if(p == myProc) {
+            myIndex = fileRanks.size();
+          }
+          fileRanks.push_back(p);
+        }
+      }
+      const int nStreams(std::min<int>(fileRanks.size(), nMFFileInStreams));
+      Vector<int> readRanks;
+      for(int i(myIndex % nStreams); i < static_cast<int>(fileRanks.size()); i += nStreams) {
+        readRanks.push_back(fileRanks[i]);
+      }
+
+      std::string fullFileName(VisMF::DirName(mf_name) + hdr.m_fileNames[f]);
+      for(NFilesIter nfi(fullFileName, readRanks, false); nfi.ReadyToRead(); ++nfi) {
+        for(auto &r : myReads[f]) {
+          VisMF::readFAB(mf, r.second, mf_name, hdr);
+        }
+      }
+    }
+#else
+    for(int f(0); f < nFiles; ++f) {
+      for(auto &r : myReads[f]) {
+        VisMF::readFAB(mf, r.second, mf_name, hdr);
+      }
+    }
+#endif
+}
+
+
 void
 VisMF::Read (FabArray<FArrayBox> &mf,
              const std::string   &mf_name,
@@ -1441,6 +1812,7 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     static Real totalTime(0.0);
     int myProc(ParallelDescriptor::MyProc());
     int messTotal(0);
+    bool localHeader(false);
 
     if(verbose && myProc == coordinatorProc) {
         amrex::AllPrint() << myProc << "::VisMF::Read:  about to read:  " << mf_name << std::endl;
@@ -1462,6 +1834,15 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 
         infs >> hdr;
 
+        if(hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1) {
+          if(useLocalHeaderRead && ! mf.empty()) {
+            VisMF::ReadBinaryHeader(mf_name, hdr, mf.boxArray(), mf.IndexArray());
+            localHeader = true;
+          } else {
+            VisMF::ReadBinaryHeader(mf_name, hdr);
+          }
+        }
+
         hEndTime = amrex::second();
     }
 
@@ -1472,6 +1853,11 @@ VisMF::Read (FabArray<FArrayBox> &mf,
 	BL_ASSERT(amrex::match(hdr.m_ba,mf.boxArray()));
     }
 
+  if(localHeader) {
+    // ---- we only have the records of our own fabs, so read them ourselves
+    VisMF::ReadLocalFABs(mf, mf_name, hdr);
+  } else {
+
 #ifdef BL_USE_MPI
 
   // ---- This limits the number of concurrent readers per file.
@@ -1849,8 +2235,13 @@ VisMF::Read (FabArray<FArrayBox> &mf,
     }
 #endif
 
+  }
+
     if(VisMF::GetUsePersistentIFStreams()) {
       for(int idx(0); idx < hdr.m_fod.size(); ++idx) {
+        if(hdr.m_fod[idx].m_name.empty()) {
+          continue;
+        }
         std::string FullName(VisMF::DirName(mf_name));
         FullName += hdr.m_fod[idx].m_name;
         VisMF::DeleteStream(FullName);
@@ -2024,7 +2415,8 @@ VisMF::clear ()
 bool VisMF::NoFabHeader(const VisMF::Header &hdr) {
   if(hdr.m_vers == VisMF::Header::NoFabHeader_v1       ||
     hdr.m_vers == VisMF::Header::NoFabHeaderMinMax_v1 ||
-    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1)
+    hdr.m_vers == VisMF::Header::NoFabHeaderFAMinMax_v1 ||
+    hdr.m_vers == VisMF::Header::NoFabHeaderBinary_v1)
   {
     return true;
   }
@@ -0,0 +1,821 @@
+// ----------------------------------------------------------------------
+//  BLProfStreamParser.cpp
+// ----------------------------------------------------------------------
+#include <AMReX_BLProfStreamParser.H>
+#include <AMReX_Utility.H>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <limits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::string;
+
+int BLProfStreamParser::verbose(-1);
+
+
+namespace {
+
+// ----------------------------------------------------------------------
+// ---- one block of a data file.  the block is memory mapped while
+// ---- the object lives, or read if the mapping fails.
+// ----------------------------------------------------------------------
+class MappedBlock {
+  public:
+    MappedBlock(const std::string &filename, long seekpos, long nbytes)
+      : mapBase(nullptr), mapLength(0), data(nullptr), nBytes(nbytes)
+    {
+      if(nBytes <= 0) {
+        return;
+      }
+      int fd(open(filename.c_str(), O_RDONLY));
+      if(fd >= 0) {
+        struct stat fstatus;
+        if(fstat(fd, &fstatus) == 0 && seekpos + nBytes <= fstatus.st_size) {
+          long pageSize(sysconf(_SC_PAGESIZE));
+          long mapOffset(seekpos - (seekpos % pageSize));
+          mapLength = nBytes + (seekpos - mapOffset);
+          mapBase = mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, mapOffset);
+          if(mapBase == MAP_FAILED) {
+            mapBase = nullptr;
+          } else {
+            madvise(mapBase, mapLength, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(mapBase) + (seekpos - mapOffset);
+          }
+        }
+        close(fd);
+      }
+      if(data == nullptr) {  // ---- read it instead
+        std::ifstream instr(filename.c_str(), std::ios::in | std::ios::binary);
+        instr.seekg(seekpos);
+        buffer.resize(nBytes);
+        instr.read(buffer.data(), nBytes);
+        if(instr.good()) {
+          data = buffer.data();
+        } else {
+          cerr << "**** Error:  BLProfStreamParser:  cannot read " << nBytes
+               << " bytes at " << seekpos << " from " << filename << endl;
+        }
+      }
+    }
+
+    ~MappedBlock() {
+      if(mapBase != nullptr) {
+        munmap(mapBase, mapLength);
+      }
+    }
+
+    MappedBlock(const MappedBlock &) = delete;
+    MappedBlock &operator=(const MappedBlock &) = delete;
+
+    bool Ok() const { return nBytes <= 0 || data != nullptr; }
+
+    // ---- the i-th record of type T after byteOffset bytes.
+    // ---- copied because the block may not be aligned for T.
+    template <class T>
+    T Record(long byteOffset, long i) const {
+      T t;
+      std::memcpy(&t, data + byteOffset + i * sizeof(T), sizeof(T));
+      return t;
+    }
+
+  private:
+    void *mapBase;
+    size_t mapLength;
+    const char *data;
+    long nBytes;
+    std::vector<char> buffer;
+};
+
+
+// ----------------------------------------------------------------------
+bool ReadLines(const std::string &filename, Vector<std::string> &lines) {
+  std::ifstream instr(filename.c_str());
+  if( ! instr.good()) {
+    return false;
+  }
+  std::string line;
+  while(std::getline(instr, line)) {
+    lines.push_back(line);
+  }
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// ---- the name between the first and last quotes and what follows it.
+// ---- names may contain spaces and quotes.
+// ----------------------------------------------------------------------
+bool QuotedName(const std::string &line, std::string &name, std::string &rest) {
+  std::size_t first(line.find('"')), last(line.rfind('"'));
+  if(first == std::string::npos || last == first) {
+    return false;
+  }
+  name = line.substr(first + 1, last - first - 1);
+  rest = line.substr(last + 1);
+  return true;
+}
+
+
+// ----------------------------------------------------------------------
+// ---- function names are stored with spaces replaced, as in BLProfStats
+// ----------------------------------------------------------------------
+std::string SanitizedFName(std::string fname) {
+  std::replace(fname.begin(), fname.end(), ' ', '_');
+  return fname;
+}
+
+
+// ----------------------------------------------------------------------
+bool IsSend(BLProfiler::CommFuncType cft) {
+  return(cft == BLProfiler::AsendTsii  ||
+         cft == BLProfiler::AsendTsiiM ||
+         cft == BLProfiler::AsendvTii  ||
+	 cft == BLProfiler::SendTsii   ||
+	 cft == BLProfiler::SendvTii);
+}
+
+
+// ----------------------------------------------------------------------
+// ---- the spread over processes of one value per process
+// ----------------------------------------------------------------------
+struct ProcAccum {
+  ProcAccum()
+    : nCalls(0), sum(0.0), sumSq(0.0),
+      minVal(std::numeric_limits<Real>::max()),
+      maxVal(-std::numeric_limits<Real>::max())
+  { }
+
+  void Add(Real v) {
+    sum   += v;
+    sumSq += v * v;
+    minVal = std::min(minVal, v);
+    maxVal = std::max(maxVal, v);
+  }
+  void Merge(const ProcAccum &rhs) {
+    nCalls += rhs.nCalls;
+    sum    += rhs.sum;
+    sumSq  += rhs.sumSq;
+    minVal  = std::min(minVal, rhs.minVal);
+    maxVal  = std::max(maxVal, rhs.maxVal);
+  }
+  // ---- as CollectMProfStats
+  BLProfiler::ProfStats ToProfStats(int nProcs, Real runTime) const {
+    BLProfiler::ProfStats ps;
+    ps.nCalls    = nCalls;
+    ps.totalTime = sum;
+    ps.minTime   = std::min(runTime, minVal);
+    ps.maxTime   = std::max(static_cast<Real>(0.0), maxVal);
+    if(nProcs > 0) {
+      ps.avgTime  = sum / nProcs;
+      ps.variance = std::max(static_cast<Real>(0.0), sumSq / nProcs - ps.avgTime * ps.avgTime);
+    }
+    return ps;
+  }
+
+  long nCalls;  // ---- for whichProc only
+  Real sum, sumSq, minVal, maxVal;
+};
+
+}
+
+
+// ----------------------------------------------------------------------
+BLProfStreamParser::BLProfStreamParser(const std::string &dirname)
+  : dirName(dirname), dataNProcs(0),
+    bProfDataAvailable(false), bTraceDataAvailable(false), bCommDataAvailable(false),
+    calcEndTime(0.0),
+    traceTimeMin(std::numeric_limits<Real>::max()),
+    traceTimeMax(-std::numeric_limits<Real>::max())
+{
+  ReadBLProfHeader();
+  ReadCallStatsHeaders();
+  ReadCommHeaders();
+
+  // ---- the headers may not all have the same number of processes
+  blpDataBlocks.resize(dataNProcs);
+  fnameRemap.resize(dataNProcs);
+  callDataBlocks.resize(dataNProcs);
+  commDataBlocks.resize(dataNProcs);
+
+  if(verbose > 0) {
+    cout << "BLProfStreamParser:  dataNProcs = " << dataNProcs
+         << "  prof trace comm = " << bProfDataAvailable << "  "
+         << bTraceDataAvailable << "  " << bCommDataAvailable << endl;
+  }
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::ReadBLProfHeader() {
+  Vector<std::string> lines;
+  if( ! ReadLines(dirName + "/bl_prof_H", lines)) {
+    return;
+  }
+  for(int i(0); i < lines.size(); ++i) {
+    std::istringstream iss(lines[i]);
+    std::string key;
+    iss >> key;
+    if(key == "NProcs") {
+      int np(0);
+      iss >> np;
+      dataNProcs = std::max(dataNProcs, np);
+      blpDataBlocks.resize(dataNProcs);
+    } else if(key == "phFName") {
+      std::string name, rest;
+      if(QuotedName(lines[i], name, rest)) {
+        blpFNames.push_back(SanitizedFName(name));
+      }
+    } else if(key == "BLProfProc") {
+      int proc(-1);
+      long seekpos(-1);
+      std::string dfword, dfname, spword;
+      iss >> proc >> dfword >> dfname >> spword >> seekpos;
+      if(proc >= blpDataBlocks.size()) {
+        blpDataBlocks.resize(proc + 1);
+      }
+      if(proc >= 0) {
+        blpDataBlocks[proc] = DataBlock(dfname, seekpos, 0, 0);
+      }
+    } else if(key == "calcEndTime") {
+      iss >> calcEndTime;
+    }
+  }
+  dataNProcs = std::max(dataNProcs, static_cast<int>(blpDataBlocks.size()));
+  bProfDataAvailable = blpFNames.size() > 0;
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::ReadCallStatsHeaders() {
+  Vector<std::string> lines, headerFileNames;
+  if( ! ReadLines(dirName + "/bl_call_stats_H", lines)) {
+    return;
+  }
+  for(int i(0); i < lines.size(); ++i) {
+    std::istringstream iss(lines[i]);
+    std::string key;
+    iss >> key;
+    if(key == "NProcs") {
+      int np(0);
+      iss >> np;
+      dataNProcs = std::max(dataNProcs, np);
+    } else if(key == "RegionName") {
+      std::string name, rest;
+      int rnumber(-1);
+      if(QuotedName(lines[i], name, rest)) {
+        std::istringstream(rest) >> rnumber;
+        if(rnumber >= 0) {
+          if(rnumber >= regionNames.size()) {
+            regionNames.resize(rnumber + 1);
+          }
+          regionNames[rnumber] = name;
+        }
+      }
+    } else if(key == "HeaderFile") {
+      std::string hfn;
+      iss >> hfn;
+      headerFileNames.push_back(hfn);
+    }
+  }
+
+  // ---- each header file is scanned by one thread.  a process always
+  // ---- writes to the same header file, so the files are independent.
+  const int nHeaders(headerFileNames.size());
+  Vector<std::map<int, std::map<int, std::string> > > hProcFNames(nHeaders);  // [h][proc][fnum, name]
+  Vector<std::map<int, Vector<DataBlock> > > hBlocks(nHeaders);               // [h][proc]
+  Vector<Real> hTimeMin(nHeaders, std::numeric_limits<Real>::max());
+  Vector<Real> hTimeMax(nHeaders, -std::numeric_limits<Real>::max());
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int h = 0; h < nHeaders; ++h) {
+    Vector<std::string> hlines;
+    if( ! ReadLines(dirName + '/' + headerFileNames[h], hlines)) {
+      cerr << "**** Error:  BLProfStreamParser:  cannot open "
+           << headerFileNames[h] << endl;
+      continue;
+    }
+    int currentProc(-1);
+    for(int i(0); i < hlines.size(); ++i) {
+      std::istringstream iss(hlines[i]);
+      std::string key;
+      iss >> key;
+      if(key == "CallStatsProc") {
+        long nrss(0), nts(0), seekpos(-1);
+        std::string w0, w1, w2, w3, dfname;
+        iss >> currentProc >> w0 >> nrss >> w1 >> nts >> w2 >> dfname >> w3 >> seekpos;
+        hBlocks[h][currentProc].push_back(DataBlock(dfname, seekpos, nrss, nts));
+      } else if(key == "fName") {
+        std::string name, rest;
+        int fnumber(-1);
+        if(currentProc >= 0 && QuotedName(hlines[i], name, rest)) {
+          std::istringstream(rest) >> fnumber;
+          hProcFNames[h][currentProc][fnumber] = SanitizedFName(name);
+        }
+      } else if(key == "timeMinMax") {
+        Real tmin, tmax;
+        iss >> tmin >> tmax;
+        hTimeMin[h] = std::min(hTimeMin[h], tmin);
+        hTimeMax[h] = std::max(hTimeMax[h], tmax);
+      }
+    }
+  }
+
+  // ---- give the names global numbers in name order
+  std::map<std::string, int> nameNumbers;
+  for(int h(0); h < nHeaders; ++h) {
+    for(auto &pn : hProcFNames[h]) {
+      for(auto &fn : pn.second) {
+        nameNumbers.insert(std::make_pair(fn.second, 0));
+      }
+    }
+  }
+  fNames.clear();
+  for(auto &nn : nameNumbers) {
+    nn.second = fNames.size();
+    fNames.push_back(nn.first);
+  }
+
+  for(int h(0); h < nHeaders; ++h) {
+    for(auto &pb : hBlocks[h]) {
+      dataNProcs = std::max(dataNProcs, pb.first + 1);
+    }
+  }
+  callDataBlocks.resize(dataNProcs);
+  fnameRemap.resize(dataNProcs);
+  for(int h(0); h < nHeaders; ++h) {
+    for(auto &pb : hBlocks[h]) {
+      Vector<DataBlock> &procBlocks = callDataBlocks[pb.first];
+      procBlocks.insert(procBlocks.end(), pb.second.begin(), pb.second.end());
+    }
+    for(auto &pn : hProcFNames[h]) {
+      Vector<int> &remap = fnameRemap[pn.first];
+      for(auto &fn : pn.second) {
+        if(fn.first < 0) {
+          continue;
+        }
+        if(fn.first >= remap.size()) {
+          remap.resize(fn.first + 1, -1);
+        }
+        remap[fn.first] = nameNumbers[fn.second];
+      }
+    }
+    traceTimeMin = std::min(traceTimeMin, hTimeMin[h]);
+    traceTimeMax = std::max(traceTimeMax, hTimeMax[h]);
+  }
+  bTraceDataAvailable = fNames.size() > 0;
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::ReadCommHeaders() {
+  Vector<std::string> lines, headerFileNames;
+  if( ! ReadLines(dirName + "/bl_comm_prof_H", lines)) {
+    return;
+  }
+  long csSize(sizeof(BLProfiler::CommStats));
+  for(int i(0); i < lines.size(); ++i) {
+    std::istringstream iss(lines[i]);
+    std::string key;
+    iss >> key;
+    if(key == "NProcs") {
+      int np(0);
+      iss >> np;
+      dataNProcs = std::max(dataNProcs, np);
+    } else if(key == "CommStatsSize") {
+      iss >> csSize;
+    } else if(key == "HeaderFile") {
+      std::string hfn;
+      iss >> hfn;
+      headerFileNames.push_back(hfn);
+    }
+  }
+  if(csSize != sizeof(BLProfiler::CommStats)) {
+    cerr << "**** Error:  BLProfStreamParser:  CommStatsSize = " << csSize
+         << " != sizeof(CommStats) = " << sizeof(BLProfiler::CommStats)
+         << ".  skipping the comm data." << endl;
+    return;
+  }
+
+  const int nHeaders(headerFileNames.size());
+  Vector<std::map<int, Vector<DataBlock> > > hBlocks(nHeaders);  // [h][proc]
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for(int h = 0; h < nHeaders; ++h) {
+    Vector<std::string> hlines;
+    if( ! ReadLines(dirName + '/' + headerFileNames[h], hlines)) {
+      cerr << "**** Error:  BLProfStreamParser:  cannot open "
+           << headerFileNames[h] << endl;
+      continue;
+    }
+    for(int i(0); i < hlines.size(); ++i) {
+      std::istringstream iss(hlines[i]);
+      std::string key;
+      iss >> key;
+      if(key == "CommProfProc") {
+        int proc(-1);
+        long ncs(0), seekpos(-1);
+        std::string w0, w1, w2, dfname;
+        iss >> proc >> w0 >> ncs >> w1 >> dfname >> w2 >> seekpos;
+        if(proc >= 0) {
+          hBlocks[h][proc].push_back(DataBlock(dfname, seekpos, 0, ncs));
+        }
+      }
+    }
+  }
+
+  for(int h(0); h < nHeaders; ++h) {
+    for(auto &pb : hBlocks[h]) {
+      dataNProcs = std::max(dataNProcs, pb.first + 1);
+    }
+  }
+  commDataBlocks.resize(dataNProcs);
+  for(int h(0); h < nHeaders; ++h) {
+    for(auto &pb : hBlocks[h]) {
+      Vector<DataBlock> &procBlocks = commDataBlocks[pb.first];
+      procBlocks.insert(procBlocks.end(), pb.second.begin(), pb.second.end());
+      bCommDataAvailable = true;
+    }
+  }
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::WriteSummary(std::ostream &os, bool bwriteavg, int whichProc)
+{
+  if( ! bProfDataAvailable) {
+    cout << "BLProfStreamParser::WriteSummary:  profiling data is not available." << endl;
+    return;
+  }
+  BL_PROFILE("BLProfStreamParser::WriteSummary()");
+
+  const int nFuncs(blpFNames.size());
+  const int nBlocks(blpDataBlocks.size());
+  Vector<ProcAccum> funcAccum(nFuncs);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    Vector<ProcAccum> myAccum(nFuncs);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(int proc = 0; proc < dataNProcs; ++proc) {
+      bool haveBlock(proc < nBlocks && blpDataBlocks[proc].seekpos >= 0);
+      long blockSize(nFuncs * (sizeof(long) + sizeof(Real)));
+      MappedBlock mb(haveBlock ? dirName + '/' + blpDataBlocks[proc].fileName : "",
+                     haveBlock ? blpDataBlocks[proc].seekpos : 0,
+                     haveBlock ? blockSize : 0);
+      haveBlock = haveBlock && mb.Ok();
+      for(int fnum(0); fnum < nFuncs; ++fnum) {
+        Real tt(haveBlock ? mb.Record<Real>(nFuncs * sizeof(long), fnum) : 0.0);
+        myAccum[fnum].Add(tt);
+        if(proc == whichProc && haveBlock) {  // ---- store ncalls for whichProc only
+          myAccum[fnum].nCalls = mb.Record<long>(0, fnum);
+        }
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp critical (blpstream_summary)
+#endif
+    for(int fnum(0); fnum < nFuncs; ++fnum) {
+      funcAccum[fnum].Merge(myAccum[fnum]);
+    }
+  }
+
+  BLProfiler::SetRunTime(calcEndTime);
+  std::map<std::string, BLProfiler::ProfStats> mProfStats;  // [fname, pstats]
+  for(int fnum(0); fnum < nFuncs; ++fnum) {
+    mProfStats.insert(std::make_pair(blpFNames[fnum],
+                      funcAccum[fnum].ToProfStats(dataNProcs, calcEndTime)));
+  }
+
+  std::map<std::string, int> fnameNumbers;
+  Vector<BLProfiler::CallStats> vCallStatsAllOneProc;
+  BLProfilerUtils::WriteStats(os, mProfStats, fnameNumbers,
+                              vCallStatsAllOneProc, bwriteavg, false);
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::WriteTraceSummary(std::ostream &os, int whichProc)
+{
+  if( ! bTraceDataAvailable) {
+    cout << "BLProfStreamParser::WriteTraceSummary:  trace data is not available." << endl;
+    return;
+  }
+  BL_PROFILE("BLProfStreamParser::WriteTraceSummary()");
+
+  const int nFuncs(fNames.size());
+  Vector<ProcAccum> funcAccum(nFuncs);
+  Vector<BLProfiler::CallStats> vCallStatsAllOneProc;  // ---- for the inclusive times
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    Vector<ProcAccum> myAccum(nFuncs);
+    Vector<Real> procTime(nFuncs);
+    Vector<long> procNCalls(nFuncs);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(int proc = 0; proc < dataNProcs; ++proc) {
+      std::fill(procTime.begin(), procTime.end(), 0.0);
+      std::fill(procNCalls.begin(), procNCalls.end(), 0);
+      const Vector<int> &remap = fnameRemap[proc];
+
+      for(int idb(0); idb < callDataBlocks[proc].size(); ++idb) {
+        const DataBlock &dBlock = callDataBlocks[proc][idb];
+        long rssBytes(dBlock.nRSS * sizeof(BLProfiler::RStartStop));
+        MappedBlock mb(dirName + '/' + dBlock.fileName, dBlock.seekpos,
+                       rssBytes + dBlock.nRecords * sizeof(BLProfiler::CallStats));
+        if( ! mb.Ok()) {
+          continue;
+        }
+        for(long i(0); i < dBlock.nRecords; ++i) {
+          BLProfiler::CallStats cs(mb.Record<BLProfiler::CallStats>(rssBytes, i));
+          if(cs.csFNameNumber < 0 || cs.csFNameNumber >= remap.size()) {  // ---- the unused cs
+            continue;
+          }
+          int remappedIndex(remap[cs.csFNameNumber]);
+          if(remappedIndex < 0) {
+            continue;
+          }
+          procTime[remappedIndex]   += cs.stackTime;
+          procNCalls[remappedIndex] += 1;
+          if(proc == whichProc) {
+            vCallStatsAllOneProc.push_back(cs);
+          }
+        }
+      }
+
+      for(int fnum(0); fnum < nFuncs; ++fnum) {
+        myAccum[fnum].Add(procTime[fnum]);
+        if(proc == whichProc) {
+          myAccum[fnum].nCalls = procNCalls[fnum];
+        }
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp critical (blpstream_tracesummary)
+#endif
+    for(int fnum(0); fnum < nFuncs; ++fnum) {
+      funcAccum[fnum].Merge(myAccum[fnum]);
+    }
+  }
+
+  Real calcRunTime(traceTimeMax - traceTimeMin);
+  BLProfiler::SetRunTime(calcRunTime);
+  std::map<std::string, BLProfiler::ProfStats> mProfStats;  // [fname, pstats]
+  for(int fnum(0); fnum < nFuncs; ++fnum) {
+    mProfStats.insert(std::make_pair(fNames[fnum],
+                      funcAccum[fnum].ToProfStats(dataNProcs, calcRunTime)));
+  }
+
+  std::map<std::string, int> fnameNumbers;  // ---- whichProc's numbering
+  if(whichProc >= 0 && whichProc < dataNProcs) {
+    const Vector<int> &remap = fnameRemap[whichProc];
+    for(int i(0); i < remap.size(); ++i) {
+      if(remap[i] >= 0) {
+        fnameNumbers.insert(std::make_pair(fNames[remap[i]], i));
+      }
+    }
+  }
+
+  bool writeAvg(true), writeInclusive(true);
+  BLProfilerUtils::WriteStats(os, mProfStats, fnameNumbers,
+                              vCallStatsAllOneProc, writeAvg, writeInclusive);
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::WriteRegionTimeline(std::ostream &os, int whichProc)
+{
+  if( ! bTraceDataAvailable) {
+    cout << "BLProfStreamParser::WriteRegionTimeline:  trace data is not available." << endl;
+    return;
+  }
+  BL_PROFILE("BLProfStreamParser::WriteRegionTimeline()");
+
+  const int nRegions(regionNames.size());
+  Vector<RegionStat> regionStats(nRegions);
+  Vector<Vector<std::pair<Real, Real> > > procRanges(nRegions);  // ---- whichProc's [rnum][range]
+  for(int r(0); r < nRegions; ++r) {
+    regionStats[r].minTime = std::numeric_limits<Real>::max();
+  }
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    Vector<RegionStat> myStats(regionStats);
+    Vector<Real> rStartTime(nRegions), rTime(nRegions);
+    Vector<long> rNRanges(nRegions);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(int proc = 0; proc < dataNProcs; ++proc) {
+      std::fill(rStartTime.begin(), rStartTime.end(), -1.0);
+      std::fill(rTime.begin(), rTime.end(), 0.0);
+      std::fill(rNRanges.begin(), rNRanges.end(), 0);
+
+      for(int idb(0); idb < callDataBlocks[proc].size(); ++idb) {
+        const DataBlock &dBlock = callDataBlocks[proc][idb];
+        MappedBlock mb(dirName + '/' + dBlock.fileName, dBlock.seekpos,
+                       dBlock.nRSS * sizeof(BLProfiler::RStartStop));
+        if( ! mb.Ok()) {
+          continue;
+        }
+        for(long i(0); i < dBlock.nRSS; ++i) {
+          BLProfiler::RStartStop rss(mb.Record<BLProfiler::RStartStop>(0, i));
+          int r(rss.rssRNumber);
+          if(r < 0 || r >= nRegions) {
+            continue;
+          }
+          if(rss.rssStart) {     // start region
+            if(rStartTime[r] < 0.0) {  // ---- a mismatched start is ignored
+              rStartTime[r] = rss.rssTime;
+            }
+          } else if(rStartTime[r] >= 0.0) {  // stop region
+            RegionStat &rs = myStats[r];
+            rTime[r] += rss.rssTime - rStartTime[r];
+            ++rNRanges[r];
+            rs.firstStart = (rs.firstStart < 0.0) ? rStartTime[r]
+                                                  : std::min(rs.firstStart, rStartTime[r]);
+            rs.lastStop   = std::max(rs.lastStop, rss.rssTime);
+            if(proc == whichProc) {
+              procRanges[r].push_back(std::make_pair(rStartTime[r], rss.rssTime));
+            }
+            rStartTime[r] = -1.0;
+          }
+        }
+      }
+
+      for(int r(0); r < nRegions; ++r) {
+        RegionStat &rs = myStats[r];
+        rs.nRanges  += rNRanges[r];
+        rs.maxRanges = std::max(rs.maxRanges, rNRanges[r]);
+        rs.totalTime += rTime[r];
+        rs.minTime   = std::min(rs.minTime, rTime[r]);
+        rs.maxTime   = std::max(rs.maxTime, rTime[r]);
+      }
+    }
+
+#ifdef _OPENMP
+#pragma omp critical (blpstream_regions)
+#endif
+    for(int r(0); r < nRegions; ++r) {
+      RegionStat &rs = regionStats[r];
+      const RegionStat &mrs = myStats[r];
+      rs.nRanges   += mrs.nRanges;
+      rs.maxRanges  = std::max(rs.maxRanges, mrs.maxRanges);
+      rs.totalTime += mrs.totalTime;
+      rs.minTime    = std::min(rs.minTime, mrs.minTime);
+      rs.maxTime    = std::max(rs.maxTime, mrs.maxTime);
+      if(mrs.firstStart >= 0.0) {
+        rs.firstStart = (rs.firstStart < 0.0) ? mrs.firstStart
+                                              : std::min(rs.firstStart, mrs.firstStart);
+      }
+      rs.lastStop = std::max(rs.lastStop, mrs.lastStop);
+    }
+  }
+
+  int maxlen(12);
+  for(int r(0); r < nRegions; ++r) {
+    maxlen = std::max(maxlen, static_cast<int>(regionNames[r].size()));
+  }
+  const int colWidth(12);
+
+  os << '\n' << "Region timeline over " << dataNProcs << " processes:" << '\n';
+  os << std::setw(maxlen + 2) << "Region"
+     << std::setw(colWidth) << "NRanges"
+     << std::setw(colWidth) << "Max NRanges"
+     << std::setw(colWidth + 2) << "First Start"
+     << std::setw(colWidth + 2) << "Last Stop"
+     << std::setw(colWidth + 2) << "Time Min"
+     << std::setw(colWidth + 2) << "Time Avg"
+     << std::setw(colWidth + 2) << "Time Max" << '\n';
+  for(int r(0); r < nRegions; ++r) {
+    const RegionStat &rs = regionStats[r];
+    if(regionNames[r].empty()) {
+      continue;
+    }
+    os << std::setw(maxlen + 2) << regionNames[r]
+       << std::setw(colWidth) << rs.nRanges
+       << std::setw(colWidth) << rs.maxRanges
+       << std::setprecision(6) << std::fixed
+       << std::setw(colWidth + 2) << std::max(rs.firstStart, static_cast<Real>(0.0))
+       << std::setw(colWidth + 2) << std::max(rs.lastStop, static_cast<Real>(0.0))
+       << std::setw(colWidth + 2) << (dataNProcs > 0 ? rs.minTime : 0.0)
+       << std::setw(colWidth + 2) << (dataNProcs > 0 ? rs.totalTime / dataNProcs : 0.0)
+       << std::setw(colWidth + 2) << (dataNProcs > 0 ? rs.maxTime : 0.0)
+       << '\n';
+  }
+
+  os << '\n' << "Region time ranges for processor " << whichProc << ":" << '\n';
+  for(int r(0); r < nRegions; ++r) {
+    if(regionNames[r].empty()) {
+      continue;
+    }
+    os << regionNames[r] << '\n';
+    for(int i(0); i < procRanges[r].size(); ++i) {
+      os << "  " << procRanges[r][i].first << "  " << procRanges[r][i].second << '\n';
+    }
+  }
+  os.unsetf(std::ios::floatfield);
+  os << std::endl;
+}
+
+
+// ----------------------------------------------------------------------
+void BLProfStreamParser::WriteSendPattern(std::ostream &os)
+{
+  if( ! bCommDataAvailable) {
+    cout << "BLProfStreamParser::WriteSendPattern:  comm data is not available." << endl;
+    return;
+  }
+  BL_PROFILE("BLProfStreamParser::WriteSendPattern()");
+
+  Vector<Vector<SendPair> > sendPairs(dataNProcs);  // [fromProc][pair]
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::map<int, SendPair> procSends;  // [toProc, sends]
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for(int proc = 0; proc < dataNProcs; ++proc) {
+      procSends.clear();
+      for(int idb(0); idb < commDataBlocks[proc].size(); ++idb) {
+        const DataBlock &dBlock = commDataBlocks[proc][idb];
+        MappedBlock mb(dirName + '/' + dBlock.fileName, dBlock.seekpos,
+                       dBlock.nRecords * sizeof(BLProfiler::CommStats));
+        if( ! mb.Ok()) {
+          continue;
+        }
+        for(long i(0); i < dBlock.nRecords; ++i) {
+          BLProfiler::CommStats cs(mb.Record<BLProfiler::CommStats>(0, i));
+          if(IsSend(cs.cfType) && cs.size != BLProfiler::AfterCall()) {
+            SendPair &sp = procSends[cs.commpid];
+            sp.toProc = cs.commpid;
+            ++sp.nSends;
+            sp.nBytes += cs.size;
+          }
+        }
+      }
+      for(auto &ps : procSends) {
+        sendPairs[proc].push_back(ps.second);
+      }
+    }
+  }
+
+  long totalSends(0), totalSentData(0);
+  const int colWidth(12);
+  os << '\n' << "Send pattern over " << dataNProcs << " processes:" << '\n';
+  os << std::setw(colWidth) << "From" << std::setw(colWidth) << "To"
+     << std::setw(colWidth) << "NSends" << std::setw(colWidth + 4) << "Bytes" << '\n';
+  for(int proc(0); proc < dataNProcs; ++proc) {
+    for(int i(0); i < sendPairs[proc].size(); ++i) {
+      const SendPair &sp = sendPairs[proc][i];
+      os << std::setw(colWidth) << proc << std::setw(colWidth) << sp.toProc
+         << std::setw(colWidth) << sp.nSends << std::setw(colWidth + 4) << sp.nBytes << '\n';
+      totalSends    += sp.nSends;
+      totalSentData += sp.nBytes;
+    }
+  }
+  os << "Total sends     = " << totalSends << '\n';
+  os << "Total sent data = " << totalSentData << " bytes" << '\n';
+  os << std::endl;
+}
+
+// ----------------------------------------------------------------------
+// ----------------------------------------------------------------------
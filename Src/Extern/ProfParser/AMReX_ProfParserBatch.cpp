@@ -21,6 +21,7 @@ using std::string;
 
 #include <AMReX.H>
 # include <AMReX_DataServices.H>
+#include <AMReX_BLProfStreamParser.H>
 #include <AMReX_ParallelDescriptor.H>
 
 using namespace amrex;
@@ -53,15 +54,22 @@ void PrintProfParserBatchUsage(std::ostream &os) {
       os << "   [-proc  n] sets processor number for single processor queries (default:  0).\n";
       os << "   [-prof]    profile the parser." << '\n';
       os << "   [-proxmap] remap ranks to proximity ranks." << '\n';
+      os << "   [-npff]    do not parse filter file." << '\n';
       os << "   [-pff]     parse filter file." << '\n';
       os << "   [-redist]  redistribute files." << '\n';
       os << "   [-rplt]    make region plot file." << '\n';
       os << "   [-rra  n]  sets refRatioAll." << '\n';
+      os << "   [-rtl]     write region timeline (with -stream)." << '\n';
+      os << "   [-sendspat] write the send pattern (with -stream)." << '\n';
       os << "   [-sendspf] output a sends plotfile." << '\n';
       os << "   [-spd]     process sync point data." << '\n';
       os << "   [-sr]      process sends and receives." << '\n';
       os << "   [-srlist]  list sends and receives." << '\n';
       os << "   [-stats]   print database statistics." << '\n';
+      os << "   [-stream]  use the multithreaded streaming parser for\n";
+      os << "              -ws, -wts, -rtl, and -sendspat.\n";
+      os << "              region filters are not applied, so it\n";
+      os << "              cannot be used with -mff, -pff, or RegionFilters.txt.\n";
       os << "   [-tce]     process only topolcoords for edison." << '\n';
       os << "   [-timelinepf] output a timeline plotfile." << '\n';
       os << "   [-ttrace]  write text call trace." << '\n';
@@ -91,11 +99,12 @@ bool ProfParserBatchFunctions(int argc, char *argv[], bool runDefault,
   bool runSendsPF(false), runTimelinePF(false), glOnly(false);
   bool tcEdisonOnly(false), runStats(false), runRedist(false);
   bool statsCollected(false), filenameSet(false), proxMap(false);
-  bool bMakeFilterFile(false), bParseFilterFile(true);
+  bool bMakeFilterFile(false), bParseFilterFile(true), bParseFilterFileSet(false);
   bool bWriteSummary(false), bWriteTraceSummary(false);
   bool bMakeRegionPlt(false), simpleCombine(true);
   bool bWriteHTML(false), bWriteHTMLNC(false), bWriteTextTrace(false);
   bool bRunACTPF(false), bUseDispatch(false);
+  bool bUseStream(false), bWriteRegionTimeline(false), bWriteSendPattern(false);
   string outfileName, delimString("\t");
   Vector<string> actFNames;
 
@@ -140,6 +149,15 @@ bool ProfParserBatchFunctions(int argc, char *argv[], bool runDefault,
       } else if(strcmp(argv[ia], "-sendspf") == 0) {
         if(bIOP) cout << "*** sendspf." << endl;
         runSendsPF = true;
+      } else if(strcmp(argv[ia], "-sendspat") == 0) {
+        if(bIOP) cout << "*** send pattern." << endl;
+        bWriteSendPattern = true;
+      } else if(strcmp(argv[ia], "-stream") == 0) {
+        if(bIOP) cout << "*** using the streaming parser." << endl;
+        bUseStream = true;
+      } else if(strcmp(argv[ia], "-rtl") == 0) {
+        if(bIOP) cout << "*** region timeline." << endl;
+        bWriteRegionTimeline = true;
       } else if(strcmp(argv[ia], "-gl") == 0) {
         if(bIOP) cout << "*** grdlog." << endl;
         glOnly = true;
@@ -191,6 +209,7 @@ bool ProfParserBatchFunctions(int argc, char *argv[], bool runDefault,
         bMakeFilterFile = true;
       } else if(strcmp(argv[ia], "-pff") == 0) {
         bParseFilterFile = true;
+        bParseFilterFileSet = true;
       } else if(strcmp(argv[ia], "-npff") == 0) {
         bParseFilterFile = false;
       } else if(strcmp(argv[ia], "-rplt") == 0) {
@@ -236,6 +255,61 @@ bool ProfParserBatchFunctions(int argc, char *argv[], bool runDefault,
   BLProfStats::SetVerbose(verbose);
   std::string dirName(argv[argc - 1]);
 
+  // ---- the streaming parser does not build the database in memory,
+  // ---- so it does not use the DataServices
+  if(bUseStream) {
+    // ---- nor the region filters, do not write unfiltered results
+    // ---- where filtered ones are expected
+    bool bFilter(bMakeFilterFile || bParseFilterFileSet ||
+                 (bParseFilterFile && std::ifstream("RegionFilters.txt").good()));
+    if(bFilter) {
+      if(bIOP) {
+        cerr << "*** Error:  -stream does not apply region filters (-mff, -pff, RegionFilters.txt)."
+             << "  Use -npff or remove RegionFilters.txt." << endl;
+      }
+      BL_PROFILE_VAR_STOP(ppbf);
+      return false;
+    }
+    if(bIOP) {
+      BLProfStreamParser::SetVerbose(verbose);
+      BLProfStreamParser streamParser(dirName);
+
+      int dataNProcs(streamParser.GetNProcs());
+      if(whichProc < 0 || whichProc > dataNProcs - 1) {
+        cout << "**** Error:  whichProc out of range:  "
+             << whichProc << " [0," << dataNProcs - 1 << "]." << endl;
+        whichProc = 0;
+      }
+
+      if(bWriteSummary) {
+        cout << "Writing summary." << endl;
+        streamParser.WriteSummary(cout, true, whichProc);
+      }
+      if(bWriteTraceSummary) {
+        cout << "Writing trace summary." << endl;
+        streamParser.WriteTraceSummary(cout, whichProc);
+      }
+      if(bWriteRegionTimeline) {
+        cout << "Writing region timeline." << endl;
+        streamParser.WriteRegionTimeline(cout, whichProc);
+      }
+      if(bWriteSendPattern) {
+        std::string sendPatternFileName("SendPattern.txt");
+        if(filenameSet) {
+          sendPatternFileName = outfileName;
+        }
+        cout << "Writing send pattern to " << sendPatternFileName << endl;
+        std::ofstream spFile(sendPatternFileName.c_str());
+        streamParser.WriteSendPattern(spFile);
+      }
+    }
+    ParallelDescriptor::Barrier();
+
+    BL_PROFILE_VAR_STOP(ppbf);
+
+    return bWriteSummary || bWriteTraceSummary || bWriteRegionTimeline || bWriteSendPattern;
+  }
+
   Amrvis::FileType fileType(Amrvis::PROFDATA);
   DataServices pdServices(dirName, fileType);
 
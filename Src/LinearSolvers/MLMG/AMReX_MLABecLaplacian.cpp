@@ -3,6 +3,7 @@
 #include <AMReX_MultiFabUtil.H>
 
 #include <AMReX_MLABecLap_F.H>
+#include <AMReX_MLABecLap_K.H>
 #include <AMReX_ABec_F.H>
 
 namespace amrex {
@@ -11,9 +12,10 @@ MLABecLaplacian::MLABecLaplacian (const Vector<Geometry>& a_geom,
                                   const Vector<BoxArray>& a_grids,
                                   const Vector<DistributionMapping>& a_dmap,
                                   const LPInfo& a_info,
-                                  const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                                  const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                                  int a_nrhs)
 {
-    define(a_geom, a_grids, a_dmap, a_info, a_factory);
+    define(a_geom, a_grids, a_dmap, a_info, a_factory, a_nrhs);
 }
 
 void
@@ -21,10 +23,14 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
                          const Vector<BoxArray>& a_grids,
                          const Vector<DistributionMapping>& a_dmap,
                          const LPInfo& a_info,
-                         const Vector<FabFactory<FArrayBox> const*>& a_factory)
+                         const Vector<FabFactory<FArrayBox> const*>& a_factory,
+                         int a_nrhs)
 {
     BL_PROFILE("MLABecLaplacian::define()");
 
+    AMREX_ALWAYS_ASSERT(a_nrhs >= 1);
+    m_nrhs = a_nrhs;
+
     MLCellABecLap::define(a_geom, a_grids, a_dmap, a_info, a_factory);
 
     m_a_coeffs.resize(m_num_amr_levels);
@@ -35,21 +41,47 @@ MLABecLaplacian::define (const Vector<Geometry>& a_geom,
         m_b_coeffs[amrlev].resize(m_num_mg_levels[amrlev]);
         for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
         {
-            m_a_coeffs[amrlev][mglev].define(m_grids[amrlev][mglev],
-                                             m_dmap[amrlev][mglev],
-                                             1, 0, MFInfo(), *m_factory[amrlev][mglev]);
+            defineCoeffs(amrlev, mglev);
+        }
+    }
+
+    m_a_coeffs_f.clear();
+    m_b_coeffs_f.clear();
+    m_a_coeffs_f.resize(m_num_mg_levels[0]);
+    m_b_coeffs_f.resize(m_num_mg_levels[0]);
+    for (int mglev = 0; mglev < m_num_mg_levels[0]; ++mglev)
+    {
+        if (useFloatCoeffs(0, mglev))
+        {
+            m_a_coeffs_f[mglev].define(m_grids[0][mglev], m_dmap[0][mglev], 1, 0);
             for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
             {
-                const BoxArray& ba = amrex::convert(m_grids[amrlev][mglev],
+                const BoxArray& ba = amrex::convert(m_grids[0][mglev],
                                                     IntVect::TheDimensionVector(idim));
-                m_b_coeffs[amrlev][mglev][idim].define(ba,
-                                                       m_dmap[amrlev][mglev],
-                                                       1, 0, MFInfo(), *m_factory[amrlev][mglev]);
+                m_b_coeffs_f[mglev][idim].define(ba, m_dmap[0][mglev], 1, 0);
             }
         }
     }
 }
 
+void
+MLABecLaplacian::defineCoeffs (int amrlev, int mglev)
+{
+    // Deep-halo smoothing reads coefficients in the ghost region.
+    const int ng = useDeepHaloSmooth(amrlev, mglev) ? info.smooth_halo_depth-1 : 0;
+    m_a_coeffs[amrlev][mglev].define(m_grids[amrlev][mglev],
+                                     m_dmap[amrlev][mglev],
+                                     1, ng, MFInfo(), *m_factory[amrlev][mglev]);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+    {
+        const BoxArray& ba = amrex::convert(m_grids[amrlev][mglev],
+                                            IntVect::TheDimensionVector(idim));
+        m_b_coeffs[amrlev][mglev][idim].define(ba,
+                                               m_dmap[amrlev][mglev],
+                                               1, ng, MFInfo(), *m_factory[amrlev][mglev]);
+    }
+}
+
 MLABecLaplacian::~MLABecLaplacian ()
 {}
 
@@ -65,6 +97,7 @@ MLABecLaplacian::setScalars (Real a, Real b)
             m_a_coeffs[amrlev][0].setVal(0.0);
         }
     }
+    m_needs_update = true;
 }
 
 void
@@ -91,23 +124,27 @@ MLABecLaplacian::averageDownCoeffs ()
 
     for (int amrlev = m_num_amr_levels-1; amrlev > 0; --amrlev)
     {
-        auto& fine_a_coeffs = m_a_coeffs[amrlev];
-        auto& fine_b_coeffs = m_b_coeffs[amrlev];
-
-        averageDownCoeffsSameAmrLevel(fine_a_coeffs, fine_b_coeffs);
+        averageDownCoeffsSameAmrLevel(amrlev);
         averageDownCoeffsToCoarseAmrLevel(amrlev);
     }
 
-    averageDownCoeffsSameAmrLevel(m_a_coeffs[0], m_b_coeffs[0]);
+    averageDownCoeffsSameAmrLevel(0);
+
+    fillCoeffsDeepHalo();
 }
 
 void
-MLABecLaplacian::averageDownCoeffsSameAmrLevel (Vector<MultiFab>& a,
-                                                Vector<Array<MultiFab,AMREX_SPACEDIM> >& b)
+MLABecLaplacian::averageDownCoeffsSameAmrLevel (int amrlev)
 {
+    auto& a = m_a_coeffs[amrlev];
+    auto& b = m_b_coeffs[amrlev];
+
     int nmglevs = a.size();
     for (int mglev = 1; mglev < nmglevs; ++mglev)
     {
+        // Released by an earlier conversion to single precision
+        if (a[mglev].empty()) defineCoeffs(amrlev, mglev);
+
         if (m_a_scalar == 0.0)
         {
             a[mglev].setVal(0.0);
@@ -125,9 +162,68 @@ MLABecLaplacian::averageDownCoeffsSameAmrLevel (Vector<MultiFab>& a,
                                              &(b[mglev][2]))};
         IntVect ratio {mg_coarsen_ratio};
         amrex::average_down_faces(fine, crse, ratio, 0);
+
+        if (useFloatCoeffs(amrlev, mglev-1)) convertCoeffsToFloat(mglev-1);
     }
 }
 
+void
+MLABecLaplacian::convertCoeffsToFloat (int mglev)
+{
+    MultiFab& acoef = m_a_coeffs[0][mglev];
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(acoef, true); mfi.isValid(); ++mfi)
+    {
+        mlabeclap::convert(mfi.tilebox(), m_a_coeffs_f[mglev][mfi], acoef[mfi]);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+        {
+            const Box& bx = mfi.nodaltilebox(idim);
+            mlabeclap::convert(bx, m_b_coeffs_f[mglev][idim][mfi],
+                               m_b_coeffs[0][mglev][idim][mfi]);
+        }
+    }
+
+    acoef.clear();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_b_coeffs[0][mglev][idim].clear();
+    }
+}
+
+bool
+MLABecLaplacian::lineSolve (int amrlev, int mglev) const
+{
+#if (AMREX_SPACEDIM == 2)
+    // amrex_abec_gsrb switches to line solves for anisotropic cells.
+    const Real* h = m_geom[amrlev][mglev].CellSize();
+    return (h[1] > 1.5*h[0]) || (h[0] > 1.5*h[1]);
+#else
+    amrex::ignore_unused(amrlev);
+    amrex::ignore_unused(mglev);
+    return false;
+#endif
+}
+
+bool
+MLABecLaplacian::useFloatCoeffs (int amrlev, int mglev) const
+{
+    // The finest level computes the residuals, and the bottom level
+    // coefficients are handed to the bottom solvers.  Only the C++
+    // kernels take single-precision coefficients.
+#if (AMREX_SPACEDIM == 1)
+    amrex::ignore_unused(amrlev);
+    amrex::ignore_unused(mglev);
+    return false;
+#else
+    return info.float_coeffs && amrlev == 0
+        && mglev > 0 && mglev < m_num_mg_levels[0]-1
+        && !useDeepHaloSmooth(amrlev, mglev)
+        && !lineSolve(amrlev, mglev);
+#endif
+}
+
 void
 MLABecLaplacian::averageDownCoeffsToCoarseAmrLevel (int flev)
 {
@@ -159,6 +255,23 @@ MLABecLaplacian::averageDownCoeffsToCoarseAmrLevel (int flev)
     }
 }
 
+void
+MLABecLaplacian::fillCoeffsDeepHalo ()
+{
+    const int amrlev = 0;
+    for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
+    {
+        if (m_a_coeffs[amrlev][mglev].nGrow() > 0)
+        {
+            const Periodicity& period = m_geom[amrlev][mglev].periodicity();
+            m_a_coeffs[amrlev][mglev].FillBoundary(period);
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                m_b_coeffs[amrlev][mglev][idim].FillBoundary(period);
+            }
+        }
+    }
+}
+
 void
 MLABecLaplacian::applyMetricTermsCoeffs ()
 {
@@ -227,6 +340,10 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
 
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
+    const bool use_cpp = (m_kernel == Kernel::Cpp) && (AMREX_SPACEDIM > 1);
+    const bool use_float = useFloatCoeffs(amrlev, mglev);
+    const int ncomp = getNComp();
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -235,20 +352,45 @@ MLABecLaplacian::Fapply (int amrlev, int mglev, MultiFab& out, const MultiFab& i
         const Box& bx = mfi.tilebox();
         const FArrayBox& xfab = in[mfi];
         FArrayBox& yfab = out[mfi];
+
+        if (use_float)
+        {
+            AMREX_D_TERM(const auto& bxfab = m_b_coeffs_f[mglev][0][mfi];,
+                         const auto& byfab = m_b_coeffs_f[mglev][1][mfi];,
+                         const auto& bzfab = m_b_coeffs_f[mglev][2][mfi];);
+            for (int n = 0; n < ncomp; ++n)
+            {
+                mlabeclap::adotx(bx, yfab, xfab, m_a_coeffs_f[mglev][mfi],
+                                 {AMREX_D_DECL(&bxfab,&byfab,&bzfab)},
+                                 dxinv, m_a_scalar, m_b_scalar, n);
+            }
+            continue;
+        }
+
         const FArrayBox& afab = acoef[mfi];
         AMREX_D_TERM(const FArrayBox& bxfab = bxcoef[mfi];,
                      const FArrayBox& byfab = bycoef[mfi];,
                      const FArrayBox& bzfab = bzcoef[mfi];);
 
-        amrex_mlabeclap_adotx(BL_TO_FORTRAN_BOX(bx),
-                              BL_TO_FORTRAN_ANYD(yfab),
-                              BL_TO_FORTRAN_ANYD(xfab),
-                              BL_TO_FORTRAN_ANYD(afab),
-                              AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
-                                           BL_TO_FORTRAN_ANYD(byfab),
-                                           BL_TO_FORTRAN_ANYD(bzfab)),
-                              dxinv, m_a_scalar, m_b_scalar);
+        for (int n = 0; n < ncomp; ++n)
+        {
+            if (use_cpp)
+            {
+                mlabeclap::adotx(bx, yfab, xfab, afab,
+                                 {AMREX_D_DECL(&bxfab,&byfab,&bzfab)},
+                                 dxinv, m_a_scalar, m_b_scalar, n);
+                continue;
+            }
 
+            amrex_mlabeclap_adotx(BL_TO_FORTRAN_BOX(bx),
+                                  BL_TO_FORTRAN_N_ANYD(yfab,n),
+                                  BL_TO_FORTRAN_N_ANYD(xfab,n),
+                                  BL_TO_FORTRAN_ANYD(afab),
+                                  AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
+                                               BL_TO_FORTRAN_ANYD(byfab),
+                                               BL_TO_FORTRAN_ANYD(bzfab)),
+                                  dxinv, m_a_scalar, m_b_scalar);
+        }
     }
 }
 
@@ -257,12 +399,16 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
 {
     BL_PROFILE("MLABecLaplacian::normalize()");
 
+    // Only used by the bottom solvers, whose level is double precision.
+    AMREX_ASSERT(!useFloatCoeffs(amrlev, mglev));
+
     const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
     AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
                  const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
                  const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
 
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+    const int ncomp = getNComp();
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -276,14 +422,16 @@ MLABecLaplacian::normalize (int amrlev, int mglev, MultiFab& mf) const
                      const FArrayBox& byfab = bycoef[mfi];,
                      const FArrayBox& bzfab = bzcoef[mfi];);
 
-        amrex_mlabeclap_normalize(BL_TO_FORTRAN_BOX(bx),
-                                  BL_TO_FORTRAN_ANYD(fab),
-                                  BL_TO_FORTRAN_ANYD(afab),
-                                  AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
-                                               BL_TO_FORTRAN_ANYD(byfab),
-                                               BL_TO_FORTRAN_ANYD(bzfab)),
-                                  dxinv, m_a_scalar, m_b_scalar);
-
+        for (int n = 0; n < ncomp; ++n)
+        {
+            amrex_mlabeclap_normalize(BL_TO_FORTRAN_BOX(bx),
+                                      BL_TO_FORTRAN_N_ANYD(fab,n),
+                                      BL_TO_FORTRAN_ANYD(afab),
+                                      AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
+                                                   BL_TO_FORTRAN_ANYD(byfab),
+                                                   BL_TO_FORTRAN_ANYD(bzfab)),
+                                      dxinv, m_a_scalar, m_b_scalar);
+        }
     }
 }
 
@@ -323,9 +471,13 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
-    const int nc = 1;
+    const int nc = getNComp();
     const Real* h = m_geom[amrlev][mglev].CellSize();
 
+    const bool use_cpp = (m_kernel == Kernel::Cpp) && (AMREX_SPACEDIM > 1)
+        && !lineSolve(amrlev, mglev);
+    const bool use_float = useFloatCoeffs(amrlev, mglev);
+
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -347,11 +499,6 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
         const Box&       vbx     = mfi.validbox();
         FArrayBox&       solnfab = sol[mfi];
         const FArrayBox& rhsfab  = rhs[mfi];
-        const FArrayBox& afab    = acoef[mfi];
-
-        AMREX_D_TERM(const FArrayBox& bxfab = bxcoef[mfi];,
-                     const FArrayBox& byfab = bycoef[mfi];,
-                     const FArrayBox& bzfab = bzcoef[mfi];);
 
         const FArrayBox& f0fab = f0[mfi];
         const FArrayBox& f1fab = f1[mfi];
@@ -364,6 +511,57 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
 #endif
 #endif
 
+#if (AMREX_SPACEDIM > 1)
+        if (use_float)
+        {
+            AMREX_D_TERM(const auto& bxfab = m_b_coeffs_f[mglev][0][mfi];,
+                         const auto& byfab = m_b_coeffs_f[mglev][1][mfi];,
+                         const auto& bzfab = m_b_coeffs_f[mglev][2][mfi];);
+            for (int n = 0; n < nc; ++n)
+            {
+                mlabeclap::gsrb(tbx, vbx, redblack, solnfab, rhsfab,
+                                m_a_scalar, m_b_scalar, m_a_coeffs_f[mglev][mfi],
+                                {AMREX_D_DECL(&bxfab,&byfab,&bzfab)},
+#if (AMREX_SPACEDIM == 2)
+                                {&f0fab,&f1fab,&f2fab,&f3fab},
+                                {&m0,&m1,&m2,&m3},
+#else
+                                {&f0fab,&f1fab,&f2fab,&f3fab,&f4fab,&f5fab},
+                                {&m0,&m1,&m2,&m3,&m4,&m5},
+#endif
+                                h, n);
+            }
+            continue;
+        }
+#endif
+
+        const FArrayBox& afab = acoef[mfi];
+        AMREX_D_TERM(const FArrayBox& bxfab = bxcoef[mfi];,
+                     const FArrayBox& byfab = bycoef[mfi];,
+                     const FArrayBox& bzfab = bzcoef[mfi];);
+
+#if (AMREX_SPACEDIM > 1)
+        if (use_cpp)
+        {
+            // f and m are numbered in OrientationIter order.
+            for (int n = 0; n < nc; ++n)
+            {
+                mlabeclap::gsrb(tbx, vbx, redblack, solnfab, rhsfab,
+                                m_a_scalar, m_b_scalar, afab,
+                                {AMREX_D_DECL(&bxfab,&byfab,&bzfab)},
+#if (AMREX_SPACEDIM == 2)
+                                {&f0fab,&f1fab,&f2fab,&f3fab},
+                                {&m0,&m1,&m2,&m3},
+#else
+                                {&f0fab,&f1fab,&f2fab,&f3fab,&f4fab,&f5fab},
+                                {&m0,&m1,&m2,&m3,&m4,&m5},
+#endif
+                                h, n);
+            }
+            continue;
+        }
+#endif
+
 #if (AMREX_SPACEDIM == 1)
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(tbx == vbx, "MLABecLaplacian::Fsmooth: 1d tiling not supported");
         amrex_abec_linesolve (solnfab.dataPtr(), AMREX_ARLIM(solnfab.loVect()),AMREX_ARLIM(solnfab.hiVect()),
@@ -423,6 +621,55 @@ MLABecLaplacian::Fsmooth (int amrlev, int mglev, MultiFab& sol, const MultiFab&
     }
 }
 
+bool
+MLABecLaplacian::supportsDeepHaloSmooth (int amrlev, int mglev) const
+{
+#if (AMREX_SPACEDIM == 1)
+    return false;
+#else
+    return !lineSolve(amrlev, mglev);
+#endif
+}
+
+void
+MLABecLaplacian::FsmoothDeepHalo (int amrlev, int mglev, MultiFab& solrhs,
+                                  int redblack, int ngrow) const
+{
+    BL_PROFILE("MLABecLaplacian::FsmoothDeepHalo()");
+
+#if (AMREX_SPACEDIM > 1)
+    const MultiFab& acoef = m_a_coeffs[amrlev][mglev];
+    AMREX_D_TERM(const MultiFab& bxcoef = m_b_coeffs[amrlev][mglev][0];,
+                 const MultiFab& bycoef = m_b_coeffs[amrlev][mglev][1];,
+                 const MultiFab& bzcoef = m_b_coeffs[amrlev][mglev][2];);
+
+    const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(solrhs,MFItInfo().EnableTiling().SetDynamic(true));
+         mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.growntilebox(ngrow);
+        FArrayBox& fab = solrhs[mfi];
+        const FArrayBox& afab = acoef[mfi];
+        AMREX_D_TERM(const FArrayBox& bxfab = bxcoef[mfi];,
+                     const FArrayBox& byfab = bycoef[mfi];,
+                     const FArrayBox& bzfab = bzcoef[mfi];);
+
+        amrex_mlabeclap_gsrb_interior(BL_TO_FORTRAN_BOX(bx),
+                                      BL_TO_FORTRAN_N_ANYD(fab,0),
+                                      BL_TO_FORTRAN_N_ANYD(fab,1),
+                                      BL_TO_FORTRAN_ANYD(afab),
+                                      AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bxfab),
+                                                   BL_TO_FORTRAN_ANYD(byfab),
+                                                   BL_TO_FORTRAN_ANYD(bzfab)),
+                                      dxinv, m_a_scalar, m_b_scalar, redblack);
+    }
+#endif
+}
+
 void
 MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
                         const Array<FArrayBox*,AMREX_SPACEDIM>& flux,
@@ -437,15 +684,20 @@ MLABecLaplacian::FFlux (int amrlev, const MFIter& mfi,
     const Box& box = mfi.tilebox();
     const Real* dxinv = m_geom[amrlev][mglev].InvCellSize();
 
-    amrex_mlabeclap_flux(BL_TO_FORTRAN_BOX(box),
-                         AMREX_D_DECL(BL_TO_FORTRAN_ANYD(*flux[0]),
-                                      BL_TO_FORTRAN_ANYD(*flux[1]),
-                                      BL_TO_FORTRAN_ANYD(*flux[2])),
-                         BL_TO_FORTRAN_ANYD(sol),
-                         AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bx),
-                                      BL_TO_FORTRAN_ANYD(by),
-                                      BL_TO_FORTRAN_ANYD(bz)),
-                         dxinv, m_b_scalar, face_only);
+    const int ncomp = getNComp();
+
+    for (int n = 0; n < ncomp; ++n)
+    {
+        amrex_mlabeclap_flux(BL_TO_FORTRAN_BOX(box),
+                             AMREX_D_DECL(BL_TO_FORTRAN_N_ANYD(*flux[0],n),
+                                          BL_TO_FORTRAN_N_ANYD(*flux[1],n),
+                                          BL_TO_FORTRAN_N_ANYD(*flux[2],n)),
+                             BL_TO_FORTRAN_N_ANYD(sol,n),
+                             AMREX_D_DECL(BL_TO_FORTRAN_ANYD(bx),
+                                          BL_TO_FORTRAN_ANYD(by),
+                                          BL_TO_FORTRAN_ANYD(bz)),
+                             dxinv, m_b_scalar, face_only);
+    }
 }
 
 void
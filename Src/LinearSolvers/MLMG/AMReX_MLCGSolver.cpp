@@ -11,6 +11,7 @@
 #include <AMReX_VisMF.H>
 #include <AMReX_ParallelReduce.H>
 #include <AMReX_MLMG.H>
+#include <AMReX_MultiFabExpr.H>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -46,6 +47,91 @@ sxay (MultiFab&       ss,
     sxay(ss,xx,a,yy,0);
 }
 
+// ss = xx + a[n] * yy for the components of right-hand side n.
+void
+sxay (MultiFab&           ss,
+      const MultiFab&     xx,
+      const Vector<Real>& a,
+      const MultiFab&     yy)
+{
+    const int nrhs = a.size();
+    if (nrhs == 1) {
+        sxay(ss, xx, a[0], yy);
+        return;
+    }
+
+    BL_PROFILE("CGSolver::sxay()");
+
+    const int ncomp_per_rhs = ss.nComp() / nrhs;
+    for (int n = 0; n < nrhs; ++n) {
+        const int comp = n*ncomp_per_rhs;
+        MultiFab::LinComb(ss, 1.0, xx, comp, a[n], yy, comp, comp, ncomp_per_rhs, 0);
+    }
+}
+
+// p = r + beta[n] * (p - omega[n] * v), in one pass instead of two sxay()s.
+void
+updateDirection (MultiFab&           p,
+                 const MultiFab&     r,
+                 const Vector<Real>& beta,
+                 const Vector<Real>& omega,
+                 const MultiFab&     v)
+{
+    BL_PROFILE("CGSolver::updateDirection()");
+
+    using namespace MFExpr;
+    const int nrhs = beta.size();
+    const int ncomp_per_rhs = p.nComp() / nrhs;
+    for (int n = 0; n < nrhs; ++n) {
+        const int c = n*ncomp_per_rhs;
+        assign(p, c, ncomp_per_rhs, 0, ref(r,c) + beta[n]*(ref(p,c) - omega[n]*ref(v,c)));
+    }
+}
+
+// ss = ss + a[n] * xx + b[n] * yy, in one pass instead of two sxay()s.
+void
+sxaybz (MultiFab&           ss,
+        const Vector<Real>& a,
+        const MultiFab&     xx,
+        const Vector<Real>& b,
+        const MultiFab&     yy)
+{
+    BL_PROFILE("CGSolver::sxaybz()");
+
+    using namespace MFExpr;
+    const int nrhs = a.size();
+    const int ncomp_per_rhs = ss.nComp() / nrhs;
+    for (int n = 0; n < nrhs; ++n) {
+        const int c = n*ncomp_per_rhs;
+        assign(ss, c, ncomp_per_rhs, 0, ref(ss,c) + a[n]*ref(xx,c) + b[n]*ref(yy,c));
+    }
+}
+
+bool
+anyActive (const Vector<int>& active)
+{
+    return std::find(active.begin(), active.end(), 1) != active.end();
+}
+
+Vector<Real>
+negate (const Vector<Real>& a)
+{
+    Vector<Real> r(a.size());
+    for (int n = 0; n < a.size(); ++n) r[n] = -a[n];
+    return r;
+}
+
+// Largest relative error of the right-hand sides.
+Real
+maxRatio (const Vector<Real>& a, const Vector<Real>& b)
+{
+    Real r = 0.0;
+    for (int n = 0; n < a.size(); ++n) {
+        if (b[n] > 0.0) r = std::max(r, a[n]/b[n]);
+    }
+    return r;
+}
+
 }
 
 MLCGSolver::MLCGSolver (MLMG* a_mlmg, MLLinOp& _lp, Type _typ)
@@ -74,6 +160,12 @@ MLCGSolver::solve (MultiFab&       sol,
     }
 }
 
+//
+// With several right-hand sides, the Krylov scalars are computed for
+// each of them, with one reduction for all.  A right-hand side that
+// has converged or broken down is frozen by zeroing its step lengths.
+//
+
 int
 MLCGSolver::solve_bicgstab (MultiFab&       sol,
                             const MultiFab& rhs,
@@ -83,6 +175,7 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
     BL_PROFILE_REGION("MLCGSolver::bicgstab");
 
     const int nghost = sol.nGrow(), ncomp = sol.nComp();
+    const int nrhs = Lp.getNRHS();
 
     const BoxArray& ba = sol.boxArray();
     const DistributionMapping& dm = sol.DistributionMap();
@@ -114,58 +207,72 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real rnorm = norm_inf(r);
-    const Real rnorm0   = rnorm;
+    Vector<Real> rnorm = norm_inf(r);
+    const Vector<Real> rnorm0 = rnorm;
 
     if ( verbose > 0 )
     {
-        amrex::Print() << "MLCGSolver_BiCGStab: Initial error (error0) =        " << rnorm0 << '\n';
+        amrex::Print() << "MLCGSolver_BiCGStab: Initial error (error0) =        "
+                       << *std::max_element(rnorm0.begin(), rnorm0.end()) << '\n';
     }
-    int ret = 0, nit = 1;
-    Real rho_1 = 0, alpha = 0, omega = 0;
+    int nit = 1;
+    Vector<int> ret(nrhs, 0);
+    Vector<Real> rho_1(nrhs, 0.0), alpha(nrhs, 0.0), omega(nrhs, 0.0), beta(nrhs, 0.0);
+
+    auto converged = [&] (int n) { return rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs; };
 
-    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    Vector<int> active(nrhs);
+    for (int n = 0; n < nrhs; ++n) {
+        active[n] = !(rnorm0[n] == 0 || rnorm0[n] < eps_abs);
+    }
+
+    if ( !anyActive(active) )
     {
         if ( verbose > 0 )
 	{
             amrex::Print() << "MLCGSolver_BiCGStab: niter = 0,"
-                           << ", rnorm = " << rnorm 
+                           << ", rnorm = " << *std::max_element(rnorm.begin(), rnorm.end())
                            << ", eps_abs = " << eps_abs << std::endl;
 	}
-        return ret;
+        return finalize(sol, sorig, ret, rnorm, rnorm0, eps_rel, eps_abs, "MLCGSolver_BiCGStab");
     }
 
     for (; nit <= maxiter; ++nit)
     {
-        const Real rho = dotxy(rh,r);
-        if ( rho == 0 ) 
-	{
-            ret = 1; break;
-	}
+        const Vector<Real> rho = dotxy(rh,r);
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && rho[n] == 0 ) {
+                ret[n] = 1; active[n] = false;
+            }
+        }
+        if ( !anyActive(active) ) break;
+
         if ( nit == 1 )
         {
             MultiFab::Copy(p,r,0,0,ncomp,0);
         }
         else
         {
-            const Real beta = (rho/rho_1)*(alpha/omega);
-            sxay(p, p, -omega, v);
-            sxay(p, r,   beta, p);
+            for (int n = 0; n < nrhs; ++n) {
+                beta[n] = (active[n]) ? (rho[n]/rho_1[n])*(alpha[n]/omega[n]) : 0.0;
+            }
+            updateDirection(p, r, beta, omega, v);
         }
         MultiFab::Copy(ph,p,0,0,ncomp,0);
         Lp.apply(amrlev, mglev, v, ph, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
         Lp.normalize(amrlev, mglev, v);
 
-        if ( Real rhTv = dotxy(rh,v) )
-	{
-            alpha = rho/rhTv;
-	}
-        else
-	{
-            ret = 2; break;
-	}
-        sxay(sol, sol,  alpha, ph);
-        sxay(s,     r, -alpha,  v);
+        const Vector<Real> rhTv = dotxy(rh,v);
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && rhTv[n] == 0 ) {
+                ret[n] = 2; active[n] = false;
+            }
+            alpha[n] = (active[n]) ? rho[n]/rhTv[n] : 0.0;
+        }
+        if ( !anyActive(active) ) break;
+
+        // sol is updated with alpha*ph together with omega*sh below
+        sxay(s,     r, negate(alpha),  v);
 
         //Subtract mean from s 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, s);
@@ -177,10 +284,16 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
             amrex::Print() << "MLCGSolver_BiCGStab: Half Iter "
                            << std::setw(11) << nit
                            << " rel. err. "
-                           << rnorm/(rnorm0) << '\n';
+                           << maxRatio(rnorm,rnorm0) << '\n';
         }
 
-        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && converged(n) ) active[n] = false;
+        }
+        if ( !anyActive(active) ) {
+            sxay(sol, sol, alpha, ph);
+            break;
+        }
 
         MultiFab::Copy(sh,s,0,0,ncomp,0);
         Lp.apply(amrlev, mglev, t, sh, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
@@ -190,20 +303,27 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         // in the following two dotxy()s.  We do that by calculating the "local"
         // values and then reducing the two local values at the same time.
         //
-        Real tvals[2] = { dotxy(t,t,true), dotxy(t,s,true) };
+        Vector<Real> tvals = dotxy(t,t,true);
+        {
+            const Vector<Real> ts = dotxy(t,s,true);
+            tvals.insert(tvals.end(), ts.begin(), ts.end());
+        }
 
-        ParallelAllReduce::Sum(tvals,2,Lp.BottomCommunicator());
+        ParallelAllReduce::Sum(tvals.data(),2*nrhs,Lp.BottomCommunicator());
 
-        if ( tvals[0] )
-	{
-            omega = tvals[1]/tvals[0];
-	}
-        else
-	{
-            ret = 3; break;
-	}
-        sxay(sol, sol,  omega, sh);
-        sxay(r,     s, -omega,  t);
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && tvals[n] == 0 ) {
+                ret[n] = 3; active[n] = false;
+            }
+            omega[n] = (active[n]) ? tvals[nrhs+n]/tvals[n] : 0.0;
+        }
+        if ( !anyActive(active) ) {
+            sxay(sol, sol, alpha, ph);
+            break;
+        }
+
+        sxaybz(sol, alpha, ph, omega, sh);
+        sxay(r,     s, negate(omega),  t);
 
 //        if (Lp.isBottomSingular()) mlmg->makeSolvable(amrlev, mglev, r);
 
@@ -214,15 +334,19 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
             amrex::Print() << "MLCGSolver_BiCGStab: Iteration "
                            << std::setw(11) << nit
                            << " rel. err. "
-                           << rnorm/(rnorm0) << '\n';
+                           << maxRatio(rnorm,rnorm0) << '\n';
         }
 
-        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        for (int n = 0; n < nrhs; ++n) {
+            if ( !active[n] ) continue;
+            if ( converged(n) ) {
+                active[n] = false;
+            } else if ( omega[n] == 0 ) {
+                ret[n] = 4; active[n] = false;
+            }
+        }
+        if ( !anyActive(active) ) break;
 
-        if ( omega == 0 )
-	{
-            ret = 4; break;
-	}
         rho_1 = rho;
     }
 
@@ -231,27 +355,10 @@ MLCGSolver::solve_bicgstab (MultiFab&       sol,
         amrex::Print() << "MLCGSolver_BiCGStab: Final: Iteration "
                        << std::setw(4) << nit
                        << " rel. err. "
-                       << rnorm/(rnorm0) << '\n';
-    }
-
-    if ( ret == 0 && rnorm > eps_rel*rnorm0 && rnorm > eps_abs)
-    {
-        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
-            amrex::Warning("MLCGSolver_BiCGStab:: failed to converge!");
-        ret = 8;
-    }
-
-    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
-    {
-        sol.plus(sorig, 0, ncomp, 0);
-    } 
-    else 
-    {
-        sol.setVal(0);
-        sol.plus(sorig, 0, ncomp, 0);
+                       << maxRatio(rnorm,rnorm0) << '\n';
     }
 
-    return ret;
+    return finalize(sol, sorig, ret, rnorm, rnorm0, eps_rel, eps_abs, "MLCGSolver_BiCGStab");
 }
 
 int
@@ -263,6 +370,7 @@ MLCGSolver::solve_cg (MultiFab&       sol,
     BL_PROFILE_REGION("MLCGSolver::cg");
 
     const int nghost = sol.nGrow(), ncomp = sol.nComp();
+    const int nrhs = Lp.getNRHS();
 
     const BoxArray& ba = sol.boxArray();
     const DistributionMapping& dm = sol.DistributionMap();
@@ -282,68 +390,77 @@ MLCGSolver::solve_cg (MultiFab&       sol,
 
     sol.setVal(0);
 
-    Real       rnorm    = norm_inf(r);
-    const Real rnorm0   = rnorm;
+    Vector<Real>       rnorm    = norm_inf(r);
+    const Vector<Real> rnorm0   = rnorm;
 
     if ( verbose > 0 )
     {
-        amrex::Print() << "MLCGSolver_CG: Initial error (error0) :        " << rnorm0 << '\n';
+        amrex::Print() << "MLCGSolver_CG: Initial error (error0) :        "
+                       << *std::max_element(rnorm0.begin(), rnorm0.end()) << '\n';
     }
 
-    Real rho_1         = 0;
-    int  ret           = 0;
-    int  nit           = 1;
+    Vector<Real> rho_1(nrhs, 0.0), alpha(nrhs, 0.0), beta(nrhs, 0.0);
+    Vector<int>  ret(nrhs, 0);
+    int          nit           = 1;
 
-    if ( rnorm0 == 0 || rnorm0 < eps_abs )
+    Vector<int> active(nrhs);
+    for (int n = 0; n < nrhs; ++n) {
+        active[n] = !(rnorm0[n] == 0 || rnorm0[n] < eps_abs);
+    }
+
+    if ( !anyActive(active) )
     {
         if ( verbose > 0 ) {
             amrex::Print() << "MLCGSolver_CG: niter = 0,"
-                           << ", rnorm = " << rnorm 
+                           << ", rnorm = " << *std::max_element(rnorm.begin(), rnorm.end())
                            << ", eps_abs = " << eps_abs << std::endl;
         } 
-        return ret;
+        return finalize(sol, sorig, ret, rnorm, rnorm0, eps_rel, eps_abs, "MLCGSolver_cg");
     }
 
     for (; nit <= maxiter; ++nit)
     {
         MultiFab::Copy(z,r,0,0,ncomp,0);
 
-        Real rho = dotxy(z,r);
-
-        if ( rho == 0 )
-        {
-            ret = 1; break;
+        const Vector<Real> rho = dotxy(z,r);
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && rho[n] == 0 ) {
+                ret[n] = 1; active[n] = false;
+            }
         }
+        if ( !anyActive(active) ) break;
+
         if (nit == 1)
         {
             MultiFab::Copy(p,z,0,0,ncomp,0);
         }
         else
         {
-            Real beta = rho/rho_1;
+            for (int n = 0; n < nrhs; ++n) {
+                beta[n] = (active[n]) ? rho[n]/rho_1[n] : 0.0;
+            }
             sxay(p, z, beta, p);
         }
         Lp.apply(amrlev, mglev, q, p, MLLinOp::BCMode::Homogeneous, MLLinOp::StateMode::Correction);
 
-        Real alpha;
-        if ( Real pw = dotxy(p,q) )
-	{
-            alpha = rho/pw;
-	}
-        else
-	{
-            ret = 1; break;
-	}
-        
+        const Vector<Real> pw = dotxy(p,q);
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && pw[n] == 0 ) {
+                ret[n] = 1; active[n] = false;
+            }
+            alpha[n] = (active[n]) ? rho[n]/pw[n] : 0.0;
+        }
+        if ( !anyActive(active) ) break;
+
         if ( verbose > 2 )
         {
             amrex::Print() << "MLCGSolver_cg:"
                            << " nit " << nit
-                           << " rho " << rho
-                           << " alpha " << alpha << '\n';
+                           << " rho " << rho[0]
+                           << " alpha " << alpha[0] << '\n';
         }
         sxay(sol, sol, alpha, p);
-        sxay(  r,   r,-alpha, q);
+        sxay(  r,   r, negate(alpha), q);
         rnorm = norm_inf(r);
 
         if ( verbose > 2 )
@@ -351,10 +468,15 @@ MLCGSolver::solve_cg (MultiFab&       sol,
             amrex::Print() << "MLCGSolver_cg:       Iteration"
                            << std::setw(4) << nit
                            << " rel. err. "
-                           << rnorm/(rnorm0) << '\n';
+                           << maxRatio(rnorm,rnorm0) << '\n';
         }
 
-        if ( rnorm < eps_rel*rnorm0 || rnorm < eps_abs ) break;
+        for (int n = 0; n < nrhs; ++n) {
+            if ( active[n] && (rnorm[n] < eps_rel*rnorm0[n] || rnorm[n] < eps_abs) ) {
+                active[n] = false;
+            }
+        }
+        if ( !anyActive(active) ) break;
 
         rho_1 = rho;
     }
@@ -364,45 +486,78 @@ MLCGSolver::solve_cg (MultiFab&       sol,
         amrex::Print() << "MLCGSolver_cg: Final Iteration"
                        << std::setw(4) << nit
                        << " rel. err. "
-                       << rnorm/(rnorm0) << '\n';
+                       << maxRatio(rnorm,rnorm0) << '\n';
     }
 
-    if ( ret == 0 &&  rnorm > eps_rel*rnorm0 && rnorm > eps_abs )
-    {
-        if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
-            amrex::Warning("MLCGSolver_cg: failed to converge!");
-        ret = 8;
-    }
+    return finalize(sol, sorig, ret, rnorm, rnorm0, eps_rel, eps_abs, "MLCGSolver_cg");
+}
 
-    if ( ( ret == 0 || ret == 8 ) && (rnorm < rnorm0) )
-    {
-        sol.plus(sorig, 0, ncomp, 0);
-    } 
-    else 
+// Flags right-hand sides that did not converge, and keeps the new
+// solution only for those whose residual has decreased.  Returns the
+// first nonzero status.
+int
+MLCGSolver::finalize (MultiFab& sol, const MultiFab& sorig, Vector<int>& ret,
+                      const Vector<Real>& rnorm, const Vector<Real>& rnorm0,
+                      Real eps_rel, Real eps_abs, const char* name) const
+{
+    const int nrhs = ret.size();
+    const int ncomp_per_rhs = sol.nComp() / nrhs;
+
+    int status = 0;
+    for (int n = 0; n < nrhs; ++n)
     {
-        sol.setVal(0);
-        sol.plus(sorig, 0, ncomp, 0);
+        if ( ret[n] == 0 && rnorm[n] > eps_rel*rnorm0[n] && rnorm[n] > eps_abs )
+        {
+            if ( verbose > 0 && ParallelDescriptor::IOProcessor() )
+                amrex::Warning((std::string(name) + ": failed to converge!").c_str());
+            ret[n] = 8;
+        }
+
+        const int comp = n*ncomp_per_rhs;
+        if ( !(( ret[n] == 0 || ret[n] == 8 ) && (rnorm[n] < rnorm0[n])) )
+        {
+            sol.setVal(0.0, comp, ncomp_per_rhs);
+        }
+        sol.plus(sorig, comp, ncomp_per_rhs, 0);
+
+        if (status == 0) status = ret[n];
     }
 
-    return ret;
+    return status;
 }
 
-Real
+Vector<Real>
 MLCGSolver::dotxy (const MultiFab& r, const MultiFab& z, bool local)
 {
-    return Lp.xdoty(amrlev, mglev, r, z, local);
+    const int nrhs = Lp.getNRHS();
+    if (nrhs == 1) {
+        return {Lp.xdoty(amrlev, mglev, r, z, local)};
+    }
+
+    const int ncomp_per_rhs = r.nComp() / nrhs;
+    Vector<Real> result(nrhs);
+    for (int n = 0; n < nrhs; ++n) {
+        result[n] = MultiFab::Dot(r, n*ncomp_per_rhs, z, n*ncomp_per_rhs, ncomp_per_rhs, 0, true);
+    }
+    if (!local) {
+        ParallelAllReduce::Sum(result.data(), nrhs, Lp.BottomCommunicator());
+    }
+    return result;
 }
 
-Real
+Vector<Real>
 MLCGSolver::norm_inf (const MultiFab& res, bool local)
 {
     int ncomp = res.nComp();
-    Real result = std::numeric_limits<Real>::lowest();
-    for (int n=0; n<ncomp; n++)
-      result = std::max(result,res.norm0(n,0,true));
+    const int nrhs = Lp.getNRHS();
+    Vector<Real> result(nrhs, std::numeric_limits<Real>::lowest());
+    for (int n=0; n<ncomp; n++) {
+        Real& r = result[n*nrhs/ncomp];
+        r = std::max(r,res.norm0(n,0,true));
+    }
 
     if (!local) {
-        ParallelAllReduce::Max(result, Lp.BottomCommunicator());
+        ParallelAllReduce::Max(result.data(), nrhs, Lp.BottomCommunicator());
     }
     return result;
 }
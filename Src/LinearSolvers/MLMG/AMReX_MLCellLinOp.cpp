@@ -36,9 +36,15 @@ MLCellLinOp::defineAuxData ()
     m_undrrelxr.resize(m_num_amr_levels);
     m_maskvals.resize(m_num_amr_levels);
     m_fluxreg.resize(m_num_amr_levels-1);
+    m_deep_halo_buf.resize(m_num_amr_levels);
 
     const int ncomp = getNComp();
 
+    for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
+    {
+        m_deep_halo_buf[amrlev].resize(m_num_mg_levels[amrlev]);
+    }
+
     for (int amrlev = 0; amrlev < m_num_amr_levels; ++amrlev)
     {
         m_undrrelxr[amrlev].resize(m_num_mg_levels[amrlev]);
@@ -353,6 +359,71 @@ MLCellLinOp::smooth (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
     }
 }
 
+void
+MLCellLinOp::smoothN (int amrlev, int mglev, MultiFab& sol, const MultiFab& rhs,
+                      int nsmooth, bool skip_fillboundary) const
+{
+    if (!useDeepHaloSmooth(amrlev, mglev))
+    {
+        MLLinOp::smoothN(amrlev, mglev, sol, rhs, nsmooth, skip_fillboundary);
+        return;
+    }
+
+    BL_PROFILE("MLCellLinOp::smoothN()");
+
+    // Solution and rhs are packed into one buffer so that a single
+    // exchange fills both.  Each half sweep consumes one layer of
+    // ghost cells, so a halo of depth k serves k half sweeps.
+    const int ncomp = getNComp();
+    const int depth = info.smooth_halo_depth;
+    auto& buf = m_deep_halo_buf[amrlev][mglev];
+    if (buf == nullptr) {
+        buf.reset(new MultiFab(sol.boxArray(), sol.DistributionMap(), 2*ncomp, depth,
+                               MFInfo(), *m_factory[amrlev][mglev]));
+    }
+
+    MultiFab::Copy(*buf, sol, 0, 0    , ncomp, 0);
+    MultiFab::Copy(*buf, rhs, 0, ncomp, ncomp, 0);
+
+    const Periodicity& period = m_geom[amrlev][mglev].periodicity();
+    int nhalf = 2*nsmooth;
+    int redblack = 0;
+    bool rhs_filled = false;
+    while (nhalf > 0)
+    {
+        const int nsweeps = std::min(depth, nhalf);
+        // The first exchange is at least as deep as any later one.
+        const int nc = rhs_filled ? ncomp : 2*ncomp;
+        buf->FillBoundary(0, nc, IntVect(nsweeps), period);
+        rhs_filled = true;
+        for (int isweep = 0; isweep < nsweeps; ++isweep)
+        {
+            FsmoothDeepHalo(amrlev, mglev, *buf, redblack, nsweeps-1-isweep);
+            redblack = 1 - redblack;
+        }
+        nhalf -= nsweeps;
+    }
+
+    MultiFab::Copy(sol, *buf, 0, 0, ncomp, 0);
+}
+
+bool
+MLCellLinOp::useDeepHaloSmooth (int amrlev, int mglev) const
+{
+    if (info.smooth_halo_depth <= 1 || amrlev != 0 || mglev < info.smooth_halo_min_mglev
+        || !m_domain_covered[0] || !Geometry::isAllPeriodic() || getNComp() != 1)
+    {
+        return false;
+    }
+
+    const Box& domain = m_geom[amrlev][mglev].Domain();
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        if (domain.length(idim) % 2 != 0) return false;
+    }
+
+    return supportsDeepHaloSmooth(amrlev, mglev);
+}
+
 void
 MLCellLinOp::updateSolBC (int amrlev, const MultiFab& crse_bcdata) const
 {
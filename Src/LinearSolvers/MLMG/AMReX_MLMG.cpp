@@ -6,6 +6,8 @@
 #include <AMReX_MLMG_F.H>
 #include <AMReX_MLABecLaplacian.H>
 
+#include <algorithm>
+
 #ifdef AMREX_USE_PETSC
 #include <petscksp.h>
 #include <AMReX_PETSc.H>
@@ -40,6 +42,31 @@
 
 namespace amrex {
 
+namespace {
+
+// For printing one norm per right-hand side, optionally divided by a
+// per right-hand side scale.
+struct NormList
+{
+    explicit NormList (const Vector<Real>& a_v, const Vector<Real>& a_scale)
+        : v(a_v), scale(&a_scale) {}
+    explicit NormList (const Vector<Real>& a_v)
+        : v(a_v), scale(nullptr) {}
+    const Vector<Real>& v;
+    const Vector<Real>* scale;
+};
+
+std::ostream& operator<< (std::ostream& os, const NormList& nl)
+{
+    for (int n = 0; n < nl.v.size(); ++n) {
+        if (n > 0) os << " ";
+        os << ((nl.scale && (*nl.scale)[n] > 0.0) ? nl.v[n]/(*nl.scale)[n] : nl.v[n]);
+    }
+    return os;
+}
+
+}
+
 MLMG::MLMG (MLLinOp& a_lp)
     : linop(a_lp),
       namrlevs(a_lp.NAMRLevels()),
@@ -65,39 +92,63 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
     Real solve_start_time = amrex::second();
 
-    Real composite_norminf;
-
     prepareForSolve(a_sol, a_rhs);
 
     computeMLResidual(finest_amr_lev);
 
     int ncomp = linop.getNComp();
 
+    // With several right-hand sides, the norms and the convergence
+    // test are per right-hand side.
+    const int nrhs = linop.getNRHS();
+    auto all_le = [nrhs] (const Vector<Real>& a, const Vector<Real>& b) -> bool {
+        for (int n = 0; n < nrhs; ++n) {
+            if (a[n] > b[n]) return false;
+        }
+        return true;
+    };
+
     bool local = true;
-    Real resnorm0 = MLResNormInf(finest_amr_lev, local); 
-    Real rhsnorm0 = MLRhsNormInf(local); 
+    Vector<Real> resnorm0 = MLResNormInf(finest_amr_lev, local);
+    Vector<Real> rhsnorm0 = MLRhsNormInf(local);
     if (!is_nsolve) {
-        ParallelAllReduce::Max<Real>({resnorm0, rhsnorm0}, ParallelContext::CommunicatorSub());
+        Vector<Real> r = resnorm0;
+        r.insert(r.end(), rhsnorm0.begin(), rhsnorm0.end());
+        ParallelAllReduce::Max(r.data(), r.size(), ParallelContext::CommunicatorSub());
+        std::copy(r.begin(), r.begin()+nrhs, resnorm0.begin());
+        std::copy(r.begin()+nrhs, r.end(), rhsnorm0.begin());
 
         if (verbose >= 1)
         {
-            amrex::Print() << "MLMG: Initial rhs               = " << rhsnorm0 << "\n"
-                           << "MLMG: Initial residual (resid0) = " << resnorm0 << "\n";
+            amrex::Print() << "MLMG: Initial rhs               = " << NormList(rhsnorm0) << "\n"
+                           << "MLMG: Initial residual (resid0) = " << NormList(resnorm0) << "\n";
         }
     }
 
-    Real max_norm;
+    Vector<Real> max_norm(nrhs);
+    Vector<Real> res_target(nrhs);
+    int nbnorm = 0;
+    for (int n = 0; n < nrhs; ++n) {
+        if (always_use_bnorm or rhsnorm0[n] >= resnorm0[n]) {
+            max_norm[n] = rhsnorm0[n];
+            ++nbnorm;
+        } else {
+            max_norm[n] = resnorm0[n];
+        }
+        res_target[n] = std::max(a_tol_abs, std::max(a_tol_rel,1.e-16)*max_norm[n]);
+    }
     std::string norm_name;
-    if (always_use_bnorm or rhsnorm0 >= resnorm0) {
+    if (nbnorm == nrhs) {
         norm_name = "bnorm";
-        max_norm = rhsnorm0;
-    } else {
+    } else if (nbnorm == 0) {
         norm_name = "resid0";
-        max_norm = resnorm0;
+    } else {
+        norm_name = "max(bnorm,resid0)";
     }
-    const Real res_target = std::max(a_tol_abs, std::max(a_tol_rel,1.e-16)*max_norm);
 
-    if (!is_nsolve && resnorm0 <= res_target) {
+    Vector<Real> composite_norminf;
+
+    if (!is_nsolve && all_le(resnorm0, res_target)) {
         composite_norminf = resnorm0;
         if (verbose >= 1) {
             amrex::Print() << "MLMG: No iterations needed\n";
@@ -118,27 +169,29 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
 
             if (is_nsolve) continue;
 
-            Real fine_norminf = ResNormInf(finest_amr_lev);
+            Vector<Real> fine_norminf = ResNormInf(finest_amr_lev);
             composite_norminf = fine_norminf;
             if (verbose >= 2) {
                 amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1 << " Fine resid/"
-                               << norm_name << " = " << fine_norminf/max_norm << "\n";
+                               << norm_name << " = " << NormList(fine_norminf,max_norm) << "\n";
             }
-            bool fine_converged = (fine_norminf <= res_target);
+            bool fine_converged = all_le(fine_norminf, res_target);
 
             if (namrlevs == 1 and fine_converged) {
                 converged = true;
             } else if (fine_converged) {
                 // finest level is converged, but we still need to test the coarse levels
                 computeMLResidual(finest_amr_lev-1);
-                Real crse_norminf = MLResNormInf(finest_amr_lev-1);
+                Vector<Real> crse_norminf = MLResNormInf(finest_amr_lev-1);
                 if (verbose >= 2) {
                     amrex::Print() << "MLMG: Iteration " << std::setw(3) << iter+1
                                    << " Crse resid/" << norm_name << " = "
-                                   << crse_norminf/max_norm << "\n";
+                                   << NormList(crse_norminf,max_norm) << "\n";
+                }
+                converged = all_le(crse_norminf, res_target);
+                for (int n = 0; n < nrhs; ++n) {
+                    composite_norminf[n] = std::max(fine_norminf[n], crse_norminf[n]);
                 }
-                converged = (crse_norminf <= res_target);
-                composite_norminf = std::max(fine_norminf, crse_norminf);
             } else {
                 converged = false;
             }
@@ -147,8 +200,8 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
                 if (verbose >= 1) {
                     amrex::Print() << "MLMG: Final Iter. " << iter+1
                                    << " resid, resid/" << norm_name << " = "
-                                   << composite_norminf << ", "
-                                   << composite_norminf/max_norm << "\n";
+                                   << NormList(composite_norminf) << ", "
+                                   << NormList(composite_norminf,max_norm) << "\n";
                 }
                 break;
             }
@@ -157,8 +210,8 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
             if (verbose > 0) {
                 amrex::Print() << "MLMG: Failed to converge after " << max_iters << " iterations."
                                << " resid, resid/" << norm_name << " = "
-                               << composite_norminf << ", "
-                               << composite_norminf/max_norm << "\n";
+                               << NormList(composite_norminf) << ", "
+                               << NormList(composite_norminf,max_norm) << "\n";
             }
             amrex::Abort("MLMG failed");
         }
@@ -182,13 +235,16 @@ MLMG::solve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab const*>& a_rh
         {
             amrex::AllPrint() << "MLMG: Timers: Solve = " << timer[solve_time]
                               << " Iter = " << timer[iter_time]
-                              << " Bottom = " << timer[bottom_time] << "\n";
+                              << " Bottom = " << timer[bottom_time]
+                              << " Setup = " << timer[setup_time] << "\n";
         }
     }
 
     ++solve_called;
 
-    return composite_norminf;
+    final_resnorm = composite_norminf;
+    final_resnorm.resize(nrhs, 0.0);
+    return *std::max_element(final_resnorm.begin(), final_resnorm.end());
 }
 
 // in  : Residual (res) on the finest AMR level
@@ -381,11 +437,8 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
 
         cor[amrlev][mglev]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
-                         skip_fillboundary);
-            skip_fillboundary = false;
-        }
+        linop.smoothN(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev],
+                      nu1, skip_fillboundary);
 
         // rescor = res - L(cor)
         computeResOfCorrection(amrlev, mglev);
@@ -416,11 +469,8 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
     {
         cor[amrlev][mglev_bottom]->setVal(0.0);
         bool skip_fillboundary = true;
-        for (int i = 0; i < nu1; ++i) {
-            linop.smooth(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
-                         skip_fillboundary);
-            skip_fillboundary = false;
-        }
+        linop.smoothN(amrlev, mglev_bottom, *cor[amrlev][mglev_bottom], res[amrlev][mglev_bottom],
+                      nu1, skip_fillboundary);
     }
     BL_PROFILE_VAR_STOP(blp_bottom);
 
@@ -436,9 +486,7 @@ MLMG::mgVcycle (int amrlev, int mglev_top)
             amrex::Print() << "AT LEVEL "                << mglev << "\n"
                            << "   UP: Norm before smooth " << norm << "\n";
         }
-        for (int i = 0; i < nu2; ++i) {
-            linop.smooth(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev]);
-        }
+        linop.smoothN(amrlev, mglev, *cor[amrlev][mglev], res[amrlev][mglev], nu2);
         if (verbose >= 4)
         {
             computeResOfCorrection(amrlev, mglev);
@@ -813,6 +861,11 @@ MLMG::actualBottomSolve ()
             makeSolvable(amrlev,mglev,*bottom_b);
         }
 
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(linop.getNRHS() == 1 ||
+                                         (bottom_solver != BottomSolver::hypre &&
+                                          bottom_solver != BottomSolver::petsc),
+                                         "MLMG: hypre and PETSc bottom solvers take one rhs only");
+
         if (bottom_solver == BottomSolver::hypre)
         {
           bottomSolveWithHypre(x, *bottom_b);
@@ -850,14 +903,15 @@ MLMG::actualBottomSolve ()
     timer[bottom_time] += amrex::second() - bottom_start_time;
 }
 
-// Compute single-level masked inf-norm of Residual (res).
-Real
+// Compute single-level masked inf-norm of Residual (res) for each rhs.
+Vector<Real>
 MLMG::ResNormInf (int alev, bool local)
 {
     BL_PROFILE("MLMG::ResNormInf()");
     const int ncomp = linop.getNComp();
+    const int nrhs = linop.getNRHS();
     const int mglev = 0;
-    Real norm = 0.0;
+    Vector<Real> norm(nrhs, 0.0);
     MultiFab* pmf = &(res[alev][mglev]);
 #ifdef AMREX_USE_EB
     if (linop.isCellCentered() && scratch[alev]) {
@@ -878,33 +932,39 @@ MLMG::ResNormInf (int alev, bool local)
 	} else {
             newnorm = pmf->norm0(n,0,true);
 	}
-	if (newnorm > norm) norm = newnorm;
+        Real& r = norm[n*nrhs/ncomp];
+	if (newnorm > r) r = newnorm;
     }
-    if (!local) ParallelAllReduce::Max(norm, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(norm.data(), nrhs, ParallelContext::CommunicatorSub());
     return norm;
 }
 
-// Computes multi-level masked inf-norm of Residual (res).
-Real
+// Computes multi-level masked inf-norm of Residual (res) for each rhs.
+Vector<Real>
 MLMG::MLResNormInf (int alevmax, bool local)
 {
     BL_PROFILE("MLMG::MLResNormInf()");
-    Real r = 0.0;
+    const int nrhs = linop.getNRHS();
+    Vector<Real> r(nrhs, 0.0);
     for (int alev = 0; alev <= alevmax; ++alev)
     {
-        r = std::max(r, ResNormInf(alev,true));
+        const Vector<Real> rlev = ResNormInf(alev,true);
+        for (int n = 0; n < nrhs; ++n) {
+            r[n] = std::max(r[n], rlev[n]);
+        }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), nrhs, ParallelContext::CommunicatorSub());
     return r;
 }
 
-// Compute multi-level masked inf-norm of RHS (rhs).
-Real
+// Compute multi-level masked inf-norm of RHS (rhs) for each rhs.
+Vector<Real>
 MLMG::MLRhsNormInf (bool local)
 {
     BL_PROFILE("MLMG::MLRhsNormInf()");
     const int ncomp = linop.getNComp();
-    Real r = 0.0;
+    const int nrhs = linop.getNRHS();
+    Vector<Real> r(nrhs, 0.0);
     for (int alev = 0; alev <= finest_amr_lev; ++alev)
     {
         MultiFab* pmf = &(rhs[alev]);
@@ -921,14 +981,15 @@ MLMG::MLRhsNormInf (bool local)
 #endif
         for (int n=0; n<ncomp; ++n)
         {
+            Real& rn = r[n*nrhs/ncomp];
             if (alev < finest_amr_lev) {
-                r = std::max(r, pmf->norm0(*fine_mask[alev],n,0,true));
+                rn = std::max(rn, pmf->norm0(*fine_mask[alev],n,0,true));
             } else {
-                r = std::max(r, pmf->norm0(n,0,true));
+                rn = std::max(rn, pmf->norm0(n,0,true));
             }
         }
     }
-    if (!local) ParallelAllReduce::Max(r, ParallelContext::CommunicatorSub());
+    if (!local) ParallelAllReduce::Max(r.data(), nrhs, ParallelContext::CommunicatorSub());
     return r;
 }
 
@@ -988,12 +1049,16 @@ MLMG::prepareForSolve (const Vector<MultiFab*>& a_sol, const Vector<MultiFab con
 
     const int ncomp = linop.getNComp();
 
+    // The first solve does the full setup.  Later solves only redo the
+    // coefficient-dependent part if the coefficients have been changed.
+    const Real setup_start_time = amrex::second();
     if (!linop_prepared) {
         linop.prepareForSolve();
         linop_prepared = true;
     } else if (linop.needsUpdate()) {
         linop.update();
     }
+    timer[setup_time] = amrex::second() - setup_start_time;
 
 #ifdef AMREX_USE_HYPRE
     hypre_solver.reset();
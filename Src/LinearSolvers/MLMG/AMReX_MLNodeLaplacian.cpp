@@ -105,6 +105,7 @@ void
 MLNodeLaplacian::setSigma (int amrlev, const MultiFab& a_sigma)
 {
     MultiFab::Copy(*m_sigma[amrlev][0][0], a_sigma, 0, 0, 1, 0);
+    m_needs_update = true;
 }
 
 void
@@ -1080,10 +1081,12 @@ MLNodeLaplacian::buildStencil ()
     {
         for (int mglev = 0; mglev < m_num_mg_levels[amrlev]; ++mglev)
         {
-            m_stencil[amrlev][mglev].reset
-                (new MultiFab(amrex::convert(m_grids[amrlev][mglev],
-                                             IntVect::TheNodeVector()),
-                              m_dmap[amrlev][mglev], ncomp_s, 4));
+            if (m_stencil[amrlev][mglev] == nullptr) {
+                m_stencil[amrlev][mglev].reset
+                    (new MultiFab(amrex::convert(m_grids[amrlev][mglev],
+                                                 IntVect::TheNodeVector()),
+                                  m_dmap[amrlev][mglev], ncomp_s, 4));
+            }
             m_stencil[amrlev][mglev]->setVal(0.0);
         }
 
@@ -1272,6 +1275,22 @@ MLNodeLaplacian::prepareForSolve ()
 #endif
 
     buildStencil();
+
+    m_needs_update = false;
+}
+
+void
+MLNodeLaplacian::update ()
+{
+    BL_PROFILE("MLNodeLaplacian::update()");
+
+    // Masks, the EB integrals and the stencil MultiFabs depend on the
+    // grids only and are kept.  Only sigma and the stencil are redone.
+    averageDownCoeffs();
+
+    buildStencil();
+
+    m_needs_update = false;
 }
 
 void
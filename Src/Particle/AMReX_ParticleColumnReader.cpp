@@ -0,0 +1,201 @@
+
+#include <fstream>
+#include <sstream>
+#include <limits>
+
+#include <AMReX_ParticleColumnReader.H>
+#include <AMReX_Utility.H>
+#include <AMReX_NFiles.H>
+#include <AMReX_VectorIO.H>
+#include <AMReX_FPC.H>
+
+namespace amrex {
+
+ParticleColumnReader::ParticleColumnReader (const std::string& dir, const std::string& file)
+{
+    m_fullname = dir;
+    if (!m_fullname.empty() && m_fullname[m_fullname.size()-1] != '/')
+        m_fullname += '/';
+    m_fullname += file;
+
+    std::string HdrFileName = m_fullname + "/Header";
+    std::ifstream HdrFile(HdrFileName.c_str(), std::ios::in);
+    if (!HdrFile.good())
+        amrex::FileOpenFailed(HdrFileName);
+
+    std::string version;
+    HdrFile >> version;
+    if (version.find("Version_Two_Dot_One") == std::string::npos) {
+        std::string msg("ParticleColumnReader: not a columnar particle file: ");
+        msg += version;
+        amrex::Abort(msg.c_str());
+    }
+    m_single = version.find("_single") != std::string::npos;
+
+    int dm;
+    HdrFile >> dm;
+    if (dm != AMREX_SPACEDIM)
+        amrex::Abort("ParticleColumnReader: dm != AMREX_SPACEDIM");
+
+    const char* pos_names[] = {"position_x", "position_y", "position_z"};
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        m_real_names.push_back(pos_names[idim]);
+    }
+
+    int nr;
+    HdrFile >> nr;
+    std::string comp_name;
+    for (int i = 0; i < nr; ++i) {
+        HdrFile >> comp_name;
+        m_real_names.push_back(comp_name);
+    }
+
+    int ni;
+    HdrFile >> ni;
+    Vector<std::string> int_names(ni);
+    for (int i = 0; i < ni; ++i) {
+        HdrFile >> int_names[i];
+    }
+
+    HdrFile >> m_checkpoint;
+    if (m_checkpoint) {
+        m_int_names.push_back("id");
+        m_int_names.push_back("cpu");
+        m_int_names.insert(m_int_names.end(), int_names.begin(), int_names.end());
+    }
+
+    int maxnextid;
+    HdrFile >> m_nparticles >> maxnextid >> m_finest_level;
+
+    m_grids.resize(m_finest_level+1);
+    for (int lev = 0; lev <= m_finest_level; ++lev) {
+        int ngrids;
+        HdrFile >> ngrids;
+        m_grids[lev].resize(ngrids);
+    }
+
+    const int ncols = m_int_names.size() + m_real_names.size();
+    for (int lev = 0; lev <= m_finest_level; ++lev) {
+        for (auto& g : m_grids[lev]) {
+            long where;
+            HdrFile >> g.which >> g.count >> where;
+            g.offsets.resize(ncols);
+            for (int k = 0; k < ncols; ++k) {
+                HdrFile >> g.offsets[k];
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                HdrFile >> g.lo[idim];
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                HdrFile >> g.hi[idim];
+            }
+            if (g.count == 0) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    g.lo[idim] =  std::numeric_limits<Real>::max();
+                    g.hi[idim] = -std::numeric_limits<Real>::max();
+                }
+            }
+        }
+    }
+
+    if (!HdrFile.good())
+        amrex::Abort("ParticleColumnReader: problem reading Header");
+}
+
+RealBox
+ParticleColumnReader::boundingBox (int lev, int grid) const
+{
+    const GridInfo& g = m_grids[lev][grid];
+    return RealBox(g.lo, g.hi);
+}
+
+Vector<int>
+ParticleColumnReader::gridsIntersecting (int lev, const RealBox& rb) const
+{
+    Vector<int> grids;
+    for (int i = 0, N = m_grids[lev].size(); i < N; ++i) {
+        if (m_grids[lev][i].count > 0 && boundingBox(lev,i).intersects(rb)) {
+            grids.push_back(i);
+        }
+    }
+    return grids;
+}
+
+int
+ParticleColumnReader::realCompIndex (const std::string& name) const
+{
+    for (int i = 0, N = m_real_names.size(); i < N; ++i) {
+        if (m_real_names[i] == name) return i;
+    }
+    return -1;
+}
+
+int
+ParticleColumnReader::intCompIndex (const std::string& name) const
+{
+    for (int i = 0, N = m_int_names.size(); i < N; ++i) {
+        if (m_int_names[i] == name) return i;
+    }
+    return -1;
+}
+
+std::string
+ParticleColumnReader::dataFileName (int lev, int grid) const
+{
+    std::string name = amrex::Concatenate(m_fullname + "/Level_", lev, 1);
+    name += "/DATA_";
+    return NFilesIter::FileName(m_grids[lev][grid].which, name);
+}
+
+void
+ParticleColumnReader::readRealComp (int lev, int grid, int comp, Vector<Real>& data) const
+{
+    BL_ASSERT(comp >= 0 && comp < int(m_real_names.size()));
+
+    const GridInfo& g = m_grids[lev][grid];
+    data.resize(g.count);
+    if (g.count == 0) return;
+
+    std::string name = dataFileName(lev, grid);
+    std::ifstream ifs(name.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs.good())
+        amrex::FileOpenFailed(name);
+
+    ifs.seekg(g.offsets[m_int_names.size()+comp], std::ios::beg);
+
+    if (m_single) {
+        Vector<float> buf(g.count);
+        readFloatData(buf.dataPtr(), buf.size(), ifs, FPC::Native32RealDescriptor());
+        for (int i = 0; i < g.count; ++i) data[i] = buf[i];
+    } else {
+        Vector<double> buf(g.count);
+        readDoubleData(buf.dataPtr(), buf.size(), ifs, FPC::Native64RealDescriptor());
+        for (int i = 0; i < g.count; ++i) data[i] = buf[i];
+    }
+
+    if (!ifs.good())
+        amrex::Abort("ParticleColumnReader::readRealComp(): problem reading particles");
+}
+
+void
+ParticleColumnReader::readIntComp (int lev, int grid, int comp, Vector<int>& data) const
+{
+    BL_ASSERT(comp >= 0 && comp < int(m_int_names.size()));
+
+    const GridInfo& g = m_grids[lev][grid];
+    data.resize(g.count);
+    if (g.count == 0) return;
+
+    std::string name = dataFileName(lev, grid);
+    std::ifstream ifs(name.c_str(), std::ios::in | std::ios::binary);
+    if (!ifs.good())
+        amrex::FileOpenFailed(name);
+
+    ifs.seekg(g.offsets[comp], std::ios::beg);
+    readIntData(data.dataPtr(), data.size(), ifs, FPC::NativeIntDescriptor());
+
+    if (!ifs.good())
+        amrex::Abort("ParticleColumnReader::readIntComp(): problem reading particles");
+}
+
+}
@@ -1,19 +1,50 @@
 #include <AMReX_ParticleMPIUtil.H>
 
+#include <algorithm>
+#include <limits>
+
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_BLProfiler.H>
 
 namespace amrex {
 
+    ParticlePeerBuffers::ParticlePeerBuffers (const Vector<int>& procs)
+        : m_procs(procs)
+    {
+        std::sort(m_procs.begin(), m_procs.end());
+        m_procs.erase(std::unique(m_procs.begin(), m_procs.end()), m_procs.end());
+        m_bufs.resize(m_procs.size());
+    }
+
+    Vector<char>& ParticlePeerBuffers::operator[] (int proc)
+    {
+        if (m_last >= 0 && m_procs[m_last] == proc) {
+            return m_bufs[m_last];
+        }
+        auto it = std::lower_bound(m_procs.begin(), m_procs.end(), proc);
+        m_last = it - m_procs.begin();
+        if (it == m_procs.end() || *it != proc) {
+            m_procs.insert(it, proc);
+            m_bufs.insert(m_bufs.begin() + m_last, Vector<char>());
+        }
+        return m_bufs[m_last];
+    }
+
+    int ParticlePeerBuffers::find (int proc) const
+    {
+        auto it = std::lower_bound(m_procs.begin(), m_procs.end(), proc);
+        return (it != m_procs.end() && *it == proc) ? int(it - m_procs.begin()) : -1;
+    }
+
 #ifdef BL_USE_MPI    
     
-    long CountSnds(const std::map<int, Vector<char> >& not_ours, Vector<long>& Snds)
+    long CountSnds(const ParticlePeerBuffers& not_ours, Vector<long>& Snds)
     {
         long NumSnds = 0;        
-        for (const auto& kv : not_ours)
+        for (int i = 0; i < not_ours.size(); ++i)
         {
-            NumSnds       += kv.second.size();
-            Snds[kv.first] = kv.second.size();
+            NumSnds                 += not_ours.buffer(i).size();
+            Snds[not_ours.proc(i)]   = not_ours.buffer(i).size();
         }
         
         ParallelDescriptor::ReduceLongMax(NumSnds);
@@ -21,7 +52,7 @@ namespace amrex {
         return NumSnds;
     }
 
-    long doHandShake(const std::map<int, Vector<char> >& not_ours,
+    long doHandShake(const ParticlePeerBuffers& not_ours,
                      Vector<long>& Snds, Vector<long>& Rcvs)
     {
         long NumSnds = CountSnds(not_ours, Snds);
@@ -46,15 +77,15 @@ namespace amrex {
         return NumSnds;
     }
 
-    long doHandShakeLocal(const std::map<int, Vector<char> >& not_ours,
+    long doHandShakeLocal(const ParticlePeerBuffers& not_ours,
                           const Vector<int>& neighbor_procs, Vector<long>& Snds, Vector<long>& Rcvs)
     {
 
         long NumSnds = 0;        
-        for (const auto& kv : not_ours)
+        for (int i = 0; i < not_ours.size(); ++i)
         {
-            NumSnds       += kv.second.size();
-            Snds[kv.first] = kv.second.size();
+            NumSnds                 += not_ours.buffer(i).size();
+            Snds[not_ours.proc(i)]   = not_ours.buffer(i).size();
         }
 
         const int SeqNum = ParallelDescriptor::SeqNum();
@@ -89,6 +120,81 @@ namespace amrex {
         
         return NumSnds;
     }
+
+#if MPI_VERSION >= 3
+    void doSparseExchange(const ParticlePeerBuffers& not_ours,
+                          Vector<char>& recvdata, int SeqNum)
+    {
+        BL_PROFILE("doSparseExchange()");
+
+        MPI_Comm comm = ParallelDescriptor::Communicator();
+
+        // Synchronous sends complete only once they have been matched, so
+        // a process enters the barrier after its messages have arrived.
+        // Once the barrier completes on all processes, nothing is in flight.
+        Vector<MPI_Request> sreqs(not_ours.size(), MPI_REQUEST_NULL);
+        for (int i = 0; i < not_ours.size(); ++i)
+        {
+            const int Who = not_ours.proc(i);
+            const auto Cnt = not_ours.buffer(i).size();
+
+            BL_ASSERT(Who >= 0 && Who < ParallelDescriptor::NProcs());
+            BL_ASSERT(Cnt < std::numeric_limits<int>::max());
+
+            BL_MPI_REQUIRE( MPI_Issend(not_ours.buffer(i).data(), Cnt, MPI_CHAR, Who, SeqNum,
+                                       comm, &sreqs[i]) );
+        }
+
+        // Sorted by sender so that the result does not depend on arrival order
+        ParticlePeerBuffers rcvs;
+
+        MPI_Request breq;
+        bool in_barrier = false;
+        int done = 0;
+        while (!done)
+        {
+            int flag;
+            MPI_Status status;
+            BL_MPI_REQUIRE( MPI_Iprobe(MPI_ANY_SOURCE, SeqNum, comm, &flag, &status) );
+            if (flag)
+            {
+                int Cnt;
+                BL_MPI_REQUIRE( MPI_Get_count(&status, MPI_CHAR, &Cnt) );
+                auto& buf = rcvs[status.MPI_SOURCE];
+                buf.resize(Cnt);
+                BL_MPI_REQUIRE( MPI_Recv(buf.data(), Cnt, MPI_CHAR, status.MPI_SOURCE, SeqNum,
+                                         comm, MPI_STATUS_IGNORE) );
+            }
+
+            if (in_barrier)
+            {
+                BL_MPI_REQUIRE( MPI_Test(&breq, &done, MPI_STATUS_IGNORE) );
+            }
+            else
+            {
+                int sent;
+                BL_MPI_REQUIRE( MPI_Testall(sreqs.size(), sreqs.data(), &sent,
+                                            MPI_STATUSES_IGNORE) );
+                if (sent)
+                {
+                    BL_MPI_REQUIRE( MPI_Ibarrier(comm, &breq) );
+                    in_barrier = true;
+                }
+            }
+        }
+
+        std::size_t TotRcvBytes = 0;
+        for (int i = 0; i < rcvs.size(); ++i) {
+            TotRcvBytes += rcvs.buffer(i).size();
+        }
+        recvdata.clear();
+        recvdata.reserve(TotRcvBytes);
+        for (int i = 0; i < rcvs.size(); ++i) {
+            recvdata.insert(recvdata.end(), rcvs.buffer(i).begin(), rcvs.buffer(i).end());
+        }
+    }
+#endif
+
 #endif  // BL_USE_MPI
 
 }
@@ -0,0 +1,163 @@
+//
+// Times BoxArray::intersections with the hash bins, with the R-tree and
+// with the automatic choice between them (boxarray.use_tree = 0).
+//
+// For every BoxArray file, and for a variant of it in which every other
+// box is chopped into boxes of at most 8 cells per side, the boxes grown
+// by two cells are intersected with the BoxArray, as in FillBoundary, and
+// complementIn is called for the same boxes.  The results of the hash and
+// of the tree must be identical.
+//
+//     tBAIsects.ex files="ba.23925 ba.15784" ng=2
+//
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+struct Result
+{
+    Real t_build, t_isects, t_compl;
+    long nisects;
+    BoxArray ba;
+};
+
+Result
+run (const BoxArray& ba_in, int use_tree, int ng)
+{
+    Result r;
+    r.nisects = 0;
+
+    BARef::use_tree = use_tree;
+    r.ba = ba_in;
+    r.ba.uniqify();
+    const BoxArray& ba = r.ba;
+
+    Real t0 = ParallelDescriptor::second();
+    ba.intersects(ba[0]);
+    r.t_build = ParallelDescriptor::second() - t0;
+
+    std::vector< std::pair<int,Box> > isects;
+    t0 = ParallelDescriptor::second();
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        ba.intersections(amrex::grow(ba[i],ng), isects);
+        r.nisects += isects.size();
+    }
+    r.t_isects = ParallelDescriptor::second() - t0;
+
+    BoxList bl;
+    t0 = ParallelDescriptor::second();
+    for (int i = 0, N = ba.size(); i < N; ++i)
+    {
+        ba.complementIn(bl, amrex::grow(ba[i],ng));
+    }
+    r.t_compl = ParallelDescriptor::second() - t0;
+
+    return r;
+}
+
+//! The index structure was fixed when the BoxArrays were built.
+bool
+same (const BoxArray& a, const BoxArray& b, int ng)
+{
+    std::vector< std::pair<int,Box> > isa, isb;
+    BoxList bla, blb;
+    for (int i = 0, N = a.size(); i < N; ++i)
+    {
+        const Box& bx = amrex::grow(a[i],ng);
+        a.intersections(bx, isa);
+        b.intersections(bx, isb);
+        if (isa != isb) return false;
+        a.complementIn(bla, bx);
+        b.complementIn(blb, bx);
+        if (bla.data() != blb.data()) return false;
+    }
+    return true;
+}
+
+void
+bench (const std::string& name, const BoxArray& ba, int ng, bool check)
+{
+    const Result h = run(ba, -1, ng);
+    const Result t = run(ba,  1, ng);
+    const Result a = run(ba,  0, ng);
+
+    amrex::Print() << std::setprecision(3)
+                   << std::left << std::setw(18) << name
+                   << std::right << std::setw(8) << ba.size()
+                   << std::setw(11) << h.t_build << std::setw(11) << t.t_build
+                   << std::setw(11) << h.t_isects << std::setw(11) << t.t_isects
+                   << std::setw(11) << h.t_compl << std::setw(11) << t.t_compl
+                   << std::setw(11) << a.t_isects << std::setw(10) << h.nisects;
+    if (check) {
+        amrex::Print() << (same(h.ba, t.ba, ng) ? "  ok" : "  MISMATCH");
+    }
+    amrex::Print() << "\n";
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        std::vector<std::string> files {"ba.60", "ba.213", "ba.mac.294", "ba.3865", "ba.5034",
+                                        "ba.15456", "ba.15784", "ba.23925", "ba.25600", "ba.95860"};
+        int ng = 2;
+        int check = 1;
+        {
+            ParmParse pp;
+            pp.queryarr("files", files);
+            pp.query("ng", ng);
+            pp.query("check", check);
+        }
+
+        amrex::Print() << std::left << std::setw(18) << "BoxArray"
+                       << std::right << std::setw(8) << "boxes"
+                       << std::setw(11) << "hash bld" << std::setw(11) << "tree bld"
+                       << std::setw(11) << "hash isct" << std::setw(11) << "tree isct"
+                       << std::setw(11) << "hash cmpl" << std::setw(11) << "tree cmpl"
+                       << std::setw(11) << "auto isct" << std::setw(10) << "isects" << "\n";
+
+        for (const auto& f : files)
+        {
+            std::ifstream ifs(f.c_str(), std::ios::in);
+            if (!ifs.good()) {
+                amrex::Print() << "Cannot open " << f << "\n";
+                continue;
+            }
+            BoxArray ba;
+            ba.readFrom(ifs);
+
+            bench(f, ba, ng, check);
+            //
+            // Every other box chopped into small ones.
+            //
+            BoxList bl;
+            for (int i = 0, N = ba.size(); i < N; ++i)
+            {
+                if (i % 2 == 0) {
+                    BoxList bli(ba[i]);
+                    bli.maxSize(8);
+                    bl.join(bli);
+                } else {
+                    bl.push_back(ba[i]);
+                }
+            }
+            bench(f + " mixed", BoxArray(bl), ng, check);
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,136 @@
+//
+// Checks amrex::sameBoxes and DistributionMapping::makeIncremental on a new
+// BoxArray that keeps half of the boxes of an old one, in another order,
+// and has new boxes of different sizes in place of some of the others.
+// The kept boxes must keep their old owners, unless the old owner is not
+// in the communicator, and each of the other boxes, largest first, must go
+// to a process with the fewest cells at the time.
+//
+//     tIncremental.ex n_cell=64 max_grid_size=16
+//
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_DistributionMapping.H>
+
+using namespace amrex;
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 64, max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        auto check = [&] (bool ok, const char* what) {
+            amrex::Print() << std::setw(44) << std::left << what << (ok ? "ok\n" : "FAILED\n");
+            if (!ok) ++nfails;
+        };
+
+        const int nprocs = ParallelDescriptor::NProcs();
+
+        BoxArray old_ba(Box(IntVect(AMREX_D_DECL(0,0,0)),
+                            IntVect(AMREX_D_DECL(n_cell-1,n_cell-1,n_cell-1))));
+        old_ba.maxSize(max_grid_size);
+        const int nold = old_ba.size();
+
+        //
+        // The even boxes are kept, in reverse order.  The first odd boxes are
+        // replaced by boxes of max_grid_size-1, max_grid_size-2, ... cells in
+        // the first direction, so that no two new boxes have the same size.
+        //
+        BoxList bl;
+        std::vector<int> expected;
+        for (int i = nold-1; i >= 0; --i) {
+            if (i % 2 == 0) {
+                bl.push_back(old_ba[i]);
+                expected.push_back(i);
+            }
+        }
+        for (int i = 1, k = 1; i < nold && k < max_grid_size; i += 2, ++k) {
+            Box bx = old_ba[i];
+            bx.setBig(0, bx.bigEnd(0)-k);
+            bl.push_back(bx);
+            expected.push_back(-1);
+        }
+        const BoxArray ba(bl);
+
+        {
+            const Vector<int>& same = amrex::sameBoxes(old_ba, old_ba);
+            bool ok = same.size() == nold;
+            for (int i = 0; i < same.size() && ok; ++i) ok = same[i] == i;
+            check(ok, "sameBoxes of a BoxArray with itself");
+        }
+
+        {
+            const Vector<int>& same = amrex::sameBoxes(ba, old_ba);
+            check(same.size() == ba.size()
+                  && std::equal(same.begin(), same.end(), expected.begin()),
+                  "sameBoxes of the new boxes in the old ones");
+        }
+
+        {
+            const Vector<int>& same = amrex::sameBoxes(amrex::convert(ba, IntVect::TheDimensionVector(0)),
+                                                       old_ba);
+            const Vector<int>& none = amrex::sameBoxes(ba, BoxArray());
+            check(std::count(same.begin(), same.end(), -1) == same.size()
+                  && std::count(none.begin(), none.end(), -1) == none.size(),
+                  "sameBoxes of other index types and none");
+        }
+
+        //
+        // The old owner of box 0 is not in the communicator, so that box is
+        // placed like a new one.
+        //
+        Vector<int> old_pmap(nold);
+        for (int i = 0; i < nold; ++i) old_pmap[i] = i % nprocs;
+        old_pmap[0] = nprocs;
+        const DistributionMapping old_dm(old_pmap);
+
+        const DistributionMapping dm = DistributionMapping::makeIncremental(ba, old_ba, old_dm);
+
+        bool kept = dm.size() == ba.size();
+        std::vector<long> load(nprocs, 0);
+        std::vector<std::pair<long,int> > fresh;
+        for (int i = 0; i < ba.size() && kept; ++i) {
+            kept = dm[i] >= 0 && dm[i] < nprocs;
+            const int j = expected[i];
+            if (j >= 0 && old_pmap[j] < nprocs) {
+                kept = kept && dm[i] == old_pmap[j];
+                load[dm[i]] += ba[i].numPts();
+            } else {
+                fresh.push_back(std::make_pair(ba[i].numPts(), i));
+            }
+        }
+        check(kept, "makeIncremental keeps the old owners");
+
+        std::sort(fresh.begin(), fresh.end(), std::greater<std::pair<long,int> >());
+        bool balanced = kept;
+        for (const auto& f : fresh) {
+            if (!balanced) break;
+            balanced = load[dm[f.second]] == *std::min_element(load.begin(), load.end());
+            load[dm[f.second]] += f.first;
+        }
+        check(balanced, "makeIncremental balances the new boxes");
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("tIncremental failed");
+    }
+    amrex::Print() << "tIncremental passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,178 @@
+//
+// Checks MFExpr::assign and MFExpr::assign_dot (AMReX_MultiFabExpr.H)
+// against MultiFab::LinComb, MultiFab::Dot and loops over the cells, on
+// random data with ghost cells, boxes of odd lengths and component
+// offsets.  The expressions that compute the same operations in the same
+// order as LinComb or as the loops must give bitwise identical results,
+// also when the destination is an operand.  The dot products may only
+// differ by rounding, as they are summed in another order; the difference
+// is relative to |d|*|y|, the bound of the dot product of d and y.
+//
+//     tMFExpr.ex n_cell=37 max_grid_size=16
+//
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabExpr.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+void
+fillRandom (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        Real* p = fab.dataPtr();
+        for (long i = 0, n = fab.box().numPts()*fab.nComp(); i < n; ++i) {
+            p[i] = 0.5 + amrex::Random();
+        }
+    }
+}
+
+//! The number of values in comps [0,ncomp) and nghost ghost cells that differ.
+long
+numDiffs (const MultiFab& a, int acomp, const MultiFab& b, int bcomp, int ncomp, int nghost)
+{
+    long ndiffs = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.growntilebox(nghost);
+        const FArrayBox& fa = a[mfi];
+        const FArrayBox& fb = b[mfi];
+        for (int n = 0; n < ncomp; ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fa(iv,acomp+n) != fb(iv,bcomp+n)) ++ndiffs;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(ndiffs);
+    return ndiffs;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 37;
+        int max_grid_size = 16;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+        }
+
+        amrex::InitRandom(8642);
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 3;
+        const int ng = 1;
+        MultiFab x(ba, dm, ncomp, ng), y(ba, dm, ncomp, ng), z(ba, dm, ncomp, ng);
+        fillRandom(x);
+        fillRandom(y);
+        fillRandom(z);
+
+        const Real a = 0.3, b = -1.7;
+
+        auto report = [&] (const char* what, long ndiffs) {
+            amrex::Print() << std::setw(40) << std::left << what << ndiffs << " values differ\n";
+            if (ndiffs > 0) ++nfails;
+        };
+
+        using namespace MFExpr;
+
+        // a*x + b*y on all the components and the ghost cells
+        {
+            MultiFab d1(ba, dm, ncomp, ng), d2(ba, dm, ncomp, ng);
+            MultiFab::LinComb(d1, a, x, 0, b, y, 0, 0, ncomp, ng);
+            assign(d2, 0, ncomp, ng, a*ref(x) + b*ref(y));
+            report("assign a*x+b*y, LinComb", numDiffs(d1, 0, d2, 0, ncomp, ng));
+        }
+
+        // component offsets, the other components are not touched
+        {
+            MultiFab d1(ba, dm, ncomp, ng), d2(ba, dm, ncomp, ng);
+            d1.setVal(-1.0);
+            d2.setVal(-1.0);
+            MultiFab::LinComb(d1, a, x, 1, b, y, 0, 1, 2, 0);
+            assign(d2, 1, 2, 0, a*ref(x,1) + b*ref(y,0));
+            report("assign with offsets, LinComb", numDiffs(d1, 0, d2, 0, ncomp, ng));
+        }
+
+        // the destination as an operand: s = s + a*x + b*y
+        {
+            MultiFab s1(ba, dm, ncomp, 0), s2(ba, dm, ncomp, 0);
+            MultiFab::Copy(s1, z, 0, 0, ncomp, 0);
+            MultiFab::Copy(s2, z, 0, 0, ncomp, 0);
+            MultiFab::LinComb(s1, 1.0, s1, 0, a, x, 0, 0, ncomp, 0);
+            MultiFab::LinComb(s1, 1.0, s1, 0, b, y, 0, 0, ncomp, 0);
+            assign(s2, ref(s2) + a*ref(x) + b*ref(y));
+            report("assign s+a*x+b*y, two LinCombs", numDiffs(s1, 0, s2, 0, ncomp, 0));
+        }
+
+        // the other operators, scalars on either side and unary minus
+        {
+            MultiFab d1(ba, dm, ncomp, ng), d2(ba, dm, ncomp, ng);
+            for (MFIter mfi(d1); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.growntilebox(ng);
+                for (int n = 0; n < ncomp; ++n) {
+                    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                        const Real xv = x[mfi](iv,n), yv = y[mfi](iv,n), zv = z[mfi](iv,n);
+                        d1[mfi](iv,n) = -(xv*yv - a) / zv + (b - yv/2.0)*(-zv);
+                    }
+                }
+            }
+            assign(d2, 0, ncomp, ng, -(ref(x)*ref(y) - a) / ref(z) + (b - ref(y)/2.0)*(-ref(z)));
+            report("assign with - * / and negation", numDiffs(d1, 0, d2, 0, ncomp, ng));
+        }
+
+        // the dot product of the result with another MultiFab
+        {
+            MultiFab d1(ba, dm, ncomp, ng), d2(ba, dm, ncomp, ng);
+            MultiFab::LinComb(d1, a, x, 0, b, y, 0, 0, ncomp, ng);
+            const Real dot1 = MultiFab::Dot(d1, 0, z, 0, ncomp, ng);
+            const Real dot2 = assign_dot(d2, 0, ncomp, ng, a*ref(x) + b*ref(y), z, 0);
+            report("assign_dot result, LinComb", numDiffs(d1, 0, d2, 0, ncomp, ng));
+
+            const Real scale = std::sqrt(MultiFab::Dot(d1, 0, d1, 0, ncomp, ng)
+                                         * MultiFab::Dot(z, 0, z, 0, ncomp, ng));
+            const Real err = std::abs(dot2 - dot1) / scale;
+            amrex::Print() << std::setw(40) << std::left << "assign_dot, Dot" << "relative difference "
+                           << std::setprecision(3) << err << "\n";
+            if (!(err <= 1.e-12)) ++nfails;
+
+            // a range of components, the dot with the destination itself
+            const Real dot3 = MultiFab::Dot(d1, 1, d1, 1, 2, 0);
+            const Real dot4 = assign_dot(d2, 1, 2, 0, a*ref(x,1) + b*ref(y,1), d2, 1);
+            const Real err2 = std::abs(dot4 - dot3) / dot3;
+            amrex::Print() << std::setw(40) << std::left << "assign_dot on components 1, 2, Dot"
+                           << "relative difference " << std::setprecision(3) << err2 << "\n";
+            if (!(err2 <= 1.e-12)) ++nfails;
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("tMFExpr failed");
+    }
+    amrex::Print() << "tMFExpr passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,147 @@
+//
+// Checks the Philox4x32-10 generator of AMReX_Philox.H against the known
+// answers of the Random123 library (kat_vectors), and that FillRandom and
+// FillRandomNormal give the same numbers as Philox::uniform and
+// Philox::normal for an index range, however it is split, and for a list
+// of indices.
+//
+//     tPhilox.ex n=1000
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Philox.H>
+
+using namespace amrex;
+
+namespace {
+
+struct KnownAnswer
+{
+    std::uint32_t ctr[4];
+    std::uint32_t key[2];
+    std::uint32_t out[4];
+};
+
+const KnownAnswer known_answers[] = {
+    { {0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u},
+      {0x00000000u, 0x00000000u},
+      {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u} },
+    { {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+      {0xffffffffu, 0xffffffffu},
+      {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu} },
+    { {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+      {0xa4093822u, 0x299f31d0u},
+      {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u} }
+};
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        long n = 1000;
+        {
+            ParmParse pp;
+            pp.query("n", n);
+        }
+
+        auto check = [&] (bool ok, const char* what) {
+            amrex::Print() << std::setw(44) << std::left << what << (ok ? "ok\n" : "FAILED\n");
+            if (!ok) ++nfails;
+        };
+
+        // the known answers of philox4x32 with ten rounds
+        {
+            bool ok = true;
+            for (const auto& ka : known_answers) {
+                Philox::Counter c = {{ka.ctr[0], ka.ctr[1], ka.ctr[2], ka.ctr[3]}};
+                c = Philox::philox4x32(c, ka.key[0], ka.key[1]);
+                for (int i = 0; i < 4; ++i) {
+                    ok = ok && (c.v[i] == ka.out[i]);
+                }
+            }
+            check(ok, "philox4x32, Random123 known answers");
+        }
+
+        // (seed, index, stream) are the key and the counter
+        {
+            const Philox::Counter c = Philox::bits(0, 0, 0);
+            bool ok = true;
+            for (int i = 0; i < 4; ++i) {
+                ok = ok && (c.v[i] == known_answers[0].out[i]);
+            }
+            check(ok, "Philox::bits, Random123 known answer");
+        }
+
+        const unsigned long seed = 12345;
+        const unsigned long first = (1ul << 33) + 7;  // above 32 bits
+        const unsigned int stream = 2;
+
+        std::vector<Real> ref(n), refn(n);
+        bool inrange = true;
+        for (long i = 0; i < n; ++i) {
+            ref[i]  = Philox::uniform(seed, first+i, stream);
+            refn[i] = Philox::normal(1.5, 0.25, seed, first+i, stream);
+            inrange = inrange && ref[i] >= 0.0 && ref[i] < 1.0;
+        }
+        check(inrange, "Philox::uniform in [0,1)");
+
+        // the range in one piece and in uneven pieces
+        {
+            std::vector<Real> a(n), b(n), c(n), d(n);
+            FillRandom(a.data(), n, seed, first, stream);
+            FillRandomNormal(c.data(), n, 1.5, 0.25, seed, first, stream);
+            for (long lo = 0, len = 1; lo < n; lo += len, len = 2*len+1) {
+                const long m = std::min(len, n-lo);
+                FillRandom(b.data()+lo, m, seed, first+lo, stream);
+                FillRandomNormal(d.data()+lo, m, 1.5, 0.25, seed, first+lo, stream);
+            }
+            check(a == ref && b == ref, "FillRandom, index range");
+            check(c == refn && d == refn, "FillRandomNormal, index range");
+        }
+
+        // a list of indices, in reverse order
+        {
+            std::vector<long> index(n);
+            for (long i = 0; i < n; ++i) {
+                index[i] = first + (n-1-i);
+            }
+            std::vector<Real> a(n), c(n);
+            FillRandom(a.data(), index.data(), n, seed, stream);
+            FillRandomNormal(c.data(), index.data(), n, 1.5, 0.25, seed, stream);
+            bool ok = true, okn = true;
+            for (long i = 0; i < n; ++i) {
+                ok  = ok  && a[i] == ref[n-1-i];
+                okn = okn && c[i] == refn[n-1-i];
+            }
+            check(ok, "FillRandom, index list");
+            check(okn, "FillRandomNormal, index list");
+        }
+
+        // other streams and seeds give other numbers
+        {
+            std::vector<Real> a(n), b(n);
+            FillRandom(a.data(), n, seed, first, stream+1);
+            FillRandom(b.data(), n, seed+1, first, stream);
+            check(a != ref && b != ref, "other streams and seeds");
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("tPhilox failed");
+    }
+    amrex::Print() << "tPhilox passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,185 @@
+//
+// Measures the halo exchange of BoxArrays whose boxes are in the order
+// they were read or made, in Morton order and in Hilbert order (see
+// amrex::sfcOrder and amr.sfc_order), for several ways of dealing out
+// the boxes to nranks simulated processes:
+//
+//   blocks      contiguous runs of boxes in BoxArray order, i.e., along
+//               the curve for the sorted BoxArrays;
+//   RoundRobin  box i on rank i % nranks;
+//   KnapSack    boxes by numPts, largest first, on the least loaded rank.
+//
+// For every BoxArray file, the boxes are first chopped with maxSize, as
+// AmrMesh::ChopGrids does.  The boxes grown by ng cells are intersected
+// with the BoxArray as in FillBoundary.  "msgs" is the number of pairs of
+// ranks that exchange data, "max/rank" the largest number of messages a
+// rank receives, and "cells" the number of ghost cells that come from
+// another rank.  "hash" is the time to build the hash of the BoxArray.
+//
+//     tSFCOrder.ex files="ba.23925 ba.15784" nranks=256 ng=2 max_size=32 bf=8
+//
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <fstream>
+#include <iostream>
+#include <queue>
+#include <set>
+
+#include <AMReX.H>
+#include <AMReX_BoxArray.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+Vector<int>
+blocks (const BoxArray& ba, int nranks)
+{
+    const long N = ba.size();
+    Vector<int> pmap(N);
+    for (long i = 0; i < N; ++i) {
+        pmap[i] = static_cast<int>(i*nranks/N);
+    }
+    return pmap;
+}
+
+Vector<int>
+roundRobin (const BoxArray& ba, int nranks)
+{
+    Vector<int> pmap(ba.size());
+    for (int i = 0, N = ba.size(); i < N; ++i) {
+        pmap[i] = i % nranks;
+    }
+    return pmap;
+}
+
+Vector<int>
+knapSack (const BoxArray& ba, int nranks)
+{
+    const int N = ba.size();
+    std::vector<std::pair<long,int> > boxes(N);
+    for (int i = 0; i < N; ++i) {
+        boxes[i] = std::make_pair(-ba[i].numPts(), i);
+    }
+    std::sort(boxes.begin(), boxes.end());
+
+    typedef std::pair<long,int> Load;  // (cells, rank)
+    std::priority_queue<Load, std::vector<Load>, std::greater<Load> > load;
+    for (int r = 0; r < nranks; ++r) {
+        load.push(Load(0L, r));
+    }
+
+    Vector<int> pmap(N);
+    for (const auto& b : boxes)
+    {
+        Load l = load.top();
+        load.pop();
+        pmap[b.second] = l.second;
+        l.first -= b.first;
+        load.push(l);
+    }
+    return pmap;
+}
+
+void
+measure (const std::string& name, const std::string& order, const BoxArray& ba_in,
+         int nranks, int ng)
+{
+    BoxArray ba(ba_in);  // a new hash
+    Real t0 = ParallelDescriptor::second();
+    ba.intersects(ba[0]);
+    const Real t_hash = ParallelDescriptor::second() - t0;
+
+    static const char* names[] = {"blocks", "RoundRobin", "KnapSack"};
+    const Vector<int> pmaps[] = {blocks(ba, nranks), roundRobin(ba, nranks), knapSack(ba, nranks)};
+
+    std::vector< std::pair<int,Box> > isects;
+
+    for (int s = 0; s < 3; ++s)
+    {
+        const Vector<int>& pmap = pmaps[s];
+
+        std::set<std::pair<int,int> > pairs;
+        long cells = 0;
+        for (int i = 0, N = ba.size(); i < N; ++i)
+        {
+            ba.intersections(amrex::grow(ba[i],ng), isects);
+            for (const auto& is : isects)
+            {
+                if (pmap[is.first] != pmap[i]) {
+                    pairs.insert(std::make_pair(pmap[i], pmap[is.first]));
+                    cells += is.second.numPts();
+                }
+            }
+        }
+
+        std::vector<int> nrecv(nranks, 0);
+        for (const auto& p : pairs) {
+            ++nrecv[p.first];
+        }
+
+        amrex::Print() << std::setprecision(3)
+                       << std::left << std::setw(16) << name
+                       << std::setw(9) << order
+                       << std::setw(12) << names[s]
+                       << std::right << std::setw(8) << ba.size()
+                       << std::setw(10) << pairs.size()
+                       << std::setw(10) << *std::max_element(nrecv.begin(), nrecv.end())
+                       << std::setw(13) << cells
+                       << std::setw(11) << t_hash << "\n";
+    }
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        std::vector<std::string> files {"ba.213", "ba.3865", "ba.5034", "ba.15784", "ba.23925"};
+        int nranks = 256;
+        int ng = 2;
+        int max_size = 32;
+        int bf = 8;
+        {
+            ParmParse pp;
+            pp.queryarr("files", files);
+            pp.query("nranks", nranks);
+            pp.query("ng", ng);
+            pp.query("max_size", max_size);
+            pp.query("bf", bf);
+        }
+
+        amrex::Print() << std::left << std::setw(16) << "BoxArray"
+                       << std::setw(9) << "order"
+                       << std::setw(12) << "strategy"
+                       << std::right << std::setw(8) << "boxes"
+                       << std::setw(10) << "msgs"
+                       << std::setw(10) << "max/rank"
+                       << std::setw(13) << "cells"
+                       << std::setw(11) << "hash" << "\n";
+
+        for (const auto& f : files)
+        {
+            std::ifstream ifs(f.c_str(), std::ios::in);
+            if (!ifs.good()) {
+                amrex::Print() << "Cannot open " << f << "\n";
+                continue;
+            }
+            BoxArray ba;
+            ba.readFrom(ifs);
+            ba.maxSize(max_size);
+
+            measure(f, "index",   ba, nranks, ng);
+            measure(f, "Morton",  amrex::sfcOrder(ba, IntVect(bf), false), nranks, ng);
+            measure(f, "Hilbert", amrex::sfcOrder(ba, IntVect(bf), true),  nranks, ng);
+        }
+    }
+    amrex::Finalize();
+}
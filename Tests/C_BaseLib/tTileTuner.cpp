@@ -0,0 +1,109 @@
+//
+// Runs a seven-point stencil with the tile size picked by TileSizeTuner
+// and with the default tile size, and prints the time per call of each.
+// It is for 3D.
+//
+//     tTileTuner.ex n_cell=128 max_grid_size=64 ncomp=1 nsteps=40 tile_tuner.verbose=1
+//
+// With tile_tuner.file=tiles.txt, a second run reads the tile size from
+// the file and does not tune.
+//
+
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TileSizeTuner.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+void
+stencil (MultiFab& dst, const MultiFab& src, const IntVect& tilesize)
+{
+    const int ncomp = dst.nComp();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(dst, tilesize); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        FArrayBox& d = dst[mfi];
+        const FArrayBox& s = src[mfi];
+        const IntVect lo = bx.smallEnd();
+        const IntVect hi = bx.bigEnd();
+        for (int n = 0; n < ncomp; ++n) {
+            for (int k = lo[2]; k <= hi[2]; ++k) {
+                for (int j = lo[1]; j <= hi[1]; ++j) {
+                    for (int i = lo[0]; i <= hi[0]; ++i) {
+                        const IntVect iv(i,j,k);
+                        d(iv,n) = s(IntVect(i-1,j,k),n) + s(IntVect(i+1,j,k),n)
+                            +     s(IntVect(i,j-1,k),n) + s(IntVect(i,j+1,k),n)
+                            +     s(IntVect(i,j,k-1),n) + s(IntVect(i,j,k+1),n)
+                            - 6.0*s(iv,n);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 64;
+        int ncomp = 1;
+        int nsteps = 40;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ncomp", ncomp);
+            pp.query("nsteps", nsteps);
+        }
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        MultiFab src(ba, dm, ncomp, 1);
+        MultiFab dst(ba, dm, ncomp, 0);
+        src.setVal(1.0);
+
+        double t_tuned = 0.0;
+        IntVect tuned;
+        for (int step = 0; step < nsteps; ++step)
+        {
+            const double t0 = amrex::second();
+            {
+                TileSizeTuner tuner("tTileTuner::stencil", dst);
+                stencil(dst, src, tuner.tileSize());
+                tuned = tuner.tileSize();
+            }
+            if (step >= nsteps/2) t_tuned += amrex::second() - t0;
+        }
+
+        double t_default = 0.0;
+        for (int step = 0; step < nsteps; ++step)
+        {
+            const double t0 = amrex::second();
+            stencil(dst, src, FabArrayBase::mfiter_tile_size);
+            if (step >= nsteps/2) t_default += amrex::second() - t0;
+        }
+
+        const int ncalls = nsteps - nsteps/2;
+        amrex::Print() << "tuned   tile size " << tuned << ": "
+                       << t_tuned/ncalls << " seconds per call\n"
+                       << "default tile size " << FabArrayBase::mfiter_tile_size << ": "
+                       << t_default/ncalls << " seconds per call\n";
+    }
+    amrex::Finalize();
+}
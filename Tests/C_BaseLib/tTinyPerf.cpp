@@ -0,0 +1,104 @@
+//
+// Runs timed MFIter loops with the event counters of the tiny profiler
+// and checks that the perf_event fds are closed by amrex::Finalize.  It
+// is built with TINY_PROFILE = TRUE on Linux.
+//
+//     tTinyPerf.ex tiny_profiler.perf_counters=1 n_cell=64 max_grid_size=32 nsteps=10
+//
+// amrex::Initialize and amrex::Finalize are called twice, so that the
+// second run also checks that the fds of the first one are not reused.
+// The number of open fds before the first Initialize and after each
+// Finalize are printed, and the program aborts if they differ.
+//
+
+#include <dirent.h>
+
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_BLProfiler.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace {
+
+int
+numOpenFds ()
+{
+    int n = 0;
+    if (DIR* d = opendir("/proc/self/fd")) {
+        while (readdir(d) != nullptr) ++n;
+        closedir(d);
+    }
+    return n;
+}
+
+void
+run ()
+{
+    BL_PROFILE("run()");
+
+    int n_cell = 64;
+    int max_grid_size = 32;
+    int nsteps = 10;
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("nsteps", nsteps);
+    }
+
+    BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+    ba.maxSize(max_grid_size);
+    DistributionMapping dm(ba);
+    MultiFab mf(ba, dm, 1, 0);
+
+    for (int step = 0; step < nsteps; ++step)
+    {
+        BL_PROFILE("setVal");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(mf,true); mfi.isValid(); ++mfi) {
+            mf[mfi].setVal(Real(step), mfi.tilebox());
+        }
+    }
+
+    for (int step = 0; step < nsteps; ++step)
+    {
+        BL_PROFILE("plus");
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        for (MFIter mfi(mf,true); mfi.isValid(); ++mfi) {
+            mf[mfi].plus(1.0, mfi.tilebox());
+        }
+    }
+
+    amrex::Print() << "sum = " << mf.sum() << "\n";
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    const int nfds = numOpenFds();
+
+    for (int i = 0; i < 2; ++i)
+    {
+        amrex::Initialize(argc,argv);
+        run();
+        amrex::Finalize();
+
+        const int n = numOpenFds();
+        std::cout << "open fds: " << nfds << " before, " << n << " after run " << i << std::endl;
+        if (n != nfds) {
+            std::cerr << "tTinyPerf: the perf_event fds are not closed" << std::endl;
+            return 1;
+        }
+    }
+}
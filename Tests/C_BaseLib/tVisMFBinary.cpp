@@ -0,0 +1,196 @@
+//
+// Writes a MultiFab with the binary header version NoFabHeaderBinary_v1
+// (vismf.headerversion = 5) and reads it back with every reader:
+//
+//   VisMF::Read into an empty MultiFab, which reads the whole binary header;
+//   VisMF::Read into a defined MultiFab, with and without
+//     vismf.uselocalheaderread, where each rank reads only its own records;
+//   the VisMF constructor and VisMF::GetFab, one fab at a time.
+//
+// The data, ghost cells included, must be bitwise identical to those
+// written, the BoxArray and the number of components and ghost cells the
+// same, and the per-fab and FabArray mins and maxes those of the valid
+// data.  The MultiFab has boxes of different sizes, and 1 and 3 data files are
+// written.
+//
+//     tVisMFBinary.ex n_cell=40 max_grid_size=16 dir=tVisMFBinary_mf
+//
+
+#include <iostream>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+using namespace amrex;
+
+namespace {
+
+//! The number of values, ghost cells included, that differ.
+long
+numDiffs (const MultiFab& a, const MultiFab& b)
+{
+    long ndiffs = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fa = a[mfi];
+        const FArrayBox& fb = b[mfi];
+        if (fa.box() != fb.box() || fa.nComp() != fb.nComp()) {
+            ndiffs += fa.box().numPts()*fa.nComp();
+            continue;
+        }
+        const Real* pa = fa.dataPtr();
+        const Real* pb = fb.dataPtr();
+        for (long i = 0, n = fa.box().numPts()*fa.nComp(); i < n; ++i) {
+            if (pa[i] != pb[i]) ++ndiffs;
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(ndiffs);
+    return ndiffs;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 40;
+        int max_grid_size = 16;
+        std::string dir = "tVisMFBinary_mf";
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("dir", dir);
+        }
+
+        amrex::InitRandom(1111 + ParallelDescriptor::MyProc());
+
+        // boxes of different sizes, not starting at 0
+        const Box domain(IntVect(-3), IntVect(n_cell-4));
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        const int ncomp = 3;
+        const IntVect ngrow(AMREX_D_DECL(2,1,2));
+        MultiFab mf(ba, dm, ncomp, ngrow);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+        {
+            FArrayBox& fab = mf[mfi];
+            Real* p = fab.dataPtr();
+            for (long i = 0, n = fab.box().numPts()*fab.nComp(); i < n; ++i) {
+                p[i] = amrex::Random() - 0.5;
+            }
+        }
+
+        if (ParallelDescriptor::IOProcessor()) {
+            amrex::UtilCreateDirectory(dir, 0755);
+        }
+        ParallelDescriptor::Barrier();
+
+        const VisMF::Header::Version oldVersion = VisMF::GetHeaderVersion();
+        const int oldNOutFiles = VisMF::GetNOutFiles();
+        const bool oldLocal = VisMF::GetUseLocalHeaderRead();
+
+        auto check = [&] (bool ok, const std::string& what) {
+            amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+            if (!ok) ++nfails;
+        };
+
+        VisMF::SetHeaderVersion(VisMF::Header::NoFabHeaderBinary_v1);
+
+        for (int nfiles : {1, 3})
+        {
+            const std::string name = dir + "/mf" + std::to_string(nfiles);
+            const std::string tag = "nfiles " + std::to_string(nfiles) + ": ";
+            VisMF::SetNOutFiles(nfiles);
+            VisMF::Write(mf, name);
+            // the headers are written by the coordinator of the write, which
+            // need not be the rank that reads them
+            ParallelDescriptor::Barrier();
+
+            // into an empty MultiFab
+            {
+                MultiFab mf2;
+                VisMF::Read(mf2, name);
+                const bool layout = mf2.boxArray() == ba && mf2.nComp() == ncomp
+                                 && mf2.nGrowVect() == ngrow;
+                check(layout, tag + "Read into an empty MultiFab, layout");
+                if (layout) {
+                    // the reader makes its own DistributionMapping, compare
+                    // with a read into a MultiFab defined on it, checked below
+                    MultiFab mf3(ba, mf2.DistributionMap(), ncomp, ngrow);
+                    VisMF::SetUseLocalHeaderRead(false);
+                    VisMF::Read(mf3, name);
+                    VisMF::SetUseLocalHeaderRead(oldLocal);
+                    const bool same = (mf2.DistributionMap() == dm) ? numDiffs(mf, mf2) == 0
+                                                                    : numDiffs(mf3, mf2) == 0;
+                    check(same, tag + "Read into an empty MultiFab, data");
+                }
+            }
+
+            // into a defined MultiFab, with the whole and the local header
+            for (bool local : {false, true})
+            {
+                VisMF::SetUseLocalHeaderRead(local);
+                MultiFab mf2(ba, dm, ncomp, ngrow);
+                mf2.setVal(-99.0);
+                VisMF::Read(mf2, name);
+                check(numDiffs(mf, mf2) == 0,
+                      tag + "Read into a defined MultiFab, local header " + (local ? "on" : "off"));
+            }
+            VisMF::SetUseLocalHeaderRead(oldLocal);
+
+            // the VisMF object, its header and GetFab
+            {
+                VisMF vmf(name);
+                check(vmf.boxArray() == ba && vmf.nComp() == ncomp && vmf.nGrowVect() == ngrow,
+                      tag + "VisMF header layout");
+
+                bool minmax = true, data = true;
+                for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+                {
+                    const int idx = mfi.index();
+                    const FArrayBox& fab = mf[mfi];
+                    for (int n = 0; n < ncomp; ++n) {
+                        minmax = minmax && vmf.min(idx, n) == fab.min(ba[idx], n)
+                                        && vmf.max(idx, n) == fab.max(ba[idx], n);
+                        const FArrayBox& vfab = vmf.GetFab(idx, n);
+                        data = data && vfab.box() == fab.box();
+                        for (IntVect iv = fab.box().smallEnd(); data && iv <= fab.box().bigEnd();
+                             fab.box().next(iv))
+                        {
+                            data = (vfab(iv) == fab(iv,n));
+                        }
+                        vmf.clear(idx, n);
+                    }
+                }
+                for (int n = 0; n < ncomp; ++n) {
+                    minmax = minmax && vmf.min(n) == mf.min(n) && vmf.max(n) == mf.max(n);
+                }
+                ParallelDescriptor::ReduceBoolAnd(minmax);
+                ParallelDescriptor::ReduceBoolAnd(data);
+                check(minmax, tag + "VisMF min and max");
+                check(data, tag + "VisMF::GetFab");
+            }
+        }
+
+        VisMF::SetHeaderVersion(oldVersion);
+        VisMF::SetNOutFiles(oldNOutFiles);
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("tVisMFBinary failed");
+    }
+    amrex::Print() << "tVisMFBinary passed\n";
+
+    amrex::Finalize();
+}
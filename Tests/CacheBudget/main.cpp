@@ -0,0 +1,216 @@
+//
+// Checks that evicting items from the communication metadata caches (see
+// fabarray.cache_max_mb) does not change any result.  The same sequence of
+// ParallelCopy, ParallelCopy_nowait with a FillBoundary before its finish,
+// FillBoundary and FillPatchTwoLevels runs on nlayouts long-lived layouts,
+// first without a budget, then with a budget of 200 kB and of 1 byte.  All
+// the data, ghost cells included, must be bitwise identical to those of
+// the run without a budget.  For every run the evictions and the sum of
+// the peak bytes of the caches are printed.
+//
+//     main.ex n_cell=32 nlayouts=12 niters=3
+//
+// The USE_PERILLA build ignores the budget, see FabArrayBase::Initialize.
+//
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+
+using namespace amrex;
+
+namespace {
+
+//! Access to the statistics of the caches.
+struct CacheStatsReader
+    : public FabArrayBase
+{
+    static std::vector<CacheStats*> all () {
+        return {&m_FBC_stats, &m_CPC_stats, &m_FPinfo_stats, &m_CFinfo_stats};
+    }
+};
+
+class NoOpPhysBC
+    : public PhysBCFunctBase
+{
+public:
+    virtual void FillBoundary (MultiFab&, int, int, Real) override {}
+    using PhysBCFunctBase::FillBoundary;
+};
+
+void
+fillRandom (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        Real* p = fab.dataPtr();
+        for (long i = 0, n = fab.box().numPts()*fab.nComp(); i < n; ++i) {
+            p[i] = amrex::Random();
+        }
+    }
+}
+
+void
+append (std::vector<Real>& v, const MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fab = mf[mfi];
+        v.insert(v.end(), fab.dataPtr(), fab.dataPtr() + fab.box().numPts()*fab.nComp());
+    }
+}
+
+//! Runs the sequence and returns all the data.
+std::vector<Real>
+run (int n_cell, int nlayouts, int niters)
+{
+    const int ncomp = 2;
+    const int ngrow = 2;
+    const IntVect ratio(2);
+
+    RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+    int is_per[] = {AMREX_D_DECL(1,1,1)};
+    const Box fdomain(IntVect(0), IntVect(n_cell-1));
+    const Box cdomain = amrex::coarsen(fdomain, ratio);
+    Geometry fgeom(fdomain, &rb, 0, is_per);
+    Geometry cgeom(cdomain, &rb, 0, is_per);
+    NoOpPhysBC physbc;
+
+    Vector<BCRec> bcs(ncomp);
+    for (auto& bc : bcs) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::int_dir);
+            bc.setHi(idim, BCType::int_dir);
+        }
+    }
+
+    amrex::InitRandom(2468);
+
+    BoxArray cba(cdomain);
+    cba.maxSize(8);
+    MultiFab crse(cba, DistributionMapping(cba), ncomp, 0);
+    fillRandom(crse);
+
+    // The even layouts cover the domain, the odd ones the middle of it.
+    std::vector<std::unique_ptr<MultiFab> > mfs;
+    for (int i = 0; i < nlayouts; ++i)
+    {
+        BoxArray ba((i%2 == 0) ? fdomain : Box(IntVect(n_cell/4), IntVect(3*n_cell/4-1)));
+        ba.maxSize(4 + 2*(i/2));
+        mfs.emplace_back(new MultiFab(ba, DistributionMapping(ba), ncomp, ngrow));
+        fillRandom(*mfs.back());
+    }
+
+    std::vector<std::unique_ptr<MultiFab> > patched;
+    for (int i = 0; i < nlayouts; i += 2) {
+        patched.emplace_back(new MultiFab(mfs[i]->boxArray(), mfs[i]->DistributionMap(),
+                                          ncomp, ngrow));
+    }
+
+    for (int iter = 0; iter < niters; ++iter)
+    {
+        for (int i = 0; i < nlayouts; ++i)
+        {
+            MultiFab& a = *mfs[i];
+            MultiFab& b = *mfs[(i+1)%nlayouts];
+            MultiFab& c = *mfs[(i+5)%nlayouts];
+
+            b.ParallelCopy(a, 0, 0, ncomp, IntVect(0), IntVect(1), fgeom.periodicity());
+
+            {
+                auto handle = c.ParallelCopy_nowait(a, 1, 0, 1, IntVect(0), IntVect(0),
+                                                    fgeom.periodicity());
+                // builds and possibly evicts other items before the finish
+                a.FillBoundary(fgeom.periodicity());
+                handle.finish();
+            }
+
+            c.FillBoundary(fgeom.periodicity());
+
+            // fine data in the middle of the domain, coarse data around it
+            const int j = ((i%2 == 1) ? i+1 : i+2) % nlayouts;
+            MultiFab* fine = mfs[(i%2 == 1) ? i : (i+1)%nlayouts].get();
+            MultiFab& dst = *patched[j/2];
+            FillPatchTwoLevels(dst, Real(0.0), {&crse}, {Real(0.0)}, {fine}, {Real(0.0)},
+                               0, 0, ncomp, cgeom, fgeom, physbc, physbc, ratio,
+                               &cell_cons_interp, bcs);
+        }
+    }
+
+    std::vector<Real> data;
+    for (const auto& mf : mfs) append(data, *mf);
+    for (const auto& mf : patched) append(data, *mf);
+    return data;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    bool passed = true;
+    {
+        int n_cell = 32;
+        int nlayouts = 12;
+        int niters = 3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("nlayouts", nlayouts);
+            pp.query("niters", niters);
+        }
+        nlayouts = std::max(2, nlayouts - nlayouts%2);
+
+        std::vector<Real> ref;
+        for (long budget : {0L, 200L*1024L, 1L})
+        {
+            FabArrayBase::cache_max_bytes = budget;
+
+            long nevict0 = 0;
+            for (auto* s : CacheStatsReader::all()) {
+                nevict0 += s->nevict;
+                s->bytes_hwm = s->bytes;
+            }
+
+            std::vector<Real> data = run(n_cell, nlayouts, niters);
+
+            long nevict = -nevict0, peak = 0;
+            for (auto* s : CacheStatsReader::all()) {
+                nevict += s->nevict;
+                peak += s->bytes_hwm;
+            }
+
+            bool same = true;
+            if (ref.empty()) {
+                ref.swap(data);
+            } else {
+                same = (data == ref);
+                passed = passed && same;
+            }
+
+            amrex::Print() << "budget " << std::setw(8) << budget << " bytes: "
+                           << std::setw(6) << nevict << " evictions, peak "
+                           << std::setw(10) << peak << " bytes, "
+                           << (same ? "identical" : "DIFFERENT") << "\n";
+        }
+        FabArrayBase::cache_max_bytes = 0;
+    }
+
+    if (!passed) {
+        amrex::Abort("CacheBudget failed");
+    }
+    amrex::Print() << "CacheBudget passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,228 @@
+//
+// Compares FillPatchSingleLevel with two times, which interpolates in
+// time while copying (FabArray::ParallelCopyLinComb), with the two-copy
+// path it replaced: BaseFab::linInterp into a temporary on the BoxArray of
+// the data, then a copy.  The destination has a different BoxArray and
+// ghost cells, the domain is periodic in all but the last direction, and
+// 1 and 3 components are used in turn.  The results must be bitwise
+// identical.
+//
+// Then FillPatchTwoLevels is called repeatedly with 3, 1 and 3 components,
+// so that the coarse patches kept with the cached FPinfo are reused, and
+// each result is compared bitwise with that of the first call.
+//
+//     main.ex n_cell=64 max_grid_size=16 ngrow=2
+//
+
+#include <iomanip>
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+
+using namespace amrex;
+
+namespace {
+
+class NoOpPhysBC
+    : public PhysBCFunctBase
+{
+public:
+    virtual void FillBoundary (MultiFab&, int, int, Real) override {}
+    using PhysBCFunctBase::FillBoundary;
+};
+
+void
+fillRandom (MultiFab& mf)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        Real* p = fab.dataPtr();
+        for (long i = 0, n = fab.box().numPts()*fab.nComp(); i < n; ++i) {
+            p[i] = amrex::Random();
+        }
+    }
+}
+
+//! The number of values, ghost cells included, that differ in comps [0,ncomp).
+long
+numDiffs (const MultiFab& a, int acomp, const MultiFab& b, int bcomp, int ncomp)
+{
+    long ndiffs = 0;
+    for (MFIter mfi(a); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fa = a[mfi];
+        const FArrayBox& fb = b[mfi];
+        const Box& bx = fa.box();
+        for (int n = 0; n < ncomp; ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                if (fa(iv,acomp+n) != fb(iv,bcomp+n)) ++ndiffs;
+            }
+        }
+    }
+    ParallelDescriptor::ReduceLongSum(ndiffs);
+    return ndiffs;
+}
+
+Real
+checksum (const MultiFab& mf, int comp, int ncomp)
+{
+    Real s = 0.0;
+    for (int n = 0; n < ncomp; ++n) {
+        s += mf.norm1(comp+n, mf.nGrow());
+    }
+    return s;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    long nfails = 0;
+    {
+        int n_cell = 64;
+        int max_grid_size = 16;
+        int ngrow = 2;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("ngrow", ngrow);
+        }
+
+        amrex::InitRandom(1234);
+
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_per[] = {AMREX_D_DECL(1,1,1)};
+        is_per[AMREX_SPACEDIM-1] = 0;
+        NoOpPhysBC physbc;
+
+        const Real t0 = 0.0, t1 = 1.0, time = 0.3;
+
+        //
+        // FillPatchSingleLevel against the two-copy path.
+        //
+        {
+            const Box domain(IntVect(0), IntVect(n_cell-1));
+            Geometry geom(domain, &rb, 0, is_per);
+
+            BoxArray sba(domain);
+            sba.maxSize(max_grid_size);
+            DistributionMapping sdm(sba);
+
+            BoxArray dba(domain);
+            dba.maxSize(max_grid_size/2 + max_grid_size/4);
+            DistributionMapping ddm(dba);
+
+            for (int ncomp : {1, 3})
+            {
+                const int scomp = 1, dcomp = 1;
+                MultiFab s0(sba, sdm, scomp+ncomp, 0);
+                MultiFab s1(sba, sdm, scomp+ncomp, 0);
+                fillRandom(s0);
+                fillRandom(s1);
+
+                MultiFab mf_old(dba, ddm, dcomp+ncomp, ngrow);
+                MultiFab mf_new(dba, ddm, dcomp+ncomp, ngrow);
+                mf_old.setVal(-1.0);
+                mf_new.setVal(-1.0);
+
+                {
+                    MultiFab tmp(sba, sdm, ncomp, 0);
+                    for (MFIter mfi(tmp); mfi.isValid(); ++mfi) {
+                        tmp[mfi].linInterp(s0[mfi], scomp, s1[mfi], scomp, t0, t1, time,
+                                           mfi.validbox(), 0, ncomp);
+                    }
+                    mf_old.copy(tmp, 0, dcomp, ncomp, 0, ngrow, geom.periodicity());
+                }
+
+                FillPatchSingleLevel(mf_new, time, {&s0, &s1}, {t0, t1}, scomp, dcomp, ncomp,
+                                     geom, physbc);
+
+                const long ndiffs = numDiffs(mf_old, dcomp, mf_new, dcomp, ncomp);
+                nfails += ndiffs;
+                amrex::Print() << "FillPatchSingleLevel ncomp " << ncomp
+                               << ": checksum " << std::setprecision(17)
+                               << checksum(mf_old, dcomp, ncomp) << " old, "
+                               << checksum(mf_new, dcomp, ncomp) << " new, "
+                               << ndiffs << " values differ\n";
+            }
+        }
+
+        //
+        // FillPatchTwoLevels with the kept coarse patches.
+        //
+        {
+            const IntVect ratio(2);
+            const Box fdomain(IntVect(0), IntVect(n_cell-1));
+            const Box cdomain = amrex::coarsen(fdomain, ratio);
+            Geometry fgeom(fdomain, &rb, 0, is_per);
+            Geometry cgeom(cdomain, &rb, 0, is_per);
+
+            BoxArray cba(cdomain);
+            cba.maxSize(max_grid_size);
+            DistributionMapping cdm(cba);
+
+            // the fine level covers the middle of the domain
+            BoxArray fba(Box(IntVect(n_cell/4), IntVect(3*n_cell/4-1)));
+            fba.maxSize(max_grid_size);
+            DistributionMapping fdm(fba);
+
+            const int ncomp = 3;
+            MultiFab c0(cba, cdm, ncomp, 0);
+            MultiFab c1(cba, cdm, ncomp, 0);
+            MultiFab f0(fba, fdm, ncomp, 0);
+            MultiFab f1(fba, fdm, ncomp, 0);
+            fillRandom(c0);
+            fillRandom(c1);
+            fillRandom(f0);
+            fillRandom(f1);
+
+            Vector<BCRec> bcs(ncomp);
+            for (auto& bc : bcs) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    bc.setLo(idim, is_per[idim] ? BCType::int_dir : BCType::foextrap);
+                    bc.setHi(idim, is_per[idim] ? BCType::int_dir : BCType::foextrap);
+                }
+            }
+
+            MultiFab ref(fba, fdm, ncomp, ngrow);
+            MultiFab mf(fba, fdm, ncomp, ngrow);
+            ref.setVal(-1.0);
+
+            auto fill = [&] (MultiFab& dst, int nc) {
+                FillPatchTwoLevels(dst, time, {&c0, &c1}, {t0, t1}, {&f0, &f1}, {t0, t1},
+                                   0, 0, nc, cgeom, fgeom, physbc, physbc, ratio,
+                                   &cell_cons_interp, bcs);
+            };
+
+            fill(ref, ncomp);
+            for (int nc : {ncomp, 1, ncomp})
+            {
+                mf.setVal(-1.0);
+                fill(mf, nc);
+                const long ndiffs = numDiffs(ref, 0, mf, 0, nc);
+                nfails += ndiffs;
+                amrex::Print() << "FillPatchTwoLevels ncomp " << nc
+                               << ": checksum " << std::setprecision(17)
+                               << checksum(mf, 0, nc) << ", "
+                               << ndiffs << " values differ from the first call\n";
+            }
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("FillPatchComparison failed");
+    }
+    amrex::Print() << "FillPatchComparison passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,220 @@
+//
+// Compares the C++ kernel of CellConservativeLinear (cell_cons_interp and
+// lincc_interp) with the Fortran amrex_linccinterp it replaced in 2D and
+// 3D.  The Fortran is called here as CellConservativeLinear::interp used
+// to call it.  The coarse data are random, and every combination of
+//
+//   refinement ratio 2, 4 and 3 (the kernel without a fixed ratio),
+//   linear limiting on and off,
+//   int_dir, foextrap, ext_dir and hoextrap boundaries,
+//   Cartesian and, in 2D, RZ and spherical coordinates
+//
+// is tried on fine regions that touch the low and the high end of the
+// domain.  The results must be bitwise identical.
+//
+//     main.ex n_cell=16 ncomp=3
+//
+
+#include <iostream>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_Geometry.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_INTERP_F.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+//
+// The Fortran path of CellConservativeLinear::interp before the C++ kernel.
+//
+void
+fortran_interp (const FArrayBox& crse, int crse_comp, FArrayBox& fine, int fine_comp,
+                int ncomp, const Box& fine_region, const IntVect& ratio,
+                const Geometry& crse_geom, const Geometry& fine_geom,
+                Vector<BCRec>& bcr, bool do_linear_limiting)
+{
+    Box target_fine_region = fine_region & fine.box();
+    Box crse_bx = cell_cons_interp.CoarseBox(target_fine_region,ratio);
+    Box cslope_bx(crse_bx);
+    cslope_bx.grow(-1);
+    Box fine_version_of_cslope_bx = amrex::refine(cslope_bx,ratio);
+
+    Vector<Real> fvc[AMREX_SPACEDIM];
+    Vector<Real> cvc[AMREX_SPACEDIM];
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        fine_geom.GetEdgeVolCoord(fvc[dir],fine_version_of_cslope_bx,dir);
+        crse_geom.GetEdgeVolCoord(cvc[dir],crse_bx,dir);
+    }
+
+    FArrayBox ucc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
+    FArrayBox lcc_slopes(cslope_bx,ncomp*AMREX_SPACEDIM);
+    FArrayBox slope_factors(cslope_bx,AMREX_SPACEDIM);
+    FArrayBox cmax(cslope_bx,ncomp);
+    FArrayBox cmin(cslope_bx,ncomp);
+    FArrayBox alpha(cslope_bx,ncomp);
+
+    const int* flo    = fine.loVect();
+    const int* fhi    = fine.hiVect();
+    const int* clo    = crse.loVect();
+    const int* chi    = crse.hiVect();
+    const int* fblo   = target_fine_region.loVect();
+    const int* fbhi   = target_fine_region.hiVect();
+    const int* csbhi  = cslope_bx.hiVect();
+    const int* csblo  = cslope_bx.loVect();
+    int lin_limit     = (do_linear_limiting ? 1 : 0);
+    const int* cvcblo = crse_bx.loVect();
+    const int* fvcblo = fine_version_of_cslope_bx.loVect();
+    int slope_flag    = 1;
+
+    int cvcbhi[AMREX_SPACEDIM];
+    int fvcbhi[AMREX_SPACEDIM];
+    std::vector<Real> voff[AMREX_SPACEDIM];
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++)
+    {
+        cvcbhi[dir] = cvcblo[dir] + cvc[dir].size() - 1;
+        fvcbhi[dir] = fvcblo[dir] + fvc[dir].size() - 1;
+        voff[dir].resize(fvc[dir].size());
+    }
+
+    Vector<int> bc    = Interpolater::GetBCArray(bcr);
+    const int* ratioV = ratio.getVect();
+    int actual_comp = 0, actual_state = 0;
+
+    amrex_linccinterp (fine.dataPtr(fine_comp),AMREX_ARLIM(flo),AMREX_ARLIM(fhi),
+                       fblo, fbhi,
+                       AMREX_ARLIM(fvcblo), AMREX_ARLIM(fvcbhi),
+                       crse.dataPtr(crse_comp),AMREX_ARLIM(clo),AMREX_ARLIM(chi),
+                       AMREX_ARLIM(cvcblo), AMREX_ARLIM(cvcbhi),
+                       ucc_slopes.dataPtr(0), lcc_slopes.dataPtr(0), slope_factors.dataPtr(0),
+                       ucc_slopes.dataPtr(ncomp), lcc_slopes.dataPtr(ncomp), slope_factors.dataPtr(1),
+#if (AMREX_SPACEDIM==3)
+                       ucc_slopes.dataPtr(2*ncomp), lcc_slopes.dataPtr(2*ncomp), slope_factors.dataPtr(2),
+#endif
+                       AMREX_ARLIM(csblo), AMREX_ARLIM(csbhi),
+                       csblo, csbhi,
+                       &ncomp,AMREX_D_DECL(&ratioV[0],&ratioV[1],&ratioV[2]),
+                       bc.dataPtr(), &slope_flag, &lin_limit,
+                       AMREX_D_DECL(fvc[0].dataPtr(),fvc[1].dataPtr(),fvc[2].dataPtr()),
+                       AMREX_D_DECL(cvc[0].dataPtr(),cvc[1].dataPtr(),cvc[2].dataPtr()),
+                       AMREX_D_DECL(voff[0].data(),voff[1].data(),voff[2].data()),
+                       alpha.dataPtr(),cmax.dataPtr(),cmin.dataPtr(),
+                       &actual_comp,&actual_state);
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    long nfails = 0;
+    long ncases = 0;
+    {
+        int n_cell = 16;
+        int ncomp = 3;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("ncomp", ncomp);
+        }
+
+        amrex::InitRandom(4321);
+
+        const Box cdomain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.5,0.,0.)}, {AMREX_D_DECL(1.5,1.,1.)});
+
+#if (AMREX_SPACEDIM == 2)
+        const std::vector<int> coords {0, 1, 2};
+#else
+        const std::vector<int> coords {0};
+#endif
+        const std::vector<int> bctypes {BCType::int_dir, BCType::foextrap,
+                                        BCType::ext_dir, BCType::hoextrap};
+
+        for (int r : {2, 4, 3})
+        {
+            const IntVect ratio(r);
+            const Box fdomain = amrex::refine(cdomain, ratio);
+
+            // touching the low end, touching the high end, inside
+            const std::vector<Box> fine_regions {
+                Box(IntVect(0), IntVect(n_cell*r/2 + 1)),
+                Box(IntVect(n_cell*r/2 - 3), fdomain.bigEnd()),
+                Box(IntVect(r+1), IntVect(n_cell*r - 2*r + 2))
+            };
+
+            for (int coord : coords)
+            {
+                Geometry cgeom(cdomain, &rb, coord);
+                Geometry fgeom(fdomain, &rb, coord);
+
+                for (int bctype : bctypes)
+                {
+                    Vector<BCRec> bcr(ncomp);
+                    for (auto& bc : bcr) {
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            bc.setLo(idim, bctype);
+                            bc.setHi(idim, bctype);
+                        }
+                    }
+
+                    for (const Box& fine_region : fine_regions)
+                    {
+                        const Box crse_bx = cell_cons_interp.CoarseBox(fine_region, ratio);
+                        FArrayBox crse(crse_bx, ncomp);
+                        Real* p = crse.dataPtr();
+                        for (long i = 0, n = crse_bx.numPts()*ncomp; i < n; ++i) {
+                            p[i] = amrex::Random();
+                        }
+
+                        for (int limit : {1, 0})
+                        {
+                            CellConservativeLinear mapper(limit);
+
+                            FArrayBox fine_cpp(fine_region, ncomp);
+                            FArrayBox fine_f90(fine_region, ncomp);
+                            fine_cpp.setVal(-1.0);
+                            fine_f90.setVal(-1.0);
+
+                            mapper.interp(crse, 0, fine_cpp, 0, ncomp, fine_region, ratio,
+                                          cgeom, fgeom, bcr, 0, 0);
+                            fortran_interp(crse, 0, fine_f90, 0, ncomp, fine_region, ratio,
+                                           cgeom, fgeom, bcr, limit);
+
+                            long ndiffs = 0;
+                            const Real* a = fine_cpp.dataPtr();
+                            const Real* b = fine_f90.dataPtr();
+                            for (long i = 0, n = fine_region.numPts()*ncomp; i < n; ++i) {
+                                if (a[i] != b[i]) ++ndiffs;
+                            }
+
+                            ++ncases;
+                            if (ndiffs > 0) {
+                                ++nfails;
+                                amrex::Print() << "ratio " << r << " coord " << coord
+                                               << " bc " << bctype << " limit " << limit
+                                               << " region " << fine_region << ": "
+                                               << ndiffs << " values differ\n";
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    amrex::Print() << ncases - nfails << " of " << ncases << " cases bitwise identical\n";
+    if (nfails > 0) {
+        amrex::Abort("InterpComparison failed");
+    }
+
+    amrex::Finalize();
+}
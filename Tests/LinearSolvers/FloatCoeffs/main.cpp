@@ -0,0 +1,130 @@
+//
+// Compares the MLMG solve of MLABecLaplacian with single-precision
+// coefficients on the coarser MG levels (see LPInfo::setFloatCoeffs)
+// with the solve with double-precision coefficients.  With random
+// coefficients and rhs and Dirichlet boundaries, both solves must
+// converge to tol_rel, and their solutions must agree within tol relative
+// to the solution.  They must not be identical, else the single-precision
+// levels were not used.
+//
+//     main.ex n_cell=64 max_grid_size=32 tol_rel=1.e-10 tol=1.e-8
+//
+
+#include <iomanip>
+#include <iostream>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+using namespace amrex;
+
+namespace {
+
+void
+fillRandom (MultiFab& mf, Real lo, Real hi)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        Real* p = fab.dataPtr();
+        for (long i = 0, n = fab.box().numPts()*fab.nComp(); i < n; ++i) {
+            p[i] = lo + (hi-lo)*amrex::Random();
+        }
+    }
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 64;
+        int max_grid_size = 32;
+        Real tol_rel = 1.e-10;
+        Real tol = 1.e-8;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("tol_rel", tol_rel);
+            pp.query("tol", tol);
+        }
+
+        amrex::InitRandom(86420);
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.1,0.9,1.3)});
+        int is_per[] = {AMREX_D_DECL(0,0,0)};
+        Geometry geom(domain, &rb, 0, is_per);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab alpha(ba, dm, 1, 0);
+        MultiFab beta(ba, dm, 1, 1);
+        MultiFab rhs(ba, dm, 1, 0);
+        fillRandom(alpha, 1.0, 2.0);
+        fillRandom(beta, 1.0, 10.0);
+        fillRandom(rhs, -1.0, 1.0);
+        beta.FillBoundary(geom.periodicity());
+
+        std::array<MultiFab,AMREX_SPACEDIM> bcoefs;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            const BoxArray& fba = amrex::convert(ba, IntVect::TheDimensionVector(idim));
+            bcoefs[idim].define(fba, dm, 1, 0);
+        }
+        amrex::average_cellcenter_to_face(amrex::GetArrOfPtrs(bcoefs), beta, geom);
+
+        auto solve = [&] (bool float_coeffs, MultiFab& sol) -> Real
+        {
+            LPInfo info;
+            info.setFloatCoeffs(float_coeffs);
+            MLABecLaplacian op({geom}, {ba}, {dm}, info);
+
+            const auto dir = LinOpBCType::Dirichlet;
+            op.setDomainBC({AMREX_D_DECL(dir,dir,dir)}, {AMREX_D_DECL(dir,dir,dir)});
+            sol.setVal(0.0);
+            op.setLevelBC(0, &sol);
+            op.setScalars(1.e-2, 1.0);
+            op.setACoeffs(0, alpha);
+            op.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoefs));
+
+            MLMG mlmg(op);
+            mlmg.setMaxIter(100);
+            return mlmg.solve({&sol}, {&rhs}, tol_rel, 0.0);
+        };
+
+        MultiFab sold(ba, dm, 1, 1);
+        MultiFab solf(ba, dm, 1, 1);
+        const Real resd = solve(false, sold);
+        const Real resf = solve(true, solf);
+
+        const Real rhsnorm = rhs.norm0();
+        amrex::Print() << "final residual: double " << std::setprecision(3) << resd
+                       << ", float coefficients " << resf << ", rhs " << rhsnorm << "\n";
+        if (!(resd <= tol_rel*rhsnorm) || !(resf <= tol_rel*rhsnorm)) ++nfails;
+
+        const Real scale = sold.norm0();
+        MultiFab::Subtract(solf, sold, 0, 0, 1, 0);
+        const Real err = solf.norm0() / scale;
+        amrex::Print() << "relative difference of the solutions: " << err << "\n";
+        if (!(err <= tol) || err == 0.0) ++nfails;
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("FloatCoeffs failed");
+    }
+    amrex::Print() << "FloatCoeffs passed\n";
+
+    amrex::Finalize();
+}
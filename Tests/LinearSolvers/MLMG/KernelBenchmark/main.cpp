@@ -0,0 +1,172 @@
+//
+// Microbenchmark for the MLABecLaplacian apply and red/black Gauss-Seidel
+// kernels.  Each kernel is timed with the Fortran and the C++
+// implementation and the achieved memory bandwidth is reported.  The
+// bandwidth is based on the compulsory traffic of one pass: for apply,
+// x, a and b are read and y is written; for one color of GSRB, phi,
+// rhs, a and b are read and phi is written.
+//
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+// Exposes the kernels of MLABecLaplacian.
+class BenchABecLap
+    : public MLABecLaplacian
+{
+public:
+    using MLABecLaplacian::MLABecLaplacian;
+    using MLABecLaplacian::prepareForSolve;
+    using MLABecLaplacian::Fapply;
+    using MLABecLaplacian::Fsmooth;
+};
+
+int n_cell        = 128;
+int max_grid_size = 64;
+int ntrials       = 20;
+Real a            = 1.e-3;
+Real b            = 1.0;
+
+const char* kernelName (MLABecLaplacian::Kernel k)
+{
+    return (k == MLABecLaplacian::Kernel::Fortran) ? "Fortran" : "C++";
+}
+
+void report (const std::string& name, MLABecLaplacian::Kernel k, Real t, Real bytes)
+{
+    amrex::Print() << "  " << name << " (" << kernelName(k) << "): "
+                   << t/ntrials << " s/call, "
+                   << bytes*ntrials/t*1.e-9 << " GB/s\n";
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("ntrials", ntrials);
+        pp.query("a", a);
+        pp.query("b", b);
+
+        const Box domain(IntVect::TheZeroVector(), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry geom(domain, &rb, 0);
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        MultiFab phi(ba, dm, 1, 1);
+        MultiFab rhs(ba, dm, 1, 0);
+        MultiFab out(ba, dm, 1, 0);
+        MultiFab alpha(ba, dm, 1, 0);
+        Array<MultiFab,AMREX_SPACEDIM> beta;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            beta[idim].define(amrex::convert(ba, IntVect::TheDimensionVector(idim)), dm, 1, 0);
+        }
+
+        MultiFab phi0(ba, dm, 1, 1);
+        for (MFIter mfi(phi0); mfi.isValid(); ++mfi) {
+            FArrayBox& fab = phi0[mfi];
+            fab.ForEach(fab.box(), 0, 1, [] (Real& x) { x = amrex::Random(); });
+        }
+        for (MFIter mfi(rhs); mfi.isValid(); ++mfi) {
+            FArrayBox& fab = rhs[mfi];
+            fab.ForEach(fab.box(), 0, 1, [] (Real& x) { x = amrex::Random() - 0.5; });
+        }
+        alpha.setVal(1.0);
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            for (MFIter mfi(beta[idim]); mfi.isValid(); ++mfi) {
+                FArrayBox& fab = beta[idim][mfi];
+                fab.ForEach(fab.box(), 0, 1, [] (Real& x) { x = 1.0 + amrex::Random(); });
+            }
+        }
+
+        BenchABecLap mlabec({geom}, {ba}, {dm});
+        mlabec.setMaxOrder(2);
+        mlabec.setDomainBC({AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)},
+                           {AMREX_D_DECL(LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet,
+                                         LinOpBCType::Dirichlet)});
+        phi.setVal(0.0);
+        mlabec.setLevelBC(0, &phi);
+        mlabec.setScalars(a, b);
+        mlabec.setACoeffs(0, alpha);
+        mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(beta));
+        mlabec.prepareForSolve();
+
+        const Real npts = ba.numPts();
+        const Real apply_bytes  = (3 + AMREX_SPACEDIM) * sizeof(Real) * npts;
+        const Real smooth_bytes = (4 + AMREX_SPACEDIM) * sizeof(Real) * npts;
+
+        amrex::Print() << "MLABecLaplacian kernels: n_cell = " << n_cell
+                       << ", max_grid_size = " << max_grid_size
+                       << ", ntrials = " << ntrials << "\n";
+
+        const Vector<MLABecLaplacian::Kernel> kernels {MLABecLaplacian::Kernel::Fortran,
+                                                       MLABecLaplacian::Kernel::Cpp};
+        Vector<MultiFab> apply_result(kernels.size());
+        Vector<MultiFab> smooth_result(kernels.size());
+
+        for (int ik = 0; ik < kernels.size(); ++ik)
+        {
+            const auto k = kernels[ik];
+            mlabec.setKernel(k);
+
+            MultiFab::Copy(phi, phi0, 0, 0, 1, 1);
+
+            mlabec.Fapply(0, 0, out, phi);  // warm up
+            ParallelDescriptor::Barrier();
+            Real t = amrex::second();
+            for (int i = 0; i < ntrials; ++i) {
+                mlabec.Fapply(0, 0, out, phi);
+            }
+            t = amrex::second() - t;
+            ParallelDescriptor::ReduceRealMax(t);
+            report("apply ", k, t, apply_bytes);
+
+            apply_result[ik].define(ba, dm, 1, 0);
+            MultiFab::Copy(apply_result[ik], out, 0, 0, 1, 0);
+
+            // Ghost cells are left alone so that every implementation
+            // sees the same data.
+            ParallelDescriptor::Barrier();
+            t = amrex::second();
+            for (int i = 0; i < ntrials; ++i) {
+                mlabec.Fsmooth(0, 0, phi, rhs, i%2);
+            }
+            t = amrex::second() - t;
+            ParallelDescriptor::ReduceRealMax(t);
+            report("gsrb  ", k, t, smooth_bytes);
+
+            smooth_result[ik].define(ba, dm, 1, 0);
+            MultiFab::Copy(smooth_result[ik], phi, 0, 0, 1, 0);
+        }
+
+        for (int ik = 1; ik < kernels.size(); ++ik)
+        {
+            MultiFab::Subtract(apply_result[ik], apply_result[0], 0, 0, 1, 0);
+            MultiFab::Subtract(smooth_result[ik], smooth_result[0], 0, 0, 1, 0);
+            amrex::Print() << "  max difference from Fortran (" << kernelName(kernels[ik]) << "): "
+                           << "apply " << apply_result[ik].norm0()
+                           << ", gsrb " << smooth_result[ik].norm0() << "\n";
+        }
+    }
+
+    amrex::Finalize();
+}
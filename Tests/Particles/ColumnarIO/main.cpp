@@ -0,0 +1,252 @@
+//
+// Writes a ParticleContainer with particles.columnar_output = 1, restarts
+// from it and reads it with ParticleColumnReader.  The restarted particles
+// and every component read with the reader, ints included, must be
+// identical to those written, grid by grid.  The reader's particle counts,
+// bounding boxes, component names and gridsIntersecting are checked too,
+// and the real components of a columnar plotfile must be those of the
+// checkpoint.  A restart from the row-oriented layout is checked for
+// comparison.
+//
+//     main.ex n_cell=32 max_grid_size=16 nparticles=5000 dir=ColumnarIO_plt
+//
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+#include <AMReX_Particles.H>
+#include <AMReX_ParticleColumnReader.H>
+
+using namespace amrex;
+
+namespace {
+
+using PC = ParticleContainer<2, 1, 1, 1>;
+
+//! All the components of a particle, positions and reals first, as the
+//! reader returns them.
+using Values = std::vector<Real>;
+
+//! A particle is identified by its id and cpu.
+using Key = std::pair<int, int>;
+
+//! The particles of this rank, by grid and key.
+std::map<int, std::map<Key, Values> >
+collect (const PC& pc)
+{
+    std::map<int, std::map<Key, Values> > r;
+    for (const auto& kv : pc.GetParticles(0))
+    {
+        const auto& aos = kv.second.GetArrayOfStructs();
+        const auto& soa = kv.second.GetStructOfArrays();
+        for (std::size_t i = 0; i < aos.size(); ++i)
+        {
+            const auto& p = aos[i];
+            if (p.m_idata.id <= 0) continue;
+            Values v;
+            for (int n = 0; n < AMREX_SPACEDIM + 2; ++n) v.push_back(Real(p.m_rdata.arr[n]));
+            v.push_back(Real(soa.GetRealData(0)[i]));
+            v.push_back(p.m_idata.cpu);
+            v.push_back(p.m_idata.arr[2]);
+            v.push_back(soa.GetIntData(0)[i]);
+            r[kv.first.first][Key(p.m_idata.id, p.m_idata.cpu)] = v;
+        }
+    }
+    return r;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        long nparticles = 5000;
+        std::string dir = "ColumnarIO_plt";
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nparticles", nparticles);
+            pp.query("dir", dir);
+        }
+
+        auto check = [&] (bool ok, const std::string& what) {
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+            if (!ok) ++nfails;
+        };
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_per[] = {AMREX_D_DECL(1,1,1)};
+        Geometry geom(domain, &rb, 0, is_per);
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        PC pc(geom, dm, ba);
+        PC::ParticleInitData pdata = {{1.0, 2.0}, {3}, {4.0}, {5}};
+        pc.InitRandom(nparticles, 4321, pdata, false);
+
+        // values that differ from particle to particle
+        for (auto& kv : pc.GetParticles(0))
+        {
+            auto& aos = kv.second.GetArrayOfStructs();
+            auto& soa = kv.second.GetStructOfArrays();
+            for (std::size_t i = 0; i < aos.size(); ++i)
+            {
+                auto& p = aos[i];
+                p.m_rdata.arr[AMREX_SPACEDIM]   = 0.25*p.m_idata.id;
+                p.m_rdata.arr[AMREX_SPACEDIM+1] = p.m_rdata.pos[0] + p.m_idata.id;
+                p.m_idata.arr[2] = p.m_idata.id % 7 - 3;
+                soa.GetRealData(0)[i] = -1.5*p.m_idata.id;
+                soa.GetIntData(0)[i] = 2*p.m_idata.id + 1;
+            }
+        }
+        const auto orig = collect(pc);
+
+        if (ParallelDescriptor::IOProcessor()) {
+            amrex::UtilCreateDirectory(dir, 0755);
+        }
+        ParallelDescriptor::Barrier();
+
+        const Vector<std::string> real_names = {"ra", "rb", "rc"};
+        const Vector<std::string> int_names  = {"ia", "ib"};
+
+        ParmParse pp("particles");
+        for (int columnar : {0, 1})
+        {
+            pp.add("columnar_output", columnar);
+            const std::string name = columnar ? "col" : "row";
+            pc.Checkpoint(dir, name, true, real_names, int_names);
+            ParallelDescriptor::Barrier();
+
+            PC pc2(geom, dm, ba);
+            pc2.Restart(dir, name, true);
+            check(collect(pc2) == orig, name + ": Restart");
+        }
+        pc.WritePlotFile(dir, "colplt", real_names, int_names);
+        pp.add("columnar_output", 0);
+        ParallelDescriptor::Barrier();
+
+        ParticleColumnReader reader(dir, "col");
+        ParticleColumnReader plt(dir, "colplt");
+
+        check(reader.isCheckpoint() && !plt.isCheckpoint(), "isCheckpoint");
+        check(reader.totalParticles() == pc.TotalNumberOfParticles()
+              && reader.finestLevel() == 0 && reader.numGrids(0) == ba.size(),
+              "totalParticles, finestLevel and numGrids");
+
+        const int ix = reader.realCompIndex("position_x");
+        const int irb = reader.realCompIndex("rb");
+        const int iid = reader.intCompIndex("id");
+        const int iib = reader.intCompIndex("ib");
+        check(ix == 0 && irb == AMREX_SPACEDIM+1 && iid == 0 && iib == 3
+              && reader.realCompIndex("rd") == -1 && plt.intCompIndex("id") == -1
+              && reader.realCompNames().size() == AMREX_SPACEDIM+3
+              && reader.intCompNames().size() == 4 && plt.intCompNames().empty(),
+              "component names");
+
+        // the grids of this rank, one component at a time
+        const int nreal = reader.realCompNames().size();
+        const int nint  = reader.intCompNames().size();
+        bool counts = true, comps = true, bbox = true, pltcomps = true;
+        for (int grid = 0; grid < ba.size(); ++grid)
+        {
+            if (dm[grid] != ParallelDescriptor::MyProc()) continue;
+            const auto it = orig.find(grid);
+            const std::map<Key, Values> none;
+            const std::map<Key, Values>& ps = (it == orig.end()) ? none : it->second;
+
+            counts = counts && reader.numParticles(0, grid) == static_cast<int>(ps.size());
+
+            Vector<int> ids, cpus;
+            reader.readIntComp(0, grid, iid, ids);
+            reader.readIntComp(0, grid, iid+1, cpus);
+            Vector<Key> keys;
+            std::map<Key, Values> got;
+            for (int i = 0; i < ids.size(); ++i) {
+                keys.push_back(Key(ids[i], cpus[i]));
+                got[keys[i]] = Values(nreal+nint-1);
+            }
+            comps = comps && got.size() == ps.size();
+
+            for (int n = 0; n < nreal; ++n)
+            {
+                Vector<Real> data, pltdata;
+                reader.readRealComp(0, grid, n, data);
+                plt.readRealComp(0, grid, n, pltdata);
+                pltcomps = pltcomps && pltdata == data;
+                for (int i = 0; i < ids.size(); ++i) got[keys[i]][n] = data[i];
+            }
+            // cpu and the int components, id and cpu are the key
+            for (int n = 1; n < nint; ++n)
+            {
+                Vector<int> data;
+                reader.readIntComp(0, grid, n, data);
+                for (int i = 0; i < ids.size(); ++i) got[keys[i]][nreal+n-1] = data[i];
+            }
+            comps = comps && got == ps;
+
+            const RealBox bb = reader.boundingBox(0, grid);
+            for (const auto& kv : ps) {
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    bbox = bbox && kv.second[idim] >= bb.lo(idim) && kv.second[idim] <= bb.hi(idim);
+                }
+            }
+            for (int idim = 0; idim < AMREX_SPACEDIM && !ps.empty(); ++idim) {
+                bool lo = false, hi = false;
+                for (const auto& kv : ps) {
+                    lo = lo || kv.second[idim] == bb.lo(idim);
+                    hi = hi || kv.second[idim] == bb.hi(idim);
+                }
+                bbox = bbox && lo && hi;
+            }
+        }
+        check(counts, "numParticles");
+        check(comps, "readRealComp and readIntComp");
+        check(pltcomps, "plotfile readRealComp");
+        check(bbox, "boundingBox");
+
+        // a grid with a particle in the box must be found
+        {
+            const RealBox sub({AMREX_D_DECL(0.1,0.2,0.3)}, {AMREX_D_DECL(0.4,0.35,0.6)});
+            const Vector<int> found = reader.gridsIntersecting(0, sub);
+            bool ok = true;
+            for (const auto& g : orig) {
+                bool inside = false;
+                for (const auto& kv : g.second) {
+                    inside = inside || sub.contains(kv.second.data());
+                }
+                if (inside) {
+                    ok = ok && std::find(found.begin(), found.end(), g.first) != found.end();
+                }
+            }
+            for (int grid : found) {
+                ok = ok && reader.numParticles(0, grid) > 0
+                        && reader.boundingBox(0, grid).intersects(sub);
+            }
+            check(ok && !found.empty() && found.size() < ba.size(), "gridsIntersecting");
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("ColumnarIO failed");
+    }
+    amrex::Print() << "ColumnarIO passed\n";
+
+    amrex::Finalize();
+}
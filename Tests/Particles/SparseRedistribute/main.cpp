@@ -0,0 +1,159 @@
+//
+// Compares the global particle Redistribute with the sparse exchange
+// (particles.use_sparse_exchange, MPI-3 only) with the exchange of send
+// counts with all processes.  Two identical containers are moved the same
+// way and redistributed, one with each exchange, over several steps that
+// move particles up to a third of the periodic domain.  A last step moves
+// them less than a cell and redistributes with local = 1 against the
+// global exchange.  After every step the total and per-grid particle
+// counts and the particles of every tile, in order, must be identical.
+//
+//     mpiexec -n 4 main.ex n_cell=32 max_grid_size=8 nparticles=20000 nsteps=4
+//
+
+#include <iostream>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Particles.H>
+#include <AMReX_Philox.H>
+
+using namespace amrex;
+
+namespace {
+
+using PC = ParticleContainer<1, 1, 1, 1>;
+
+//! Moves every particle by a displacement that depends on its id, cpu and
+//! the step.  Redistribute shifts the particles that leave the domain.
+void
+moveParticles (PC& pc, int step, Real maxdist)
+{
+    for (auto& kv : pc.GetParticles(0))
+    {
+        auto& aos = kv.second.GetArrayOfStructs();
+        auto& soa = kv.second.GetStructOfArrays();
+        for (std::size_t i = 0; i < aos.size(); ++i)
+        {
+            auto& p = aos[i];
+            const unsigned long key = (static_cast<unsigned long>(p.m_idata.cpu) << 32) + p.m_idata.id;
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim)
+            {
+                const Real r = Philox::uniform(step, key, idim);
+                p.m_rdata.pos[idim] += maxdist * (2.0*r - 1.0);
+            }
+            p.m_rdata.arr[AMREX_SPACEDIM] += 1.0;
+            p.m_idata.arr[2] = step;
+            soa.GetRealData(0)[i] = p.m_rdata.pos[0] * step;
+            soa.GetIntData(0)[i] = p.m_idata.id + step;
+        }
+    }
+}
+
+//! The particles of every tile of this rank in order, and the counts.
+bool
+same (const PC& a, const PC& b)
+{
+    if (a.TotalNumberOfParticles() != b.TotalNumberOfParticles()) return false;
+    if (a.NumberOfParticlesInGrid(0) != b.NumberOfParticlesInGrid(0)) return false;
+
+    bool ok = a.GetParticles(0).size() == b.GetParticles(0).size();
+    for (const auto& kv : a.GetParticles(0))
+    {
+        const auto it = b.GetParticles(0).find(kv.first);
+        if (!ok || it == b.GetParticles(0).end()) return false;
+        const auto& aa = kv.second.GetArrayOfStructs();
+        const auto& ab = it->second.GetArrayOfStructs();
+        const auto& sa = kv.second.GetStructOfArrays();
+        const auto& sb = it->second.GetStructOfArrays();
+        ok = aa.size() == ab.size();
+        for (std::size_t i = 0; ok && i < aa.size(); ++i)
+        {
+            for (int n = 0; n < AMREX_SPACEDIM+1; ++n) {
+                ok = ok && aa[i].m_rdata.arr[n] == ab[i].m_rdata.arr[n];
+            }
+            for (int n = 0; n < 3; ++n) {
+                ok = ok && aa[i].m_idata.arr[n] == ab[i].m_idata.arr[n];
+            }
+            ok = ok && sa.GetRealData(0)[i] == sb.GetRealData(0)[i]
+                    && sa.GetIntData(0)[i] == sb.GetIntData(0)[i];
+        }
+    }
+    return ok;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 32;
+        int max_grid_size = 8;
+        long nparticles = 20000;
+        int nsteps = 4;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nparticles", nparticles);
+            pp.query("nsteps", nsteps);
+        }
+
+#if !defined(BL_USE_MPI) || MPI_VERSION < 3
+        amrex::Print() << "There is no sparse exchange in this build, both use the same path\n";
+#endif
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_per[] = {AMREX_D_DECL(1,1,1)};
+        Geometry geom(domain, &rb, 0, is_per);
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        PC::ParticleInitData pdata = {{0.0}, {0}, {0.0}, {0}};
+        PC pc_sparse(geom, dm, ba);
+        PC pc_all(geom, dm, ba);
+        pc_sparse.InitRandom(nparticles, 2468, pdata, false);
+        // the same particles, ids included
+        pc_all.GetParticles() = pc_sparse.GetParticles();
+
+        const bool old_sparse = PC::use_sparse_exchange;
+
+        auto step = [&] (int istep, Real maxdist, int local) {
+            moveParticles(pc_sparse, istep, maxdist);
+            moveParticles(pc_all, istep, maxdist);
+
+            PC::use_sparse_exchange = true;
+            pc_sparse.Redistribute(0, -1, 0, local);
+            PC::use_sparse_exchange = false;
+            pc_all.Redistribute();
+
+            bool ok = same(pc_sparse, pc_all);
+            ParallelDescriptor::ReduceBoolAnd(ok);
+            amrex::Print() << "step " << istep << (local ? ", local" : "") << ": "
+                           << pc_sparse.TotalNumberOfParticles() << " particles, "
+                           << (ok ? "identical\n" : "DIFFERENT\n");
+            if (!ok) ++nfails;
+        };
+
+        for (int istep = 1; istep <= nsteps; ++istep) {
+            step(istep, 1.0/3.0, 0);
+        }
+        step(nsteps+1, 0.5*geom.CellSize(0), 1);
+
+        PC::use_sparse_exchange = old_sparse;
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("SparseRedistribute failed");
+    }
+    amrex::Print() << "SparseRedistribute passed\n";
+
+    amrex::Finalize();
+}
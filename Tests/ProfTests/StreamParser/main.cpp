@@ -0,0 +1,153 @@
+//
+// Runs BLProfStreamParser on bl_prof_sample and checks its outputs.  The
+// sample was written by a run on three processes with PROFILE, TRACE_PROFILE
+// and COMM_PROFILE, in which each process calls SampleWork() three times in
+// the region SampleRegionA, then SampleExchange() twice and SampleWork() once
+// in SampleRegionB.  SampleExchange() sends 100 doubles to the next process.
+// The call counts, the regions and the send pattern must be those of the
+// run, the times are not checked.
+//
+// This must not be run in bl_prof_sample, the profiler of this program
+// writes bl_prof.
+//
+//     main.ex dir=bl_prof_sample
+//
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_BLProfStreamParser.H>
+
+using namespace amrex;
+
+namespace {
+
+//! The lines of a table split into words.
+std::vector<std::vector<std::string> >
+words (const std::string& table)
+{
+    std::vector<std::vector<std::string> > r;
+    std::istringstream is(table);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        std::istringstream ls(line);
+        std::vector<std::string> w;
+        std::string s;
+        while (ls >> s) w.push_back(s);
+        r.push_back(w);
+    }
+    return r;
+}
+
+//! The NCalls of fname in every table row of fname, in order.
+std::vector<long>
+nCalls (const std::string& table, const std::string& fname)
+{
+    std::vector<long> r;
+    for (const auto& w : words(table)) {
+        if (w.size() > 1 && w[0] == fname) r.push_back(std::stol(w[1]));
+    }
+    return r;
+}
+
+//! The rows of a table that start with the given words.
+int
+nRows (const std::string& table, const std::vector<std::string>& first)
+{
+    int n = 0;
+    for (const auto& w : words(table)) {
+        if (w.size() >= first.size() && std::equal(first.begin(), first.end(), w.begin())) ++n;
+    }
+    return n;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        std::string dir = "bl_prof_sample";
+        {
+            ParmParse pp;
+            pp.query("dir", dir);
+        }
+
+        auto check = [&] (bool ok, const std::string& what) {
+            amrex::Print() << what << (ok ? ": ok\n" : ": FAILED\n");
+            if (!ok) ++nfails;
+        };
+
+        BLProfStreamParser sp(dir);
+
+        check(sp.GetNProcs() == 3, "GetNProcs");
+        check(sp.ProfDataAvailable() && sp.TraceDataAvailable() && sp.CommDataAvailable(),
+              "data available");
+
+        // the table over all processes and the table sorted by time
+        {
+            std::ostringstream os;
+            sp.WriteSummary(os, true, 0);
+            const std::vector<long> two(2, 2), four(2, 4);
+            check(nCalls(os.str(), "SampleWork()") == four
+                  && nCalls(os.str(), "SampleExchange()") == two,
+                  "WriteSummary");
+        }
+
+        for (int proc = 0; proc < sp.GetNProcs(); ++proc)
+        {
+            std::ostringstream os;
+            sp.WriteTraceSummary(os, proc);
+            const std::vector<long> work = nCalls(os.str(), "SampleWork()");
+            const std::vector<long> exch = nCalls(os.str(), "SampleExchange()");
+            check(!work.empty() && work[0] == 4 && !exch.empty() && exch[0] == 2
+                  && nRows(os.str(), {"Inclusive", "times"}) == 1,
+                  "WriteTraceSummary, proc " + std::to_string(proc));
+        }
+
+        // each region once on each process, A before B
+        {
+            std::ostringstream os;
+            sp.WriteRegionTimeline(os, 1);
+            bool ok = nRows(os.str(), {"SampleRegionA", "3", "1"}) == 1
+                   && nRows(os.str(), {"SampleRegionB", "3", "1"}) == 1;
+            const auto w = words(os.str());
+            double stopA = -1.0, startB = -1.0;
+            for (std::size_t i = 0; i+1 < w.size(); ++i) {
+                if (w[i].size() == 1 && w[i+1].size() == 2) {
+                    if (w[i][0] == "SampleRegionA") stopA = std::stod(w[i+1][1]);
+                    if (w[i][0] == "SampleRegionB") startB = std::stod(w[i+1][0]);
+                }
+            }
+            check(ok && stopA > 0.0 && startB >= stopA, "WriteRegionTimeline");
+        }
+
+        // two sends of 800 bytes to the next process
+        {
+            std::ostringstream os;
+            sp.WriteSendPattern(os);
+            check(nRows(os.str(), {"0", "1", "2", "1600"}) == 1
+                  && nRows(os.str(), {"1", "2", "2", "1600"}) == 1
+                  && nRows(os.str(), {"2", "0", "2", "1600"}) == 1
+                  && nRows(os.str(), {"Total", "sends", "=", "6"}) == 1
+                  && nRows(os.str(), {"Total", "sent", "data", "=", "4800"}) == 1,
+                  "WriteSendPattern");
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("StreamParser failed");
+    }
+    amrex::Print() << "StreamParser passed\n";
+
+    amrex::Finalize();
+}
@@ -0,0 +1,339 @@
+//
+// Roofline benchmark for the FAB and MultiFab kernels.
+//
+// The kernels are timed for every combination of box size, number of
+// components, tile size and number of threads.  The achieved bandwidth
+// and flop rate are computed from a model of the compulsory traffic and
+// of the floating point operations per cell; the roof is the bandwidth of
+// the STREAM triad and the flop rate of a multiply-add loop in registers,
+// both measured with the same threads.  The fraction of the roof is the
+// time the roofline model allows divided by the measured time.
+//
+// Every measurement is also written as a line of the csv results file,
+// so that runs can be compared with each other.  n_cell should be large
+// enough that the MultiFabs do not fit in the caches, otherwise the
+// kernels exceed the STREAM bandwidth.
+//
+
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_MultiFabExpr.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_BCRec.H>
+#include <AMReX_Utility.H>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+namespace {
+
+int n_cell = 128;
+Real min_time = 0.2;
+long stream_size = 1L << 24;
+
+struct Kernel
+{
+    std::string name;
+    Real bytes;   // per cell and component
+    Real flops;   // per cell and component
+    std::function<void()> run;
+};
+
+struct Roof
+{
+    Real bw;      // bytes/s
+    Real flops;   // flops/s
+};
+
+//! Seconds per call, with the number of calls doubled until it takes min_time.
+Real timeIt (const std::function<void()>& f)
+{
+    f();  // warm up
+    for (long nrep = 1; ; nrep *= 2)
+    {
+        ParallelDescriptor::Barrier();
+        Real t = amrex::second();
+        for (long i = 0; i < nrep; ++i) {
+            f();
+        }
+        t = amrex::second() - t;
+        ParallelDescriptor::ReduceRealMax(t);
+        if (t >= min_time) return t/nrep;
+    }
+}
+
+int numThreads ()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+//! STREAM triad bandwidth and the multiply-add peak, summed over the processes.
+Roof measureRoof ()
+{
+    Roof roof;
+
+    Vector<Real> a(stream_size), b(stream_size), c(stream_size);
+    const long n = stream_size;
+    const Real s = 3.0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (long i = 0; i < n; ++i) {   // first touch by the threads that use them
+        a[i] = 1.0; b[i] = 2.0; c[i] = 0.0;
+    }
+    Real* AMREX_RESTRICT pa = a.data();
+    const Real* AMREX_RESTRICT pb = b.data();
+    const Real* AMREX_RESTRICT pc = c.data();
+    Real t = timeIt([=] () {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (long i = 0; i < n; ++i) {
+            pa[i] = pb[i] + s*pc[i];
+        }
+    });
+    roof.bw = 3.0*sizeof(Real)*n/t;
+
+    // Independent chains so that the multiply-adds pipeline.  The peak is
+    // that of the loop as compiled, i.e., with the flags of the kernels.
+    constexpr int nchains = 32;
+    const long niters = 1L << 20;
+    Real sum = 0.0;
+    t = timeIt([&] () {
+        Real tot = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:tot)
+#endif
+        {
+            Real x[nchains];
+            for (int j = 0; j < nchains; ++j) x[j] = 1.0 + 1.e-3*j;
+            const Real m = 0.999999, p = 1.e-6;
+            for (long it = 0; it < niters; ++it) {
+                for (int j = 0; j < nchains; ++j) {
+                    x[j] = x[j]*m + p;
+                }
+            }
+            for (int j = 0; j < nchains; ++j) tot += x[j];
+        }
+        sum += tot;
+    });
+    roof.flops = 2.0*nchains*niters*numThreads()/t;
+    if (sum < 0.0) amrex::Print() << sum;  // keeps the loop
+
+    ParallelDescriptor::ReduceRealSum(roof.bw);
+    ParallelDescriptor::ReduceRealSum(roof.flops);
+    return roof;
+}
+
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+
+    {
+        Vector<int> max_grid_sizes;
+        Vector<int> ncomps;
+        Vector<int> tile_sizes;
+        Vector<int> nthreads;
+        Vector<std::string> kernel_names;
+        std::string results_file = "roofline.csv";
+
+        ParmParse pp;
+        pp.query("n_cell", n_cell);
+        pp.queryarr("max_grid_sizes", max_grid_sizes);
+        pp.queryarr("ncomps", ncomps);
+        pp.queryarr("tile_sizes", tile_sizes);
+        pp.queryarr("nthreads", nthreads);
+        pp.queryarr("kernels", kernel_names);
+        pp.query("min_time", min_time);
+        pp.query("stream_size", stream_size);
+        pp.query("results_file", results_file);
+
+        // queryarr does not shrink the vectors, so the defaults are set here
+        if (max_grid_sizes.empty()) max_grid_sizes = {32, 64, 128};
+        if (ncomps.empty()) ncomps = {1, 4};
+        if (nthreads.empty()) nthreads = {numThreads()};
+
+        Vector<IntVect> tiles;
+        for (int i = 0; i+AMREX_SPACEDIM <= tile_sizes.size(); i += AMREX_SPACEDIM) {
+            tiles.push_back(IntVect(&tile_sizes[i]));
+        }
+        if (tiles.empty()) tiles.push_back(FabArrayBase::mfiter_tile_size);
+        const IntVect tile_size_0 = FabArrayBase::mfiter_tile_size;
+        const int nthreads_0 = numThreads();
+
+        const Box domain(IntVect::TheZeroVector(), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        Geometry fgeom(domain, &rb, 0);
+        Geometry cgeom(amrex::coarsen(domain,2), &rb, 0);
+
+        const Real npts = domain.numPts();
+        const Real twod = AMREX_D_TERM(2.0,*2.0,*2.0);  // fine cells per coarse cell
+        const Real rs = sizeof(Real);
+
+        std::ofstream ofs;
+        if (ParallelDescriptor::IOProcessor()) {
+            ofs.open(results_file.c_str());
+            ofs << "kernel,dim,n_cell,max_grid_size,ncomp,tile_size,nthreads,nprocs,"
+                << "seconds,GB/s,GFLOP/s,flops/byte,roof_GB/s,roof_GFLOP/s,roof_fraction\n";
+        }
+
+        for (int nt : nthreads)
+        {
+#ifdef _OPENMP
+            omp_set_num_threads(nt);
+#endif
+            const Roof roof = measureRoof();
+            amrex::Print() << "\nThreads: " << nt << "  STREAM triad: " << roof.bw*1.e-9
+                           << " GB/s  multiply-add peak: " << roof.flops*1.e-9 << " GFLOP/s\n";
+
+            for (int mgs : max_grid_sizes)
+            {
+                BoxArray ba(domain);
+                ba.maxSize(mgs);
+                DistributionMapping dm(ba);
+                BoxArray cba = amrex::coarsen(ba,2);
+
+                for (int ncomp : ncomps)
+                {
+                    MultiFab x(ba, dm, ncomp, 0);
+                    MultiFab y(ba, dm, ncomp, 0);
+                    MultiFab z(ba, dm, ncomp, 0);
+                    // grown for the coarse stencils of the interpolaters
+                    MultiFab crse(cba, dm, ncomp, 2);
+                    x.setVal(1.0);
+                    y.setVal(2.0);
+                    z.setVal(0.0);
+                    crse.setVal(1.0);
+
+                    Vector<BCRec> bcr(ncomp);
+                    for (auto& bc : bcr) {
+                        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                            bc.setLo(idim, BCType::int_dir);
+                            bc.setHi(idim, BCType::int_dir);
+                        }
+                    }
+
+                    auto interp = [&] (Interpolater& mapper) {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+                        for (MFIter mfi(z,true); mfi.isValid(); ++mfi) {
+                            mapper.interp(crse[mfi], 0, z[mfi], 0, ncomp, mfi.tilebox(),
+                                          IntVect(2), cgeom, fgeom, bcr, 0, 0);
+                        }
+                    };
+
+                    Real dot = 0.0;
+                    const Vector<Kernel> kernels {
+                        {"setVal",   rs,   0.0, [&] () { z.setVal(0.5); }},
+                        {"BaseFab::copy", 2*rs, 0.0, [&] () {
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+                            for (MFIter mfi(z,true); mfi.isValid(); ++mfi) {
+                                const Box& bx = mfi.tilebox();
+                                z[mfi].copy(x[mfi], bx, 0, bx, 0, ncomp);
+                            }
+                        }},
+                        {"Saxpy",    3*rs, 2.0, [&] () { MultiFab::Saxpy(z, 1.e-3, x, 0, 0, ncomp, 0); }},
+                        {"Xpay",     3*rs, 2.0, [&] () { MultiFab::Xpay(z, 0.5, x, 0, 0, ncomp, 0); }},
+                        {"LinComb",  3*rs, 3.0, [&] () { MultiFab::LinComb(z, 0.5, x, 0, 0.5, y, 0, 0, ncomp, 0); }},
+                        // a chain of LinComb and AddProduct fused into one pass
+                        {"MFExpr::assign", 3*rs, 5.0, [&] () {
+                            using namespace MFExpr;
+                            assign(z, 0.5*ref(x) + 0.5*ref(y) - 1.e-3*ref(x)*ref(y));
+                        }},
+                        {"Dot",      2*rs, 2.0, [&] () { dot += MultiFab::Dot(x, 0, y, 0, ncomp, 0, true); }},
+                        // fine cells are read once and coarse cells written once
+                        {"average_down", rs+rs/twod, 1.0, [&] () { amrex::average_down(x, crse, 0, ncomp, 2); }},
+                        // fine cells are written once and coarse cells read once
+                        {"pc_interp",    rs+rs/twod, 0.0, [&] () { interp(pc_interp); }},
+                        // limited slopes on the coarse cells, applied on the fine cells
+                        {"cell_cons_interp", rs+rs/twod, 2.0*AMREX_SPACEDIM + 6.0*AMREX_SPACEDIM/twod,
+                                                   [&] () { interp(cell_cons_interp); }},
+                        // one direction at a time, 6 flops per value of each pass
+                        {"quartic_interp", rs+rs/twod, 6.0*(2.0*twod-2.0)/twod,
+                                                   [&] () { interp(quartic_interp); }}
+                    };
+
+                    for (const auto& name : kernel_names)
+                    {
+                        if (std::find_if(kernels.begin(), kernels.end(),
+                                         [&] (const Kernel& k) { return k.name == name; })
+                            == kernels.end()) {
+                            std::string msg = "RooflineBenchmark: unknown kernel " + name + ", the kernels are";
+                            for (const Kernel& k : kernels) msg += " " + k.name;
+                            amrex::Abort(msg);
+                        }
+                    }
+
+                    for (const IntVect& tile : tiles)
+                    {
+                        FabArrayBase::mfiter_tile_size = tile;
+
+                        for (const Kernel& k : kernels)
+                        {
+                            if (!kernel_names.empty() &&
+                                std::find(kernel_names.begin(), kernel_names.end(), k.name)
+                                == kernel_names.end()) {
+                                continue;
+                            }
+
+                            const Real t = timeIt(k.run);
+                            const Real bytes = k.bytes*ncomp*npts;
+                            const Real flops = k.flops*ncomp*npts;
+                            const Real troof = std::max(bytes/roof.bw, flops/roof.flops);
+
+                            amrex::Print() << std::left << std::setw(18) << k.name << std::right
+                                           << " mgs " << std::setw(4) << mgs
+                                           << " ncomp " << std::setw(2) << ncomp
+                                           << " tile " << tile
+                                           << ": " << std::setw(10) << bytes/t*1.e-9 << " GB/s "
+                                           << std::setw(10) << flops/t*1.e-9 << " GFLOP/s "
+                                           << std::setw(8) << 100.*troof/t << " % of roof\n";
+
+                            if (ParallelDescriptor::IOProcessor()) {
+                                ofs << k.name << "," << AMREX_SPACEDIM << "," << n_cell << ","
+                                    << mgs << "," << ncomp << ",";
+                                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                                    ofs << (idim ? "x" : "") << tile[idim];
+                                }
+                                ofs << "," << nt << "," << ParallelDescriptor::NProcs() << ","
+                                    << t << "," << bytes/t*1.e-9 << "," << flops/t*1.e-9 << ","
+                                    << k.flops/k.bytes << "," << roof.bw*1.e-9 << ","
+                                    << roof.flops*1.e-9 << "," << troof/t << "\n";
+                            }
+                        }
+                    }
+
+                    if (dot < 0.0) amrex::Print() << dot;
+                }
+            }
+        }
+
+        FabArrayBase::mfiter_tile_size = tile_size_0;
+#ifdef _OPENMP
+        omp_set_num_threads(nthreads_0);
+#endif
+
+        amrex::Print() << "\nResults written to " << results_file << "\n";
+    }
+
+    amrex::Finalize();
+}
@@ -0,0 +1,221 @@
+//
+// Tests the interpolation in time from the history of StateData, see
+// DescriptorList::setHistory.  For nhist = 0, 1 and 2 extra time levels,
+// the StateData holds a polynomial in time of degree nhist+1, advanced
+// with swapTimeLevels.  getData between the old and the new time returns
+// nhist+2 levels, and FillPatchSingleLevel interpolates them with the
+// Lagrange polynomial, which is exact for that degree.  The filled values
+// are compared with the polynomial, up to rounding, on the BoxArray of the
+// StateData and on a different one with ghost cells.
+//
+// It also checks that the time levels rotate through nhist+2 MultiFabs,
+// and that reset() undoes swapTimeLevels.
+//
+//     main.ex n_cell=32 max_grid_size=16 nsteps=6
+//
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_StateData.H>
+#include <AMReX_StateDescriptor.H>
+
+using namespace amrex;
+
+namespace {
+
+class NoOpPhysBC
+    : public PhysBCFunctBase
+{
+public:
+    virtual void FillBoundary (MultiFab&, int, int, Real) override {}
+    using PhysBCFunctBase::FillBoundary;
+};
+
+//! A polynomial of degree deg in t with coefficients that vary in space.
+Real
+exact (IntVect iv, const Box& domain, int n, int deg, Real t)
+{
+    // the periodic image in the domain
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const int len = domain.length(idim);
+        iv[idim] = ((iv[idim] - domain.smallEnd(idim)) % len + len) % len + domain.smallEnd(idim);
+    }
+    Real v = 0.0, tk = 1.0;
+    for (int k = 0; k <= deg; ++k) {
+        v += std::sin(0.1*(AMREX_D_TERM(iv[0], + 2*iv[1], + 3*iv[2])) + n + k) * tk;
+        tk *= t;
+    }
+    return v;
+}
+
+void
+fillExact (MultiFab& mf, const Box& domain, int deg, Real t)
+{
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        const Box& bx = fab.box();
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                fab(iv,n) = exact(iv, domain, n, deg, t);
+            }
+        }
+    }
+}
+
+Real
+maxError (const MultiFab& mf, const Box& domain, int deg, Real t)
+{
+    Real err = 0.0;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        const FArrayBox& fab = mf[mfi];
+        const Box& bx = fab.box();
+        for (int n = 0; n < mf.nComp(); ++n) {
+            for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                err = std::max(err, std::abs(fab(iv,n) - exact(iv, domain, n, deg, t)));
+            }
+        }
+    }
+    ParallelDescriptor::ReduceRealMax(err);
+    return err;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    int nfails = 0;
+    {
+        int n_cell = 32;
+        int max_grid_size = 16;
+        int nsteps = 6;
+        {
+            ParmParse pp;
+            pp.query("n_cell", n_cell);
+            pp.query("max_grid_size", max_grid_size);
+            pp.query("nsteps", nsteps);
+        }
+
+        const int ncomp = 2;
+        const Real dt = 0.1;
+        const Real tol = 1.e-12;
+
+        const Box domain(IntVect(0), IntVect(n_cell-1));
+        RealBox rb({AMREX_D_DECL(0.,0.,0.)}, {AMREX_D_DECL(1.,1.,1.)});
+        int is_per[] = {AMREX_D_DECL(1,1,1)};
+        Geometry geom(domain, &rb, 0, is_per);
+        NoOpPhysBC physbc;
+
+        BoxArray ba(domain);
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+
+        BoxArray ba2(domain);
+        ba2.maxSize(max_grid_size/2 + max_grid_size/4);
+        DistributionMapping dm2(ba2);
+
+        BCRec bc;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            bc.setLo(idim, BCType::int_dir);
+            bc.setHi(idim, BCType::int_dir);
+        }
+
+        for (int nhist = 0; nhist <= 2; ++nhist)
+        {
+            const int deg = nhist+1;
+
+            DescriptorList desc_lst;
+            desc_lst.addDescriptor(0, IndexType::TheCellType(), StateDescriptor::Point,
+                                   1, ncomp, &cell_cons_interp);
+            if (nhist > 0) desc_lst.setHistory(0, nhist);
+            for (int n = 0; n < ncomp; ++n) {
+                desc_lst.setComponent(0, n, "phi" + std::to_string(n), bc,
+                                      StateDescriptor::BndryFunc());
+            }
+
+            StateData sd;
+            sd.define(domain, ba, dm, desc_lst[0], 0.0, dt, FArrayBoxFactory());
+            sd.allocOldData();
+            fillExact(sd.newData(), domain, deg, 0.0);
+
+            std::set<const MultiFab*> allocated {&sd.oldData(), &sd.newData()};
+
+            for (int step = 1; step <= nsteps; ++step)
+            {
+                const Real t = step*dt;
+                sd.swapTimeLevels(dt);
+                fillExact(sd.newData(), domain, deg, t);
+                allocated.insert(&sd.newData());
+
+                // between the old and the new time
+                const Real time = t - 0.4*dt;
+                Vector<MultiFab*> data;
+                Vector<Real> datatime;
+                sd.getData(data, datatime, time);
+
+                const int nexpected = std::min(step-1, nhist) + 2;
+                if (data.size() != nexpected) {
+                    amrex::Print() << "nhist " << nhist << " step " << step << ": getData returned "
+                                   << data.size() << " levels instead of " << nexpected << "\n";
+                    ++nfails;
+                }
+
+                MultiFab mf(ba, dm, ncomp, 0);
+                MultiFab mf2(ba2, dm2, ncomp, 2);
+                FillPatchSingleLevel(mf,  time, data, datatime, 0, 0, ncomp, geom, physbc);
+                FillPatchSingleLevel(mf2, time, data, datatime, 0, 0, ncomp, geom, physbc);
+
+                // exact once all the levels the degree needs are there
+                if (data.size() == deg+1)
+                {
+                    const Real err  = maxError(mf,  domain, deg, time);
+                    const Real err2 = maxError(mf2, domain, deg, time);
+                    amrex::Print() << "nhist " << nhist << " step " << step << ": "
+                                   << data.size() << " levels, max error " << std::setprecision(3)
+                                   << err << " same BoxArray, " << err2 << " different BoxArray\n";
+                    if (err > tol || err2 > tol) ++nfails;
+                }
+            }
+
+            if (allocated.size() != nhist+2) {
+                amrex::Print() << "nhist " << nhist << ": " << allocated.size()
+                               << " MultiFabs allocated instead of " << nhist+2 << "\n";
+                ++nfails;
+            }
+
+            // reset() undoes the last swapTimeLevels, except that the
+            // oldest level of a full history has been reused
+            const MultiFab* new_ptr = &sd.newData();
+            const MultiFab* old_ptr = &sd.oldData();
+            const Real new_time = sd.curTime();
+            const int nh = (nsteps-1 < nhist) ? nsteps-1 : std::max(nhist-1, 0);
+            sd.swapTimeLevels(dt);
+            sd.reset();
+            if (&sd.newData() != new_ptr || &sd.oldData() != old_ptr ||
+                sd.curTime() != new_time || sd.nHistory() != nh)
+            {
+                amrex::Print() << "nhist " << nhist << ": reset() did not undo swapTimeLevels\n";
+                ++nfails;
+            }
+        }
+    }
+
+    if (nfails > 0) {
+        amrex::Abort("StateDataHistory failed");
+    }
+    amrex::Print() << "StateDataHistory passed\n";
+
+    amrex::Finalize();
+}
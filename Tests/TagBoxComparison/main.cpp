@@ -0,0 +1,265 @@
+//
+// Compares TagBox::buffer, numTags, collate and coarsen, which go through
+// TagBitMask or count eight tags at a time, with the cell by cell code
+// they replaced, on random tag patterns.  The TagBitMask operations
+// (count, dilate, coarsen and TagBox::setTags) are also checked against
+// brute force.  The boxes have random corners, negative ones included,
+// and rows that are not multiples of 64 cells.  All the results must be
+// identical.
+//
+//     main.ex nboxes=40
+//
+
+#include <iostream>
+#include <vector>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_TagBox.H>
+#include <AMReX_Utility.H>
+
+using namespace amrex;
+
+namespace {
+
+int
+randomInt (int lo, int hi)
+{
+    return lo + static_cast<int>(amrex::Random()*(hi-lo+1));
+}
+
+Box
+randomBox (int nbuff)
+{
+    IntVect lo, len;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        lo[idim] = randomInt(-40, 40);
+        len[idim] = randomInt(2*nbuff+1, (idim == 0) ? 150 : 24);
+    }
+    return Box(lo, lo+len-1);
+}
+
+//! SET cells with density d in the interior, BUF cells with density d/2 anywhere.
+void
+randomTags (TagBox& tb, int nwid, Real d)
+{
+    const Box& bx = tb.box();
+    const Box inside = amrex::grow(bx, -nwid);
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv))
+    {
+        const Real r = amrex::Random();
+        if (r < d && inside.contains(iv)) {
+            tb(iv) = TagBox::SET;
+        } else if (r > 1.0 - 0.5*d) {
+            tb(iv) = TagBox::BUF;
+        } else {
+            tb(iv) = TagBox::CLEAR;
+        }
+    }
+}
+
+//
+// The cell by cell code of TagBox::buffer before TagBitMask.
+//
+void
+refBuffer (TagBox& tb, int nbuff, int nwid)
+{
+    const Box& bx = tb.box();
+    const Box inside = amrex::grow(bx, -nwid);
+    std::vector<IntVect> set;
+    for (IntVect iv = inside.smallEnd(); iv <= inside.bigEnd(); inside.next(iv)) {
+        if (tb(iv) == TagBox::SET) set.push_back(iv);
+    }
+    const Box nbhd(IntVect(-nbuff), IntVect(nbuff));
+    for (const IntVect& iv : set) {
+        for (IntVect off = nbhd.smallEnd(); off <= nbhd.bigEnd(); nbhd.next(off)) {
+            if (tb(iv+off) != TagBox::SET) tb(iv+off) = TagBox::BUF;
+        }
+    }
+}
+
+long
+refNumTags (const TagBox& tb, const Box& b)
+{
+    long n = 0;
+    const Box bx = b & tb.box();
+    if (!bx.ok()) return 0;
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+        if (tb(iv) != TagBox::CLEAR) ++n;
+    }
+    return n;
+}
+
+//! The fine box coarsened, each coarse cell the max of its fine cells.
+void
+refCoarsen (const TagBox& fine, TagBox& crse, const IntVect& ratio)
+{
+    crse.setVal(TagBox::CLEAR);
+    const Box& bx = fine.box();
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+        const IntVect civ = amrex::coarsen(iv, ratio);
+        crse(civ) = std::max(crse(civ), fine(iv));
+    }
+}
+
+bool
+same (const TagBox& a, const TagBox& b)
+{
+    if (a.box() != b.box()) return false;
+    const Box& bx = a.box();
+    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+        if (a(iv) != b(iv)) return false;
+    }
+    return true;
+}
+
+}
+
+int
+main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+    long nfails = 0;
+    long nchecks = 0;
+    {
+        int nboxes = 40;
+        {
+            ParmParse pp;
+            pp.query("nboxes", nboxes);
+        }
+
+        amrex::InitRandom(1357);
+
+        auto check = [&] (bool ok, const char* what, const Box& bx, Real d, int nbuff) {
+            ++nchecks;
+            if (!ok) {
+                ++nfails;
+                amrex::Print() << what << " differs on " << bx << " density " << d
+                               << " nbuff " << nbuff << "\n";
+            }
+        };
+
+        for (int ib = 0; ib < nboxes; ++ib)
+        {
+            for (Real d : {0.002, 0.02, 0.3})
+            {
+                const int nbuff = randomInt(1, 4);
+                const int nwid = nbuff;
+                const Box bx = randomBox(nbuff);
+
+                TagBox tb(bx);
+                randomTags(tb, nwid, d);
+
+                // numTags
+                check(tb.numTags() == refNumTags(tb, bx), "numTags()", bx, d, nbuff);
+                const Box sub(bx.smallEnd() + IntVect(1), bx.bigEnd() + IntVect(3));
+                check(tb.numTags(sub) == refNumTags(tb, sub), "numTags(box)", bx, d, nbuff);
+
+                // collate
+                {
+                    Vector<IntVect> ar(tb.numTags()+2), ref;
+                    const long n = tb.collate(ar, 2);
+                    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                        if (tb(iv) != TagBox::CLEAR) ref.push_back(iv);
+                    }
+                    bool ok = (n == static_cast<long>(ref.size()));
+                    for (long i = 0; ok && i < n; ++i) {
+                        ok = (ar[i+2] == ref[i]);
+                    }
+                    check(ok, "collate", bx, d, nbuff);
+                }
+
+                // TagBitMask count, dilate and setTags
+                {
+                    TagBitMask mask(tb, bx, TagBox::SET);
+                    long nset = 0;
+                    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                        if (tb(iv) == TagBox::SET) ++nset;
+                    }
+                    check(mask.count() == nset, "TagBitMask::count", bx, d, nbuff);
+
+                    TagBitMask dilated(mask);
+                    dilated.dilate(nbuff);
+                    TagBox expect(bx);
+                    expect.copy(tb);
+                    bool ok = true;
+                    const Box nbhd(IntVect(-nbuff), IntVect(nbuff));
+                    for (IntVect iv = bx.smallEnd(); iv <= bx.bigEnd(); bx.next(iv)) {
+                        bool near = false;
+                        for (IntVect off = nbhd.smallEnd(); !near && off <= nbhd.bigEnd(); nbhd.next(off)) {
+                            near = bx.contains(iv+off) && tb(iv+off) == TagBox::SET;
+                        }
+                        if (near) expect(iv) = TagBox::SET;
+                        ok = ok && (dilated.test(iv) == near);
+                    }
+                    check(ok, "TagBitMask::dilate", bx, d, nbuff);
+
+                    ok = true;
+                    long n = 0;
+                    dilated.forEach([&] (const IntVect& iv, long off) {
+                        ok = ok && (off == bx.index(iv)) && expect(iv) == TagBox::SET;
+                        ++n;
+                    });
+                    check(ok && n == dilated.count(), "TagBitMask::forEach", bx, d, nbuff);
+
+                    // on the box of the mask and on a box that is partly outside it
+                    TagBox a(bx);
+                    a.copy(tb);
+                    a.setTags(dilated);
+                    check(same(a, expect), "TagBox::setTags(mask)", bx, d, nbuff);
+
+                    const Box shifted(bx.smallEnd() + IntVect(2), bx.bigEnd() + IntVect(2));
+                    TagBox b(shifted), bref(shifted);
+                    b.setVal(TagBox::CLEAR);
+                    bref.setVal(TagBox::CLEAR);
+                    b.setTags(dilated);
+                    const Box both = bx & shifted;
+                    for (IntVect iv = both.smallEnd(); iv <= both.bigEnd(); both.next(iv)) {
+                        if (dilated.test(iv)) bref(iv) = TagBox::SET;
+                    }
+                    check(same(b, bref), "TagBox::setTags(mask) on another box", bx, d, nbuff);
+                }
+
+                // buffer
+                {
+                    TagBox a(bx), b(bx);
+                    a.copy(tb);
+                    b.copy(tb);
+                    a.buffer(nbuff, nwid);
+                    refBuffer(b, nbuff, nwid);
+                    check(same(a, b), "buffer", bx, d, nbuff);
+                }
+
+                // coarsen, of the TagBox and of the mask
+                for (int r : {2, 4})
+                {
+                    const IntVect ratio(r);
+                    const Box cbx = amrex::coarsen(bx, ratio);
+                    TagBox ref(cbx);
+                    refCoarsen(tb, ref, ratio);
+
+                    TagBox a(bx);
+                    a.copy(tb);
+                    a.coarsen(ratio, true);
+                    check(same(a, ref), "coarsen", bx, d, nbuff);
+
+                    TagBitMask cmask = TagBitMask(tb, bx, TagBox::BUF).coarsen(ratio);
+                    bool ok = (cmask.box() == cbx);
+                    for (IntVect iv = cbx.smallEnd(); ok && iv <= cbx.bigEnd(); cbx.next(iv)) {
+                        ok = (cmask.test(iv) == (ref(iv) != TagBox::CLEAR));
+                    }
+                    check(ok, "TagBitMask::coarsen", bx, d, nbuff);
+                }
+            }
+        }
+    }
+
+    amrex::Print() << nchecks - nfails << " of " << nchecks << " checks identical\n";
+    if (nfails > 0) {
+        amrex::Abort("TagBoxComparison failed");
+    }
+    amrex::Print() << "TagBoxComparison passed\n";
+
+    amrex::Finalize();
+}